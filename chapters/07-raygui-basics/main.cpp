@@ -1,4 +1,5 @@
 #include "raylib.h"
+#include "dynamic_font.h"
 
 #define RAYGUI_IMPLEMENTATION
 #include "raygui.h"
@@ -13,7 +14,7 @@ enum GameState {
 
 // Font and text management
 struct UIText {
-    Font chineseFont;
+    DynamicFont chineseFont;
     bool hasChineseFont;
     const char* fontPath;
 
@@ -40,46 +41,9 @@ struct UIText {
     const char* txtEnterReturn;
 };
 
-// Common Chinese characters for UI
-// Includes: ASCII + Full CJK Unified Ideographs (0x4E00-0x9FFF) + Punctuation + Fullwidth forms
-int GetChineseCodepoints(int** codepoints) {
-    // ASCII range
-    int asciiCount = 0x007E - 0x0020 + 1;  // 95 chars
-
-    // Full CJK Unified Ideographs (0x4E00-0x9FFF) - ~20,000 chars
-    // This covers all commonly used Chinese characters
-    int cjkStart = 0x4E00;
-    int cjkEnd = 0x9FFF;
-    int cjkCount = cjkEnd - cjkStart + 1;
-
-    // CJK Punctuation (0x3000-0x303F)
-    int punctStart = 0x3000;
-    int punctEnd = 0x303F;
-    int punctCount = punctEnd - punctStart + 1;
-
-    // Fullwidth ASCII variants (0xFF01-0xFF5E)
-    int fwStart = 0xFF01;
-    int fwEnd = 0xFF5E;
-    int fwCount = fwEnd - fwStart + 1;
-
-    int total = asciiCount + cjkCount + punctCount + fwCount;
-    *codepoints = (int*)malloc(total * sizeof(int));
-
-    int idx = 0;
-    // ASCII
-    for (int cp = 0x0020; cp <= 0x007E; cp++) (*codepoints)[idx++] = cp;
-    // CJK
-    for (int cp = cjkStart; cp <= cjkEnd; cp++) (*codepoints)[idx++] = cp;
-    // Punctuation
-    for (int cp = punctStart; cp <= punctEnd; cp++) (*codepoints)[idx++] = cp;
-    // Fullwidth
-    for (int cp = fwStart; cp <= fwEnd; cp++) (*codepoints)[idx++] = cp;
-
-    TraceLog(LOG_INFO, "Generated %d codepoints for Chinese font", idx);
-    return idx;
-}
-
 // Try to load font with Chinese support
+// Glyphs are rasterized on first use (see common/dynamic_font.h), so loading
+// only reads the file and bakes ASCII instead of the whole CJK range.
 bool TryLoadFont(UIText& ui, const char* path) {
     if (!FileExists(path)) {
         return false;
@@ -87,31 +51,36 @@ bool TryLoadFont(UIText& ui, const char* path) {
 
     TraceLog(LOG_INFO, "Loading font: %s", path);
 
-    // Generate codepoints for Chinese characters
-    int* codepoints = NULL;
-    int codepointCount = GetChineseCodepoints(&codepoints);
-
-    TraceLog(LOG_INFO, "Loading %d codepoints...", codepointCount);
-
-    ui.chineseFont = LoadFontEx(path, 48, codepoints, codepointCount);
-    free(codepoints);
+    if (!ui.chineseFont.Load(path, 48)) {
+        TraceLog(LOG_WARNING, "Failed to load font: %s", path);
+        return false;
+    }
 
-    if (ui.chineseFont.texture.id != 0) {
-        TraceLog(LOG_INFO, "Font loaded: %s (glyphs: %d)", path, ui.chineseFont.glyphCount);
+    ui.hasChineseFont = true;
+    ui.fontPath = path;
+    TraceLog(LOG_INFO, "Chinese font active: %s", path);
+    return true;
+}
 
-        if (ui.chineseFont.glyphCount > 1000) {
-            ui.hasChineseFont = true;
-            ui.fontPath = path;
-            GuiSetFont(ui.chineseFont);
-            TraceLog(LOG_INFO, "Chinese font active: %s", path);
-            return true;
-        } else {
-            TraceLog(LOG_WARNING, "Font has only %d glyphs", ui.chineseFont.glyphCount);
-            UnloadFont(ui.chineseFont);
-        }
-    }
+// Bake every fixed UI string once and keep it in the atlas
+void PinUIText(UIText& ui) {
+    const char* texts[] = {
+        ui.title, ui.btnStart, ui.btnSettings, ui.btnExit, ui.btnBack,
+        ui.lblPlayer, ui.lblPlayerName, ui.lblDifficulty, ui.lblVolume, ui.lblBrightness,
+        ui.chkFullscreen, ui.chkShowFps, ui.settingsTitle, ui.diffEasy,
+        ui.txtMove, ui.txtScore, ui.txtEscMenu, ui.txtGameOver, ui.txtFinalScore, ui.txtEnterReturn
+    };
+    for (const char* text : texts) ui.chineseFont.Require(text, true);
+    GuiSetFont(ui.chineseFont.GetFont());
+    ui.chineseFont.Changed();
+}
 
-    return false;
+// Rasterize glyphs of user-entered text, re-bind raygui if the atlas changed.
+// Call it before drawing the text and again after any control that edits it.
+void RefreshChineseFont(UIText& ui, const char* dynamicText) {
+    if (!ui.hasChineseFont) return;
+    ui.chineseFont.Require(dynamicText);
+    if (ui.chineseFont.Changed()) GuiSetFont(ui.chineseFont.GetFont());
 }
 
 void LoadChineseFont(UIText& ui) {
@@ -147,6 +116,7 @@ set_chinese:
     ui.txtGameOver = "游戏结束!";
     ui.txtFinalScore = "最终分数: %d";
     ui.txtEnterReturn = "按 ENTER 返回菜单";
+    PinUIText(ui);
     return;
 
 set_english:
@@ -174,7 +144,7 @@ set_english:
 
 void UnloadChineseFont(UIText& ui) {
     if (ui.hasChineseFont) {
-        UnloadFont(ui.chineseFont);
+        ui.chineseFont.Unload();
         ui.hasChineseFont = false;
     }
 }
@@ -230,6 +200,8 @@ int main() {
                 break;
         }
 
+        RefreshChineseFont(uiText, playerName);
+
         BeginDrawing();
         ClearBackground(RAYWHITE);
 
@@ -239,7 +211,7 @@ int main() {
                 int startY = 150;
 
                 if (uiText.hasChineseFont) {
-                    DrawTextEx(uiText.chineseFont, uiText.title, (Vector2){(float)(centerX + 30), 50.0f}, 30, 2, DARKGRAY);
+                    DrawTextEx(uiText.chineseFont.GetFont(), uiText.title, (Vector2){(float)(centerX + 30), 50.0f}, 30, 2, DARKGRAY);
                 } else {
                     DrawText(uiText.title, centerX + 30, 50, 30, DARKGRAY);
                 }
@@ -279,6 +251,8 @@ int main() {
                                playerName, 64, nameEditMode)) {
                     nameEditMode = !nameEditMode;
                 }
+                // GuiTextBox appends the typed characters itself: rasterize them right after
+                RefreshChineseFont(uiText, playerName);
                 controlY += 50;
 
                 GuiLabel((Rectangle){(float)controlX, (float)controlY, (float)labelWidth, 24}, uiText.lblDifficulty);
@@ -313,9 +287,9 @@ int main() {
 
             case PLAYING: {
                 if (uiText.hasChineseFont) {
-                    DrawTextEx(uiText.chineseFont, uiText.txtMove, (Vector2){10.0f, 10.0f}, 20, 2, DARKGRAY);
-                    DrawTextEx(uiText.chineseFont, TextFormat(uiText.txtScore, score), (Vector2){10.0f, 40.0f}, 20, 2, BLUE);
-                    DrawTextEx(uiText.chineseFont, uiText.txtEscMenu, (Vector2){10.0f, 70.0f}, 20, 2, GRAY);
+                    DrawTextEx(uiText.chineseFont.GetFont(), uiText.txtMove, (Vector2){10.0f, 10.0f}, 20, 2, DARKGRAY);
+                    DrawTextEx(uiText.chineseFont.GetFont(), TextFormat(uiText.txtScore, score), (Vector2){10.0f, 40.0f}, 20, 2, BLUE);
+                    DrawTextEx(uiText.chineseFont.GetFont(), uiText.txtEscMenu, (Vector2){10.0f, 70.0f}, 20, 2, GRAY);
                 } else {
                     DrawText(uiText.txtMove, 10, 10, 20, DARKGRAY);
                     DrawText(TextFormat(uiText.txtScore, score), 10, 40, 20, BLUE);
@@ -329,9 +303,9 @@ int main() {
 
             case GAME_OVER: {
                 if (uiText.hasChineseFont) {
-                    DrawTextEx(uiText.chineseFont, uiText.txtGameOver, (Vector2){(float)(screenWidth/2 - 100), (float)(screenHeight/2 - 50)}, 40, 2, RED);
-                    DrawTextEx(uiText.chineseFont, TextFormat(uiText.txtFinalScore, score), (Vector2){(float)(screenWidth/2 - 80), (float)(screenHeight/2 + 20)}, 25, 2, DARKGRAY);
-                    DrawTextEx(uiText.chineseFont, uiText.txtEnterReturn, (Vector2){(float)(screenWidth/2 - 120), (float)(screenHeight/2 + 80)}, 20, 2, GRAY);
+                    DrawTextEx(uiText.chineseFont.GetFont(), uiText.txtGameOver, (Vector2){(float)(screenWidth/2 - 100), (float)(screenHeight/2 - 50)}, 40, 2, RED);
+                    DrawTextEx(uiText.chineseFont.GetFont(), TextFormat(uiText.txtFinalScore, score), (Vector2){(float)(screenWidth/2 - 80), (float)(screenHeight/2 + 20)}, 25, 2, DARKGRAY);
+                    DrawTextEx(uiText.chineseFont.GetFont(), uiText.txtEnterReturn, (Vector2){(float)(screenWidth/2 - 120), (float)(screenHeight/2 + 80)}, 20, 2, GRAY);
                 } else {
                     DrawText(uiText.txtGameOver, screenWidth/2 - 100, screenHeight/2 - 50, 40, RED);
                     DrawText(TextFormat(uiText.txtFinalScore, score), screenWidth/2 - 80, screenHeight/2 + 20, 25, DARKGRAY);
@@ -1,5 +1,5 @@
 #include "raylib.h"
-#include <stdlib.h>  // For malloc/free
+#include "dynamic_font.h"
 
 #define RAYGUI_IMPLEMENTATION
 #include "raygui.h"
@@ -22,7 +22,7 @@ struct Item {
 
 // UI Text management
 struct UIText {
-    Font chineseFont;
+    DynamicFont chineseFont;
     bool hasChineseFont;
     const char* fontPath;
 
@@ -85,35 +85,9 @@ struct UIText {
     const char* diffHard;
 };
 
-// Common Chinese characters for UI
-// Includes: ASCII + Full CJK (0x4E00-0x9FFF) + Punctuation
-int GetChineseCodepoints(int** codepoints) {
-    // ASCII range
-    int asciiCount = 0x007E - 0x0020 + 1;  // 95 chars
-
-    // Full CJK Unified Ideographs (0x4E00-0x9FFF) - ~20k chars
-    int cjkStart = 0x4E00;
-    int cjkEnd = 0x9FFF;  // Full CJK range
-    int cjkCount = cjkEnd - cjkStart + 1;
-
-    // CJK Punctuation (0x3000-0x303F)
-    int punctStart = 0x3000;
-    int punctEnd = 0x303F;
-    int punctCount = punctEnd - punctStart + 1;
-
-    int total = asciiCount + cjkCount + punctCount;
-    *codepoints = (int*)malloc(total * sizeof(int));
-
-    int idx = 0;
-    for (int cp = 0x0020; cp <= 0x007E; cp++) (*codepoints)[idx++] = cp;
-    for (int cp = cjkStart; cp <= cjkEnd; cp++) (*codepoints)[idx++] = cp;
-    for (int cp = punctStart; cp <= punctEnd; cp++) (*codepoints)[idx++] = cp;
-
-    TraceLog(LOG_INFO, "Generated %d codepoints for Chinese font", idx);
-    return idx;
-}
-
 // Try to load font with Chinese support
+// Glyphs are rasterized on first use (see common/dynamic_font.h), so loading
+// only reads the file and bakes ASCII instead of the whole CJK range.
 bool TryLoadFont(UIText& ui, const char* path) {
     if (!FileExists(path)) {
         return false;
@@ -121,32 +95,15 @@ bool TryLoadFont(UIText& ui, const char* path) {
 
     TraceLog(LOG_INFO, "Loading font: %s", path);
 
-    // Generate codepoints for Chinese characters
-    int* codepoints = NULL;
-    int codepointCount = GetChineseCodepoints(&codepoints);
-
-    TraceLog(LOG_INFO, "Loading %d codepoints...", codepointCount);
-
-    ui.chineseFont = LoadFontEx(path, 32, codepoints, codepointCount);
-    free(codepoints);
-
-    if (ui.chineseFont.texture.id != 0) {
-        TraceLog(LOG_INFO, "Font loaded: %s (glyphs: %d)", path, ui.chineseFont.glyphCount);
-
-        if (ui.chineseFont.glyphCount > 1000) {
-            ui.hasChineseFont = true;
-            ui.fontPath = path;
-            GuiSetFont(ui.chineseFont);
-            TraceLog(LOG_INFO, "Chinese font active: %s", path);
-            return true;
-        } else {
-            TraceLog(LOG_WARNING, "Font has only %d glyphs", ui.chineseFont.glyphCount);
-            UnloadFont(ui.chineseFont);
-            ui.chineseFont = (Font){0};
-        }
+    if (!ui.chineseFont.Load(path, 32)) {
+        TraceLog(LOG_WARNING, "Failed to load font: %s", path);
+        return false;
     }
 
-    return false;
+    ui.hasChineseFont = true;
+    ui.fontPath = path;
+    TraceLog(LOG_INFO, "Chinese font active: %s", path);
+    return true;
 }
 
 // Predefined items (English default)
@@ -179,6 +136,32 @@ Item items_cn[] = {
 
 Item* items = items_en;
 
+// Bake every fixed UI string once and keep it in the atlas
+void PinUIText(UIText& ui) {
+    const char* texts[] = {
+        ui.title, ui.goldLabel, ui.tabs[0], ui.tabs[1], ui.tabs[2], ui.tabs[3],
+        ui.backpackTitle, ui.itemDetails, ui.itemList, ui.selectPrompt, ui.capacityLabel, ui.totalValue,
+        ui.typeWeapon, ui.typeArmor, ui.typePotion, ui.typeMisc, ui.valueLabel,
+        ui.btnUse, ui.btnDrop, ui.btnSell, ui.msgUseItem, ui.msgDropItem, ui.msgSold,
+        ui.equipTitle, ui.equipSlots[0], ui.equipSlots[1], ui.equipSlots[2], ui.equipSlots[3], ui.equipSlots[4], ui.equipSlots[5],
+        ui.statsTitle, ui.statAttack, ui.statDefense, ui.statHP, ui.statMP, ui.appearanceLabel,
+        ui.shopTitle, ui.btnBuy, ui.shopInfo, ui.shopHint1, ui.shopHint2, ui.shopHint3,
+        ui.lblPlayerName, ui.lblVolume, ui.lblDifficulty, ui.lblTheme, ui.chkSound, ui.btnSave, ui.btnReset, ui.msgSaved,
+        ui.diffOptions, ui.themeOptions, ui.lblTestValue, ui.diffEasy, ui.diffMedium, ui.diffHard
+    };
+    for (const char* text : texts) ui.chineseFont.Require(text, true);
+    for (const Item& item : items_cn) ui.chineseFont.Require(item.name, true);
+    ui.chineseFont.Changed();
+}
+
+// Rasterize glyphs of user-entered text, re-bind raygui if the atlas changed.
+// Call it before drawing the text and again after any control that edits it.
+void RefreshChineseFont(UIText& ui, const char* dynamicText) {
+    if (!ui.hasChineseFont) return;
+    ui.chineseFont.Require(dynamicText);
+    if (ui.chineseFont.Changed()) GuiSetFont(ui.chineseFont.GetFont());
+}
+
 void LoadChineseFont(UIText& ui) {
     ui.hasChineseFont = false;
     ui.fontPath = NULL;
@@ -218,6 +201,7 @@ set_chinese:
     ui.chkSound = "启用音效"; ui.btnSave = "保存设置"; ui.btnReset = "重置默认"; ui.msgSaved = "设置已保存！";
     ui.diffOptions = "简单;中等;困难"; ui.themeOptions = "默认;暗色;蓝色"; ui.lblTestValue = "测试数值:";
     ui.diffEasy = "简单"; ui.diffMedium = "中等"; ui.diffHard = "困难";
+    PinUIText(ui);
     return;
 
 set_english:
@@ -248,7 +232,7 @@ set_english:
 
 void UnloadChineseFont(UIText& ui) {
     if (ui.hasChineseFont) {
-        UnloadFont(ui.chineseFont);
+        ui.chineseFont.Unload();
         ui.hasChineseFont = false;
     }
 }
@@ -263,20 +247,20 @@ void ApplyTheme(int theme, UIText& ui) {
             GuiSetStyle(DEFAULT, TEXT_COLOR_NORMAL, ColorToInt(DARKGRAY));
             GuiSetStyle(BUTTON, BASE_COLOR_NORMAL, ColorToInt(LIGHTGRAY));
             GuiSetStyle(BUTTON, TEXT_COLOR_NORMAL, ColorToInt(DARKGRAY));
-            if (ui.hasChineseFont) GuiSetFont(ui.chineseFont);
+            if (ui.hasChineseFont) GuiSetFont(ui.chineseFont.GetFont());
             break;
         case 1:
             GuiSetStyle(DEFAULT, BACKGROUND_COLOR, ColorToInt((Color){30, 30, 30, 255}));
             GuiSetStyle(DEFAULT, TEXT_COLOR_NORMAL, ColorToInt(WHITE));
             GuiSetStyle(BUTTON, BASE_COLOR_NORMAL, ColorToInt((Color){60, 60, 60, 255}));
             GuiSetStyle(BUTTON, TEXT_COLOR_NORMAL, ColorToInt(WHITE));
-            if (ui.hasChineseFont) GuiSetFont(ui.chineseFont);
+            if (ui.hasChineseFont) GuiSetFont(ui.chineseFont.GetFont());
             break;
         case 2:
             GuiSetStyle(DEFAULT, BACKGROUND_COLOR, ColorToInt((Color){240, 248, 255, 255}));
             GuiSetStyle(BUTTON, BASE_COLOR_NORMAL, ColorToInt(SKYBLUE));
             GuiSetStyle(BUTTON, TEXT_COLOR_NORMAL, ColorToInt(DARKBLUE));
-            if (ui.hasChineseFont) GuiSetFont(ui.chineseFont);
+            if (ui.hasChineseFont) GuiSetFont(ui.chineseFont.GetFont());
             break;
     }
 }
@@ -287,8 +271,8 @@ bool GuiIconButton(Rectangle bounds, int iconId, const char* text, UIText& ui) {
 
 // Helper function to draw text with Chinese font support
 void DrawChineseText(const char* text, int x, int y, int fontSize, Color color, UIText& ui) {
-    if (ui.hasChineseFont && ui.chineseFont.texture.id != 0) {
-        DrawTextEx(ui.chineseFont, text, (Vector2){(float)x, (float)y}, (float)fontSize * 2.0f, 2.0f, color);
+    if (ui.hasChineseFont && ui.chineseFont.IsReady()) {
+        DrawTextEx(ui.chineseFont.GetFont(), text, (Vector2){(float)x, (float)y}, (float)fontSize * 2.0f, 2.0f, color);
     } else {
         DrawText(text, x, y, fontSize, color);
     }
@@ -316,6 +300,8 @@ int main() {
     ApplyTheme(0, uiText);
 
     while (!WindowShouldClose()) {
+        RefreshChineseFont(uiText, playerName);
+
         BeginDrawing();
         Color bgColor = (theme == 1) ? (Color){30, 30, 30, 255} : (theme == 2) ? (Color){240, 248, 255, 255} : RAYWHITE;
         ClearBackground(bgColor);
@@ -324,8 +310,8 @@ int main() {
 
         // Use DrawTextEx with Chinese font, or fallback to DrawText
         if (uiText.hasChineseFont) {
-            DrawTextEx(uiText.chineseFont, uiText.title, (Vector2){20.0f, 10.0f}, 56.0f, 2.0f, (theme == 1) ? WHITE : DARKGRAY);
-            DrawTextEx(uiText.chineseFont, TextFormat(uiText.goldLabel, gold), (Vector2){(float)(screenWidth - 280), 15.0f}, 36.0f, 2.0f, GOLD);
+            DrawTextEx(uiText.chineseFont.GetFont(), uiText.title, (Vector2){20.0f, 10.0f}, 56.0f, 2.0f, (theme == 1) ? WHITE : DARKGRAY);
+            DrawTextEx(uiText.chineseFont.GetFont(), TextFormat(uiText.goldLabel, gold), (Vector2){(float)(screenWidth - 280), 15.0f}, 36.0f, 2.0f, GOLD);
         } else {
             DrawText(uiText.title, 20, 10, 30, (theme == 1) ? WHITE : DARKGRAY);
             DrawText(TextFormat(uiText.goldLabel, gold), screenWidth - 200, 15, 20, GOLD);
@@ -347,7 +333,7 @@ int main() {
         }
         GuiSetStyle(BUTTON, BASE_COLOR_NORMAL, ColorToInt((theme == 1) ? (Color){60,60,60,255} : LIGHTGRAY));
         GuiSetStyle(BUTTON, TEXT_COLOR_NORMAL, ColorToInt((theme == 1) ? WHITE : DARKGRAY));
-        if (uiText.hasChineseFont) GuiSetFont(uiText.chineseFont);
+        if (uiText.hasChineseFont) GuiSetFont(uiText.chineseFont.GetFont());
 
         // Content
         switch (activeTab) {
@@ -377,7 +363,7 @@ int main() {
                     }
                 } else {
                     if (uiText.hasChineseFont) {
-                        DrawTextEx(uiText.chineseFont, uiText.selectPrompt, (Vector2){560.0f, 150.0f}, 20.0f, 2.0f, GRAY);
+                        DrawTextEx(uiText.chineseFont.GetFont(), uiText.selectPrompt, (Vector2){560.0f, 150.0f}, 20.0f, 2.0f, GRAY);
                     } else {
                         DrawText(uiText.selectPrompt, 560, 150, 20, GRAY);
                     }
@@ -425,7 +411,7 @@ int main() {
                         if (canAfford) { gold -= item.value; messageTitle = uiText.btnBuy; messageText = TextFormat("Bought %s", item.name); showMessage = true; }
                     }
                     if (!canAfford) GuiSetStyle(BUTTON, TEXT_COLOR_NORMAL, ColorToInt(WHITE));
-                    if (uiText.hasChineseFont) GuiSetFont(uiText.chineseFont);
+                    if (uiText.hasChineseFont) GuiSetFont(uiText.chineseFont.GetFont());
                     shopY += 90;
                 }
                 GuiPanel((Rectangle){640, 120, 340, 200}, uiText.shopInfo);
@@ -439,6 +425,8 @@ int main() {
                 int sx = 50, sy = 150, lw = 150;
                 GuiLabel((Rectangle){(float)sx, (float)sy, (float)lw, 24}, uiText.lblPlayerName);
                 if (GuiTextBox((Rectangle){(float)(sx + lw), (float)sy, 200, 24}, playerName, 64, nameEditMode)) nameEditMode = !nameEditMode;
+                // GuiTextBox appends the typed characters itself: rasterize them right after
+                RefreshChineseFont(uiText, playerName);
                 sy += 50;
                 GuiLabel((Rectangle){(float)sx, (float)sy, (float)lw, 24}, uiText.lblVolume);
                 GuiSlider((Rectangle){(float)(sx + lw), (float)(sy + 5), 200, 15}, NULL, TextFormat("%d%%", (int)(volume * 100)), &volume, 0.0f, 1.0f);
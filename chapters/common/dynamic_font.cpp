@@ -0,0 +1,259 @@
+#include "dynamic_font.h"
+#include <algorithm>
+
+DynamicFont::DynamicFont()
+    : font(), fileData(nullptr), fileSize(0), atlasHeight(0), shelfHeight(0),
+      shelfCapacity(0), dirtyTop(0), dirtyBottom(0), stamp(0), evictionCount(0), changed(false) {
+}
+
+DynamicFont::~DynamicFont() {
+    Unload();
+}
+
+bool DynamicFont::Load(const char* path, int baseSize) {
+    Unload();
+
+    fileData = LoadFileData(path, &fileSize);
+    if (fileData == nullptr) return false;
+
+    glyphs.assign(MAX_GLYPHS, GlyphInfo{});
+    recs.assign(MAX_GLYPHS, Rectangle{});
+    glyphShelf.assign(MAX_GLYPHS, -1);
+    glyphPinned.assign(MAX_GLYPHS, false);
+    glyphIndex.clear();
+
+    // Every glyph bitmap fits in baseSize rows; the rest is padding around it
+    shelfHeight = baseSize + 2 * GLYPH_PADDING + 2;
+    shelfCapacity = INITIAL_SHELVES;
+    atlasHeight = shelfHeight * shelfCapacity;
+    shelves.clear();
+
+    pixels.assign(ATLAS_WIDTH * atlasHeight * 2, 0);
+    ClearRows(0, atlasHeight);
+
+    Image atlas = { pixels.data(), ATLAS_WIDTH, atlasHeight, 1, PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA };
+    font.texture = LoadTextureFromImage(atlas);
+    font.baseSize = baseSize;
+    font.glyphCount = 0;
+    font.glyphPadding = GLYPH_PADDING;
+    font.glyphs = glyphs.data();
+    font.recs = recs.data();
+    dirtyTop = atlasHeight;
+    dirtyBottom = 0;
+
+    if (font.texture.id == 0) {
+        Unload();
+        return false;
+    }
+
+    // ASCII first: GetGlyphIndex() falls back to '?' for anything missing
+    char ascii[0x7F - 0x20 + 1];
+    for (int c = 0x20; c < 0x7F; c++) ascii[c - 0x20] = (char)c;
+    ascii[0x7F - 0x20] = '\0';
+    Require(ascii, true);
+
+    TraceLog(LOG_INFO, "DynamicFont: %s ready (%d glyphs, atlas %dx%d)", path, font.glyphCount, ATLAS_WIDTH, atlasHeight);
+    return true;
+}
+
+void DynamicFont::Unload() {
+    if (font.texture.id != 0) UnloadTexture(font.texture);
+    if (fileData != nullptr) UnloadFileData(fileData);
+    font = Font{};
+    fileData = nullptr;
+    fileSize = 0;
+    glyphIndex.clear();
+    shelves.clear();
+    pixels.clear();
+    changed = true;
+}
+
+void DynamicFont::Require(const char* text, bool pin) {
+    if (!IsReady() || text == nullptr) return;
+    stamp++;
+
+    // Touch what is already cached first, so the eviction below never picks it
+    std::vector<int> missing;
+    for (int i = 0; text[i] != '\0';) {
+        int size = 0;
+        int codepoint = GetCodepointNext(&text[i], &size);
+        i += size;
+        if (codepoint == '\n') continue;
+
+        auto it = glyphIndex.find(codepoint);
+        if (it != glyphIndex.end()) {
+            Touch(it->second, pin);
+        } else if (std::find(missing.begin(), missing.end(), codepoint) == missing.end()) {
+            missing.push_back(codepoint);
+        }
+    }
+
+    if (!missing.empty()) {
+        GlyphInfo* loaded = LoadFontData(fileData, fileSize, font.baseSize, missing.data(), (int)missing.size(), FONT_DEFAULT);
+        if (loaded != nullptr) {
+            for (size_t i = 0; i < missing.size(); i++) {
+                if (!Insert(loaded[i], pin)) {
+                    TraceLog(LOG_WARNING, "DynamicFont: atlas full, U+%04X falls back to '?'", missing[i]);
+                }
+            }
+            UnloadFontData(loaded, (int)missing.size());
+        }
+    }
+
+    Flush();
+}
+
+bool DynamicFont::Changed() {
+    bool result = changed;
+    changed = false;
+    return result;
+}
+
+void DynamicFont::Touch(int slot, bool pin) {
+    Shelf& shelf = shelves[glyphShelf[slot]];
+    shelf.lastUsed = stamp;
+    if (pin && !glyphPinned[slot]) {
+        glyphPinned[slot] = true;
+        shelf.pinnedCount++;
+    }
+}
+
+bool DynamicFont::Insert(const GlyphInfo& glyph, bool pin) {
+    if (font.glyphCount >= MAX_GLYPHS) return false;
+
+    const int maxHeight = shelfHeight - 2 * GLYPH_PADDING;
+    int width = std::min(glyph.image.width, ATLAS_WIDTH - 2 * GLYPH_PADDING);
+    int height = std::min(glyph.image.height, maxHeight);
+    int cellWidth = width + 2 * GLYPH_PADDING;
+
+    int s = FindShelf(cellWidth);
+    if (s < 0) return false;
+
+    Shelf& shelf = shelves[s];
+    int x = shelf.cursorX + GLYPH_PADDING;
+    int y = shelf.y + GLYPH_PADDING;
+    shelf.cursorX += cellWidth;
+    shelf.lastUsed = stamp;
+
+    // Glyph bitmaps are 8-bit coverage; the atlas stores white with that alpha
+    if (glyph.image.data != nullptr && glyph.image.format == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) {
+        const unsigned char* src = (const unsigned char*)glyph.image.data;
+        for (int row = 0; row < height; row++) {
+            unsigned char* dst = &pixels[((y + row) * ATLAS_WIDTH + x) * 2];
+            for (int col = 0; col < width; col++) {
+                dst[col * 2 + 1] = src[row * glyph.image.width + col];
+            }
+        }
+    }
+    dirtyTop = std::min(dirtyTop, shelf.y);
+    dirtyBottom = std::max(dirtyBottom, shelf.y + shelfHeight);
+
+    int slot = font.glyphCount++;
+    glyphs[slot] = glyph;
+    glyphs[slot].image = Image{};       // Pixels live in the atlas only
+    recs[slot] = Rectangle{ (float)x, (float)y, (float)width, (float)height };
+    glyphShelf[slot] = s;
+    glyphPinned[slot] = false;
+    glyphIndex[glyph.value] = slot;
+    Touch(slot, pin);
+
+    changed = true;
+    return true;
+}
+
+int DynamicFont::FindShelf(int cellWidth) {
+    for (size_t i = 0; i < shelves.size(); i++) {
+        if (shelves[i].cursorX + cellWidth <= ATLAS_WIDTH) return (int)i;
+    }
+
+    // Open a new shelf, growing the atlas if needed
+    if ((int)shelves.size() < shelfCapacity || GrowAtlas()) {
+        shelves.push_back(Shelf{ (int)shelves.size() * shelfHeight, 0, stamp, 0 });
+        return (int)shelves.size() - 1;
+    }
+
+    // Atlas at its maximum size: recycle the least recently used shelf that
+    // holds no pinned glyph and was not touched by the current Require()
+    int victim = -1;
+    for (size_t i = 0; i < shelves.size(); i++) {
+        const Shelf& shelf = shelves[i];
+        if (shelf.pinnedCount > 0 || shelf.lastUsed == stamp) continue;
+        if (victim < 0 || shelf.lastUsed < shelves[victim].lastUsed) victim = (int)i;
+    }
+    if (victim < 0) return -1;
+
+    EvictShelf(victim);
+    return victim;
+}
+
+bool DynamicFont::GrowAtlas() {
+    if (shelfCapacity >= MAX_SHELVES) return false;
+
+    int oldHeight = atlasHeight;
+    shelfCapacity = std::min(shelfCapacity * 2, MAX_SHELVES);
+    atlasHeight = shelfHeight * shelfCapacity;
+
+    // Rows are stored top to bottom, so growing only appends new rows
+    pixels.resize(ATLAS_WIDTH * atlasHeight * 2, 0);
+    ClearRows(oldHeight, atlasHeight);
+
+    UnloadTexture(font.texture);
+    Image atlas = { pixels.data(), ATLAS_WIDTH, atlasHeight, 1, PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA };
+    font.texture = LoadTextureFromImage(atlas);
+    dirtyTop = atlasHeight;         // The new texture already has everything
+    dirtyBottom = 0;
+
+    changed = true;
+    TraceLog(LOG_INFO, "DynamicFont: atlas grown to %dx%d", ATLAS_WIDTH, atlasHeight);
+    return font.texture.id != 0;
+}
+
+void DynamicFont::EvictShelf(int shelf) {
+    for (int slot = font.glyphCount - 1; slot >= 0; slot--) {
+        if (glyphShelf[slot] == shelf) RemoveSlot(slot);
+    }
+
+    Shelf& s = shelves[shelf];
+    ClearRows(s.y, s.y + shelfHeight);
+    s.cursorX = 0;
+    s.pinnedCount = 0;
+    dirtyTop = std::min(dirtyTop, s.y);
+    dirtyBottom = std::max(dirtyBottom, s.y + shelfHeight);
+
+    evictionCount++;
+    changed = true;
+}
+
+void DynamicFont::RemoveSlot(int slot) {
+    glyphIndex.erase(glyphs[slot].value);
+
+    // Move the last glyph into the hole
+    int last = --font.glyphCount;
+    if (slot != last) {
+        glyphs[slot] = glyphs[last];
+        recs[slot] = recs[last];
+        glyphShelf[slot] = glyphShelf[last];
+        glyphPinned[slot] = glyphPinned[last];
+        glyphIndex[glyphs[slot].value] = slot;
+    }
+    glyphShelf[last] = -1;
+    glyphPinned[last] = false;
+}
+
+void DynamicFont::ClearRows(int top, int bottom) {
+    // White with zero alpha, like the atlas from LoadFontEx()
+    for (int i = top * ATLAS_WIDTH; i < bottom * ATLAS_WIDTH; i++) {
+        pixels[i * 2] = 255;
+        pixels[i * 2 + 1] = 0;
+    }
+}
+
+void DynamicFont::Flush() {
+    if (dirtyBottom <= dirtyTop) return;
+
+    Rectangle rows = { 0, (float)dirtyTop, (float)ATLAS_WIDTH, (float)(dirtyBottom - dirtyTop) };
+    UpdateTextureRec(font.texture, rows, &pixels[dirtyTop * ATLAS_WIDTH * 2]);
+
+    dirtyTop = atlasHeight;
+    dirtyBottom = 0;
+}
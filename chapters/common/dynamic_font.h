@@ -0,0 +1,93 @@
+#ifndef DYNAMIC_FONT_H
+#define DYNAMIC_FONT_H
+
+#include "raylib.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Dynamic glyph cache for CJK text
+//
+// LoadFontEx() with the whole CJK range rasterizes ~21k glyphs into one huge
+// atlas at startup. DynamicFont keeps the font file in memory instead and
+// rasterizes a glyph the first time some text needs it:
+//   - glyphs are packed into fixed-height rows ("shelves") of one atlas texture
+//   - the atlas starts small and doubles in height when it runs out of shelves
+//   - once it reaches MAX_SHELVES, the least recently used shelf is evicted
+//   - ASCII and texts required with pin = true are never evicted
+//
+// GetFont() returns a regular raylib Font, so it works with DrawTextEx() and
+// raygui's GuiSetFont(). Call Require() for the text of a frame BEFORE drawing
+// it, then re-bind raygui when Changed() reports that the glyph table moved on.
+class DynamicFont {
+public:
+    DynamicFont();
+    ~DynamicFont();
+
+    DynamicFont(const DynamicFont&) = delete;
+    DynamicFont& operator=(const DynamicFont&) = delete;
+
+    // Load the font file and pre-rasterize printable ASCII
+    bool Load(const char* path, int baseSize);
+    void Unload();
+    bool IsReady() const { return font.texture.id != 0; }
+
+    // Make sure every codepoint of text is in the atlas (UTF-8)
+    void Require(const char* text, bool pin = false);
+
+    // True once after the atlas texture or glyph table changed
+    bool Changed();
+
+    Font GetFont() const { return font; }
+
+    int GetGlyphCount() const { return font.glyphCount; }
+    int GetAtlasBytes() const { return ATLAS_WIDTH * atlasHeight * 2; }
+    int GetEvictionCount() const { return evictionCount; }
+
+private:
+    static constexpr int ATLAS_WIDTH = 1024;
+    static constexpr int INITIAL_SHELVES = 4;
+    static constexpr int MAX_SHELVES = 32;
+    static constexpr int MAX_GLYPHS = 2048;
+    static constexpr int GLYPH_PADDING = 4;     // Same as LoadFontEx()
+
+    struct Shelf {
+        int y;
+        int cursorX;
+        uint32_t lastUsed;
+        int pinnedCount;
+    };
+
+    Font font;
+    unsigned char* fileData;
+    int fileSize;
+
+    // Fixed capacity so the pointers handed out through GetFont() never move
+    std::vector<GlyphInfo> glyphs;
+    std::vector<Rectangle> recs;
+    std::vector<int> glyphShelf;
+    std::vector<bool> glyphPinned;
+    std::unordered_map<int, int> glyphIndex;    // codepoint -> slot
+
+    std::vector<unsigned char> pixels;          // CPU copy of the atlas (GRAY_ALPHA)
+    int atlasHeight;
+    int shelfHeight;
+    std::vector<Shelf> shelves;
+    int shelfCapacity;                          // Shelves that fit in the current atlas
+    int dirtyTop, dirtyBottom;                  // Rows to upload on the next flush
+
+    uint32_t stamp;
+    int evictionCount;
+    bool changed;
+
+    void Touch(int slot, bool pin);
+    bool Insert(const GlyphInfo& glyph, bool pin);
+    int FindShelf(int cellWidth);
+    bool GrowAtlas();
+    void EvictShelf(int shelf);
+    void RemoveSlot(int slot);
+    void ClearRows(int top, int bottom);
+    void Flush();
+};
+
+#endif // DYNAMIC_FONT_H
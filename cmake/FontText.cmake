@@ -0,0 +1,38 @@
+# 构建时从源文件中提取界面文字 / Extract UI text from sources at build time
+#
+#   target_font_text(<target> <source>...)
+#
+# 扫描给定源文件里的字符串字面量，生成 font_text.h（定义 FONT_TEXT），
+# 其中包含所有出现过的字符和可打印 ASCII。配合 games/common/font_cache.h 中的
+# LoadFontCached(path, size, FONT_TEXT) 使用，不再需要手工维护 allText。
+
+set(FONT_TEXT_SCRIPT "${CMAKE_CURRENT_LIST_DIR}/FontTextGenerate.cmake")
+
+function(target_font_text target)
+    set(out_dir "${CMAKE_CURRENT_BINARY_DIR}/font_text/${target}")
+    set(out "${out_dir}/font_text.h")
+    set(stamp "${out_dir}/font_text.stamp")
+
+    set(sources "")
+    foreach(src IN LISTS ARGN)
+        get_filename_component(abs "${src}" ABSOLUTE)
+        list(APPEND sources "${abs}")
+    endforeach()
+    string(REPLACE ";" "|" joined "${sources}")
+
+    # 脚本在内容不变时不重写 font_text.h，规则本身的输出是每次都更新的 stamp：
+    # 否则头文件比源文件旧，每次构建都会重新执行这条命令
+    add_custom_command(
+        OUTPUT "${stamp}"
+        BYPRODUCTS "${out}"
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${out_dir}"
+        COMMAND ${CMAKE_COMMAND} "-DOUTPUT=${out}" "-DSOURCES=${joined}" -P "${FONT_TEXT_SCRIPT}"
+        COMMAND ${CMAKE_COMMAND} -E touch "${stamp}"
+        DEPENDS ${sources} "${FONT_TEXT_SCRIPT}"
+        COMMENT "Extracting UI text for ${target}"
+        VERBATIM
+    )
+
+    target_sources(${target} PRIVATE "${stamp}" "${out}")
+    target_include_directories(${target} PRIVATE "${out_dir}")
+endfunction()
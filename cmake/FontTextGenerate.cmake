@@ -0,0 +1,56 @@
+# 从源文件的字符串字面量中提取界面文字，生成 font_text.h
+# 由 FontText.cmake 在构建时调用：
+#   cmake -DOUTPUT=<header> -DSOURCES=<a.cpp|b.cpp|...> -P FontTextGenerate.cmake
+
+string(REPLACE "|" ";" source_list "${SOURCES}")
+
+set(literals "")
+foreach(src IN LISTS source_list)
+    file(READ "${src}" content)
+
+    # ; 和 [ ] 在 CMake 列表里有特殊含义，先换成占位符
+    string(REPLACE ";" "@FT_SEMI@" content "${content}")
+    string(REPLACE "[" "@FT_LB@" content "${content}")
+    string(REPLACE "]" "@FT_RB@" content "${content}")
+
+    # 注释、字符串字面量、字符字面量按出现顺序一次匹配：MATCHALL 从左到右取最左边的匹配，
+    # 已经匹配的字符串里的 // 或 '{' 不会再被当成注释或字符字面量，注释里的引号也一样
+    set(comment_line "//[^\n]*")
+    set(comment_block "/\\*([^*]|\\*+[^*/])*\\*+/")
+    set(string_literal "\"(\\\\.|[^\"\\\\\n])*\"")
+    set(char_literal "'(\\\\.|[^'\\\\\n])*'")
+    string(REGEX MATCHALL "${comment_line}|${comment_block}|${string_literal}|${char_literal}" tokens "${content}")
+
+    foreach(token IN LISTS tokens)
+        if(token MATCHES "^\"")
+            list(APPEND literals "${token}")
+        endif()
+    endforeach()
+endforeach()
+list(REMOVE_DUPLICATES literals)
+
+# 可打印 ASCII 总是包含在内（数字、格式化输出等），纯 ASCII 的字面量就不必再写
+set(body "    \" !\\\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\\\]^_`abcdefghijklmnopqrstuvwxyz{|}~\"\n")
+foreach(literal IN LISTS literals)
+    if(NOT literal MATCHES "^\"[ -~]*\"$")
+        string(APPEND body "    ${literal}\n")
+    endif()
+endforeach()
+
+string(REPLACE "@FT_SEMI@" ";" body "${body}")
+string(REPLACE "@FT_LB@" "[" body "${body}")
+string(REPLACE "@FT_RB@" "]" body "${body}")
+
+set(header "// 由 cmake/FontTextGenerate.cmake 生成，请勿手动修改\n")
+string(APPEND header "// 内容：所有源文件字符串字面量中出现过的字符，用于按需加载字体字形\n")
+string(APPEND header "#pragma once\n\n")
+string(APPEND header "static const char FONT_TEXT[] =\n${body}    ;\n")
+
+# 内容不变时不重写（保持修改时间），依赖它的源文件不会重新编译
+set(old "")
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" old)
+endif()
+if(NOT old STREQUAL header)
+    file(WRITE "${OUTPUT}" "${header}")
+endif()
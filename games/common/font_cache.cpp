@@ -0,0 +1,205 @@
+#include "font_cache.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* CACHE_DIR = "data/font_cache";
+const uint32_t CACHE_MAGIC = 0x43544E46;    // "FNTC"
+const uint32_t CACHE_VERSION = 1;
+const int GLYPH_PADDING = 4;                // 与 LoadFontEx 相同
+
+// 文件头，后面依次是 glyphCount 个 CachedGlyph 和图集像素
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    int32_t baseSize;
+    int32_t glyphCount;
+    int32_t glyphPadding;
+    int32_t atlasWidth;
+    int32_t atlasHeight;
+    int32_t atlasFormat;
+};
+
+struct CachedGlyph {
+    int32_t value;
+    int32_t offsetX, offsetY, advanceX;
+    float x, y, width, height;
+};
+
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 0xCBF29CE484222325ULL) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// 去重并排序，字符串里同一个字出现多少次都只光栅化一次
+std::vector<int> collectCodepoints(const char* text) {
+    int count = 0;
+    int* cps = LoadCodepoints(text, &count);
+    std::vector<int> result(cps, cps + count);
+    UnloadCodepoints(cps);
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+uint64_t makeKey(const char* fontPath, int fontSize, int fontFileSize, const std::vector<int>& codepoints) {
+    long modTime = GetFileModTime(fontPath);
+    uint64_t key = hashBytes(fontPath, strlen(fontPath));
+    key = hashBytes(&fontSize, sizeof(fontSize), key);
+    key = hashBytes(&fontFileSize, sizeof(fontFileSize), key);
+    key = hashBytes(&modTime, sizeof(modTime), key);
+    return hashBytes(codepoints.data(), codepoints.size() * sizeof(int), key);
+}
+
+std::string cachePath(uint64_t key) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.font", static_cast<unsigned long long>(key));
+    return std::string(CACHE_DIR) + "/" + name;
+}
+
+bool loadFromCache(const std::string& path, uint64_t key, Font& font) {
+    if (!FileExists(path.c_str())) return false;
+
+    int size = 0;
+    unsigned char* data = LoadFileData(path.c_str(), &size);
+    if (data == nullptr) return false;
+
+    bool ok = false;
+    CacheHeader header;
+    if (size >= static_cast<int>(sizeof(header))) {
+        memcpy(&header, data, sizeof(header));
+
+        size_t glyphBytes = static_cast<size_t>(header.glyphCount) * sizeof(CachedGlyph);
+        size_t pixelBytes = static_cast<size_t>(GetPixelDataSize(header.atlasWidth, header.atlasHeight, header.atlasFormat));
+        bool valid = header.magic == CACHE_MAGIC && header.version == CACHE_VERSION && header.key == key &&
+                     header.glyphCount > 0 && header.atlasWidth > 0 && header.atlasHeight > 0 &&
+                     static_cast<size_t>(size) == sizeof(header) + glyphBytes + pixelBytes;
+
+        if (valid) {
+            const unsigned char* glyphData = data + sizeof(header);
+            Image atlas = {const_cast<unsigned char*>(glyphData + glyphBytes),
+                           header.atlasWidth, header.atlasHeight, 1, header.atlasFormat};
+
+            font.baseSize = header.baseSize;
+            font.glyphCount = header.glyphCount;
+            font.glyphPadding = header.glyphPadding;
+            font.texture = LoadTextureFromImage(atlas);
+            // 用 raylib 的分配器，UnloadFont 才能正确释放
+            font.glyphs = static_cast<GlyphInfo*>(MemAlloc(header.glyphCount * sizeof(GlyphInfo)));
+            font.recs = static_cast<Rectangle*>(MemAlloc(header.glyphCount * sizeof(Rectangle)));
+
+            for (int i = 0; i < header.glyphCount; i++) {
+                CachedGlyph g;
+                memcpy(&g, glyphData + i * sizeof(CachedGlyph), sizeof(g));
+                font.glyphs[i].value = g.value;
+                font.glyphs[i].offsetX = g.offsetX;
+                font.glyphs[i].offsetY = g.offsetY;
+                font.glyphs[i].advanceX = g.advanceX;
+                font.recs[i] = {g.x, g.y, g.width, g.height};
+                // 和 LoadFontEx 一样每个字形带一份 CPU 端图像（ImageText 等按字形拼图用），
+                // 从图集里按矩形切出来，缓存文件里不必再存一遍
+                font.glyphs[i].image = ImageFromImage(atlas, font.recs[i]);
+            }
+            ok = font.texture.id != 0;
+        }
+    }
+
+    UnloadFileData(data);
+    if (!ok && font.glyphs != nullptr) {
+        UnloadFont(font);
+        font = Font{};
+    }
+    return ok;
+}
+
+void saveToCache(const std::string& path, uint64_t key, const Font& font, const Image& atlas) {
+    std::error_code ec;
+    std::filesystem::create_directories(CACHE_DIR, ec);
+
+    CacheHeader header = {CACHE_MAGIC, CACHE_VERSION, key, font.baseSize, font.glyphCount,
+                          font.glyphPadding, atlas.width, atlas.height, atlas.format};
+
+    std::vector<unsigned char> out(sizeof(header));
+    memcpy(out.data(), &header, sizeof(header));
+    for (int i = 0; i < font.glyphCount; i++) {
+        const GlyphInfo& info = font.glyphs[i];
+        const Rectangle& rec = font.recs[i];
+        CachedGlyph g = {info.value, info.offsetX, info.offsetY, info.advanceX, rec.x, rec.y, rec.width, rec.height};
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&g);
+        out.insert(out.end(), bytes, bytes + sizeof(g));
+    }
+    const unsigned char* pixels = static_cast<const unsigned char*>(atlas.data);
+    out.insert(out.end(), pixels, pixels + GetPixelDataSize(atlas.width, atlas.height, atlas.format));
+
+    // 先写临时文件再改名，进程中途退出也不会留下半个缓存文件
+    std::string tmp = path + ".tmp";
+    if (!SaveFileData(tmp.c_str(), out.data(), static_cast<int>(out.size()))) return;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) std::filesystem::remove(tmp, ec);
+}
+
+// 与 LoadFontEx 相同的步骤（字形图像也保留），只是保留 CPU 端图集以便写入缓存
+bool rasterize(const unsigned char* fileData, int fileSize, int fontSize,
+               std::vector<int>& codepoints, Font& font, Image& atlas) {
+    int count = static_cast<int>(codepoints.size());
+    GlyphInfo* glyphs = LoadFontData(fileData, fileSize, fontSize, codepoints.data(), count, FONT_DEFAULT);
+    if (glyphs == nullptr) return false;
+
+    Rectangle* recs = nullptr;
+    atlas = GenImageFontAtlas(glyphs, &recs, count, fontSize, GLYPH_PADDING, 0);
+
+    font.baseSize = fontSize;
+    font.glyphCount = count;
+    font.glyphPadding = GLYPH_PADDING;
+    font.glyphs = glyphs;
+    font.recs = recs;
+    font.texture = LoadTextureFromImage(atlas);
+    return font.texture.id != 0;
+}
+
+} // namespace
+
+Font LoadFontCached(const char* fontPath, int fontSize, const char* text) {
+    Font font = {};
+    if (!FileExists(fontPath)) return font;
+
+    std::vector<int> codepoints = collectCodepoints(text);
+    if (codepoints.empty()) return font;
+
+    int fileSize = GetFileLength(fontPath);
+    uint64_t key = makeKey(fontPath, fontSize, fileSize, codepoints);
+    std::string path = cachePath(key);
+
+    if (loadFromCache(path, key, font)) {
+        TraceLog(LOG_INFO, "FONT: [%s] Loaded %d glyphs from cache %s", fontPath, font.glyphCount, path.c_str());
+        return font;
+    }
+
+    unsigned char* fileData = LoadFileData(fontPath, &fileSize);
+    if (fileData == nullptr) return font;
+
+    Image atlas = {};
+    if (rasterize(fileData, fileSize, fontSize, codepoints, font, atlas)) {
+        saveToCache(path, key, font, atlas);
+        TraceLog(LOG_INFO, "FONT: [%s] Rasterized %d glyphs, cached to %s", fontPath, font.glyphCount, path.c_str());
+    } else if (font.glyphs != nullptr) {
+        UnloadFont(font);
+        font = Font{};
+    }
+
+    UnloadImage(atlas);
+    UnloadFileData(fileData);
+    return font;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "raylib.h"
+
+// ============================================================
+// 字体图集磁盘缓存
+// ============================================================
+// LoadFontEx 每次启动都要重新光栅化 TTF。这里把光栅化好的图集和字形信息
+// 存成二进制文件，键为 (字体路径, 字号, 字体文件大小和修改时间, 字符集哈希)：
+//   - 冷启动：光栅化后写入 data/font_cache/
+//   - 热启动：直接读文件上传纹理，完全跳过 TTF 光栅化
+// text 一般传构建时生成的 FONT_TEXT（见 cmake/FontText.cmake）。
+//
+// 返回的 Font 和 LoadFontEx 的一样完整：从缓存读取时按图集矩形重新切出
+// 每个字形的 glyphs[i].image，ImageText / GenImageFontAtlas 照常可用。
+// 失败时返回 texture.id == 0 的 Font；成功时用 UnloadFont 释放。
+Font LoadFontCached(const char* fontPath, int fontSize, const char* text);
@@ -1,4 +1,6 @@
 #include "raylib.h"
+#include "font_cache.h"
+#include "font_text.h"
 #include "raymath.h"
 #include <vector>
 
@@ -22,13 +24,8 @@ int main() {
     bool ownsUIFont = false;
     {
         const char* fontPath = "/System/Library/Fonts/Supplemental/Arial Unicode.ttf";
-        const char* allText =
-            "0123456789 第一人称射击 按 ENTER 开始 WASD: 移动 | 鼠标: 瞄准 左键: 射击 | ESC: 暂停 分数: 时间: 0.0 目标: 完成！ 剩余时间: 0.0 秒 时间到！ 最终分数: 按 ENTER 返回菜单";
-
-        int cpCount = 0;
-        int* cps = LoadCodepoints(allText, &cpCount);
-        Font f = LoadFontEx(fontPath, 64, cps, cpCount);
-        UnloadCodepoints(cps);
+        // FONT_TEXT 由构建时从源码字符串中提取（font_text.h），光栅化结果缓存在 data/font_cache/
+        Font f = LoadFontCached(fontPath, 64, FONT_TEXT);
 
         if (f.texture.id != 0) {
             uiFont = f;
@@ -1,16 +1,75 @@
 #include "audio_system.h"
-#include <cstring>
-#include <cmath>
+
+namespace {
+
+// 每种音效的发声通道数和优先级（按 SoundType 顺序）
+struct VoiceConfig {
+    int limit;
+    int priority;
+};
+
+constexpr VoiceConfig VOICE_CONFIG[SOUND_TYPE_COUNT] = {
+    {4, 1},     // EAT_NORMAL
+    {2, 2},     // EAT_GOLDEN
+    {2, 1},     // EAT_SPEED
+    {2, 1},     // EAT_SLOW
+    {3, 2},     // COLLISION
+    {1, 3},     // GAME_OVER
+    {2, 2},     // EXTRA_LIFE
+    {1, 0},     // PAUSE
+    {2, 0},     // MENU_SELECT
+    {0, 0},     // BACKGROUND（音乐流，不占发声通道）
+};
+
+// 没有音频文件时的合成参数（按 SoundType 顺序）
+//  波形, 频率, 滑动, attack, decay, sustain, hold, release, 增益
+constexpr SynthPatch SYNTH_PATCHES[SOUND_TYPE_COUNT] = {
+    {Waveform::SINE, 440.0f, 2.0f, 0.005f, 0.04f, 0.6f, 0.06f, 0.04f, 0.5f},         // EAT_NORMAL - 短促上扬的"哔"
+    {Waveform::TRIANGLE, 880.0f, 1.5f, 0.005f, 0.05f, 0.7f, 0.12f, 0.08f, 0.6f},     // EAT_GOLDEN - 高音
+    {Waveform::SQUARE, 660.0f, 4.0f, 0.005f, 0.03f, 0.5f, 0.10f, 0.05f, 0.25f},      // EAT_SPEED - 上升
+    {Waveform::SQUARE, 330.0f, 0.4f, 0.005f, 0.03f, 0.5f, 0.10f, 0.05f, 0.25f},      // EAT_SLOW - 下降
+    {Waveform::NOISE, 0.0f, 1.0f, 0.0f, 0.05f, 0.5f, 0.10f, 0.10f, 0.5f},            // COLLISION - 噪音
+    {Waveform::SAW, 220.0f, 0.5f, 0.01f, 0.10f, 0.6f, 0.35f, 0.15f, 0.35f},          // GAME_OVER - 下滑的低音
+    {Waveform::TRIANGLE, 1760.0f, 1.5f, 0.005f, 0.05f, 0.7f, 0.20f, 0.10f, 0.5f},    // EXTRA_LIFE - 高音
+    {Waveform::SINE, 523.0f, 1.0f, 0.002f, 0.02f, 0.6f, 0.03f, 0.02f, 0.5f},         // PAUSE - 短音
+    {Waveform::SINE, 659.0f, 1.0f, 0.002f, 0.01f, 0.6f, 0.02f, 0.01f, 0.5f},         // MENU_SELECT - 很短的音
+    {Waveform::SINE, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f},                // BACKGROUND（不使用）
+};
+
+constexpr int totalVoices() {
+    int total = 0;
+    for (const VoiceConfig& config : VOICE_CONFIG) total += config.limit;
+    return total;
+}
+
+} // namespace
 
 // 单例实例
 AudioSystem* AudioSystem::instance = nullptr;
 
 AudioSystem::AudioSystem()
-    : musicLoaded(false),
+    : frame(0),
+      playSerial(0),
+      synthMusicPlaying(false),
+      musicLoaded(false),
       masterVolume(1.0f),
       sfxVolume(0.8f),
       musicVolume(0.5f),
       muted(false) {
+    static_assert(totalVoices() <= MAX_VOICES, "VOICE_CONFIG 超出 MAX_VOICES");
+
+    int next = 0;
+    for (int i = 0; i < SOUND_TYPE_COUNT; i++) {
+        sources[i] = SoundSource{};
+        sources[i].firstVoice = next;
+        sources[i].voiceCount = VOICE_CONFIG[i].limit;
+        sources[i].priority = VOICE_CONFIG[i].priority;
+        sources[i].lastPlayFrame = UINT32_MAX;
+        next += VOICE_CONFIG[i].limit;
+    }
+    for (Voice& voice : voices) {
+        voice = Voice{};
+    }
 }
 
 AudioSystem::~AudioSystem() {
@@ -27,10 +86,14 @@ AudioSystem& AudioSystem::getInstance() {
 void AudioSystem::init() {
     InitAudioDevice();
 
-    // 尝试加载音效文件，如果不存在则生成默认音效
-    generateDefaultSounds();
+    // 没有加载音频文件的音效都由合成器实时生成
+    if (!synth.start()) {
+        TraceLog(LOG_WARNING, "AUDIO: 合成器启动失败，只能播放音频文件");
+    }
 
     SetMasterVolume(masterVolume);
+    applySfxVolume();
+    applyMusicVolume();
 }
 
 void AudioSystem::shutdown() {
@@ -38,19 +101,19 @@ void AudioSystem::shutdown() {
     if (isShuttingDown) return;
     isShuttingDown = true;
 
-    // 卸载所有音效
-    for (auto& pair : sounds) {
-        if (pair.second.frameCount > 0) {
-            UnloadSound(pair.second);
-        }
+    // 卸载所有音效（先卸载别名，再卸载源数据）
+    for (int i = 0; i < SOUND_TYPE_COUNT; i++) {
+        unloadSource(static_cast<SoundType>(i));
     }
-    sounds.clear();
 
     if (musicLoaded) {
         UnloadMusicStream(backgroundMusic);
         musicLoaded = false;
     }
 
+    synth.stop();
+    synthMusicPlaying = false;
+
     // 检查音频设备是否已初始化
     if (IsAudioDeviceReady()) {
         CloseAudioDevice();
@@ -65,12 +128,8 @@ bool AudioSystem::loadSound(SoundType type, const std::string& filePath) {
     if (FileExists(filePath.c_str())) {
         Sound sound = LoadSound(filePath.c_str());
         if (sound.frameCount > 0) {
-            // 如果已经存在，先卸载旧的
-            if (sounds.find(type) != sounds.end()) {
-                UnloadSound(sounds[type]);
-            }
-            sounds[type] = sound;
-            SetSoundVolume(sound, sfxVolume * masterVolume);
+            // 如果已经存在，setSource 会先卸载旧的
+            setSource(type, sound);
             return true;
         }
     }
@@ -94,18 +153,125 @@ bool AudioSystem::loadBackgroundMusic(const std::string& filePath) {
     return false;
 }
 
-void AudioSystem::play(SoundType type) {
+void AudioSystem::play(SoundType type, float pitch) {
     if (muted) return;
 
-    auto it = sounds.find(type);
-    if (it != sounds.end()) {
-        PlaySound(it->second);
+    const int index = static_cast<int>(type);
+    SoundSource& source = sources[index];
+    if (source.voiceCount == 0) return;
+
+    // 同一帧内同类型只播一次（例如双人同时吃到食物）
+    if (source.lastPlayFrame == frame) return;
+
+    if (!source.loaded) {
+        SynthPatch patch = SYNTH_PATCHES[index];
+        patch.frequency *= pitch;
+        if (synth.note(patch, index, source.voiceCount, source.priority)) {
+            source.lastPlayFrame = frame;
+        }
+        return;
+    }
+
+    Voice& voice = voices[pickVoice(source)];
+    // 复用正在播放的本类型通道不增加发声数；否则要先占一个名额
+    if (!IsSoundPlaying(voice.alias) && !reserveActiveVoice(source.priority)) {
+        return;
+    }
+
+    source.lastPlayFrame = frame;
+    voice.priority = source.priority;
+    voice.startSerial = ++playSerial;
+    SetSoundPitch(voice.alias, pitch);
+    PlaySound(voice.alias);
+}
+
+int AudioSystem::pickVoice(const SoundSource& source) const {
+    int oldest = source.firstVoice;
+    for (int i = source.firstVoice; i < source.firstVoice + source.voiceCount; i++) {
+        if (!IsSoundPlaying(voices[i].alias)) return i;
+        if (voices[i].startSerial < voices[oldest].startSerial) oldest = i;
+    }
+    return oldest;
+}
+
+bool AudioSystem::reserveActiveVoice(int priority) {
+    int active = 0;
+    int victim = -1;
+    for (int i = 0; i < MAX_VOICES; i++) {
+        const Voice& voice = voices[i];
+        if (!voice.loaded || !IsSoundPlaying(voice.alias)) continue;
+        active++;
+
+        if (voice.priority > priority) continue;
+        if (victim < 0 || voice.priority < voices[victim].priority ||
+            (voice.priority == voices[victim].priority && voice.startSerial < voices[victim].startSerial)) {
+            victim = i;
+        }
+    }
+
+    if (active < MAX_ACTIVE_VOICES) return true;
+    if (victim < 0) return false;
+
+    StopSound(voices[victim].alias);
+    return true;
+}
+
+void AudioSystem::setSource(SoundType type, Sound sound) {
+    unloadSource(type);
+
+    SoundSource& source = sources[static_cast<int>(type)];
+    source.sound = sound;
+    source.loaded = sound.frameCount > 0;
+    if (!source.loaded) return;
+
+    for (int i = source.firstVoice; i < source.firstVoice + source.voiceCount; i++) {
+        voices[i].alias = LoadSoundAlias(sound);
+        voices[i].loaded = true;
+        voices[i].startSerial = 0;
+        SetSoundVolume(voices[i].alias, sfxVolume * masterVolume);
+    }
+}
+
+void AudioSystem::unloadSource(SoundType type) {
+    SoundSource& source = sources[static_cast<int>(type)];
+    if (!source.loaded) return;
+
+    for (int i = source.firstVoice; i < source.firstVoice + source.voiceCount; i++) {
+        if (voices[i].loaded) {
+            UnloadSoundAlias(voices[i].alias);
+            voices[i] = Voice{};
+        }
+    }
+    UnloadSound(source.sound);
+    source.sound = Sound{};
+    source.loaded = false;
+}
+
+void AudioSystem::applySfxVolume() {
+    for (Voice& voice : voices) {
+        if (voice.loaded) {
+            SetSoundVolume(voice.alias, sfxVolume * masterVolume);
+        }
     }
+    synth.setSfxVolume(sfxVolume * masterVolume);
+}
+
+void AudioSystem::applyMusicVolume() {
+    if (musicLoaded) {
+        SetMusicVolume(backgroundMusic, musicVolume * masterVolume);
+    }
+    synth.setMusicVolume(musicVolume * masterVolume);
 }
 
 void AudioSystem::playBackgroundMusic() {
-    if (musicLoaded && !muted) {
+    if (muted) return;
+
+    if (musicLoaded) {
         PlayMusicStream(backgroundMusic);
+    } else if (synth.isRunning()) {
+        // 没有音乐文件时播放合成器的循环乐段
+        synth.playMusic();
+        synthMusicPlaying = true;
     }
 }
 
@@ -113,18 +279,30 @@ void AudioSystem::stopBackgroundMusic() {
     if (musicLoaded) {
         StopMusicStream(backgroundMusic);
     }
+    if (synthMusicPlaying) {
+        synth.stopMusic();
+        synthMusicPlaying = false;
+    }
 }
 
 void AudioSystem::pauseBackgroundMusic() {
     if (musicLoaded) {
         PauseMusicStream(backgroundMusic);
     }
+    if (synthMusicPlaying) {
+        synth.pauseMusic();
+    }
 }
 
 void AudioSystem::resumeBackgroundMusic() {
-    if (musicLoaded && !muted) {
+    if (muted) return;
+
+    if (musicLoaded) {
         ResumeMusicStream(backgroundMusic);
     }
+    if (synthMusicPlaying) {
+        synth.resumeMusic();
+    }
 }
 
 void AudioSystem::setMasterVolume(float volume) {
@@ -132,27 +310,18 @@ void AudioSystem::setMasterVolume(float volume) {
     SetMasterVolume(volume);
 
     // 更新所有音效音量
-    for (auto& pair : sounds) {
-        SetSoundVolume(pair.second, sfxVolume * masterVolume);
-    }
-
-    if (musicLoaded) {
-        SetMusicVolume(backgroundMusic, musicVolume * masterVolume);
-    }
+    applySfxVolume();
+    applyMusicVolume();
 }
 
 void AudioSystem::setSfxVolume(float volume) {
     sfxVolume = volume;
-    for (auto& pair : sounds) {
-        SetSoundVolume(pair.second, sfxVolume * masterVolume);
-    }
+    applySfxVolume();
 }
 
 void AudioSystem::setMusicVolume(float volume) {
     musicVolume = volume;
-    if (musicLoaded) {
-        SetMusicVolume(backgroundMusic, musicVolume * masterVolume);
-    }
+    applyMusicVolume();
 }
 
 void AudioSystem::mute(bool m) {
@@ -169,100 +338,14 @@ void AudioSystem::toggleMute() {
 }
 
 void AudioSystem::update() {
+    frame++;
+
     if (musicLoaded && IsMusicStreamPlaying(backgroundMusic)) {
         UpdateMusicStream(backgroundMusic);
     }
 }
 
 bool AudioSystem::isMusicPlaying() const {
-    return musicLoaded && IsMusicStreamPlaying(backgroundMusic);
-}
-
-// ============================================================
-// 生成默认音效（程序化音效）
-// ============================================================
-void AudioSystem::generateDefaultSounds() {
-    // 吃普通食物 - 短促的"哔"声
-    sounds[SoundType::EAT_NORMAL] = createBeepSound(440.0f, 0.1f);  // A4
-
-    // 吃金色食物 - 高音
-    sounds[SoundType::EAT_GOLDEN] = createBeepSound(880.0f, 0.2f);  // A5
-
-    // 吃加速食物 - 上升的音效
-    sounds[SoundType::EAT_SPEED] = createBeepSound(660.0f, 0.15f);  // E5
-
-    // 吃减速食物 - 低音
-    sounds[SoundType::EAT_SLOW] = createBeepSound(330.0f, 0.15f);   // E4
-
-    // 碰撞 - 噪音
-    sounds[SoundType::COLLISION] = createNoiseSound(0.2f);
-
-    // 游戏结束 - 低音
-    sounds[SoundType::GAME_OVER] = createBeepSound(220.0f, 0.5f);   // A3
-
-    // 额外生命 - 高音序列
-    sounds[SoundType::EXTRA_LIFE] = createBeepSound(1760.0f, 0.3f); // A6
-
-    // 暂停 - 短音
-    sounds[SoundType::PAUSE] = createBeepSound(523.0f, 0.05f);      // C5
-
-    // 菜单选择 - 很短的音
-    sounds[SoundType::MENU_SELECT] = createBeepSound(659.0f, 0.03f); // E5
-}
-
-Sound AudioSystem::createBeepSound(float frequency, float duration) {
-    // 简单的正弦波音效生成
-    const int sampleRate = 44100;
-    const int sampleCount = static_cast<int>(sampleRate * duration);
-
-    // 创建音频数据（16位有符号整数）
-    short* data = new short[sampleCount];
-
-    for (int i = 0; i < sampleCount; i++) {
-        float t = static_cast<float>(i) / sampleRate;
-        // 正弦波 + 简单的包络
-        float envelope = 1.0f - (static_cast<float>(i) / sampleCount);
-        float sample = sinf(2.0f * PI * frequency * t) * envelope * 0.5f;
-        data[i] = static_cast<short>(sample * 32767);
-    }
-
-    // 创建 Wave
-    Wave wave;
-    wave.frameCount = sampleCount;
-    wave.sampleRate = sampleRate;
-    wave.sampleSize = 16;
-    wave.channels = 1;
-    wave.data = data;
-
-    Sound sound = LoadSoundFromWave(wave);
-
-    // 清理（LoadSoundFromWave 会复制数据）
-    delete[] data;
-
-    return sound;
-}
-
-Sound AudioSystem::createNoiseSound(float duration) {
-    const int sampleRate = 44100;
-    const int sampleCount = static_cast<int>(sampleRate * duration);
-
-    short* data = new short[sampleCount];
-
-    for (int i = 0; i < sampleCount; i++) {
-        float envelope = 1.0f - (static_cast<float>(i) / sampleCount);
-        float sample = (static_cast<float>(rand()) / RAND_MAX * 2.0f - 1.0f) * envelope * 0.5f;
-        data[i] = static_cast<short>(sample * 32767);
-    }
-
-    Wave wave;
-    wave.frameCount = sampleCount;
-    wave.sampleRate = sampleRate;
-    wave.sampleSize = 16;
-    wave.channels = 1;
-    wave.data = data;
-
-    Sound sound = LoadSoundFromWave(wave);
-    delete[] data;
-
-    return sound;
+    if (musicLoaded) return IsMusicStreamPlaying(backgroundMusic);
+    return synthMusicPlaying;
 }
@@ -1,7 +1,8 @@
 #pragma once
 #include "raylib.h"
+#include "synth.h"
+#include <cstdint>
 #include <string>
-#include <unordered_map>
 #include <memory>
 
 // ============================================================
@@ -20,13 +21,51 @@ enum class SoundType {
     BACKGROUND,     // 背景音乐
 };
 
+constexpr int SOUND_TYPE_COUNT = static_cast<int>(SoundType::BACKGROUND) + 1;
+
 // ============================================================
 // 音频系统 - 管理所有音效和音乐
 // ============================================================
+// 没有音频文件的音效和背景音乐由 Synth 在音频线程里实时合成（参数见
+// audio_system.cpp 的 SYNTH_PATCHES），启动时不生成任何采样。
+//
+// 加载了音频文件的音效用 LoadSoundAlias 建若干个共享数据的发声通道：
+//   - 同类型可以重叠播放（上限见 audio_system.cpp 的 VOICE_CONFIG），
+//     通道用完时重新开始本类型最早的那个
+//   - 同时发声的总数有上限，超出时停掉优先级最低（同级取最早）的声音；
+//     新声音优先级更低时直接丢弃
+//   - 同一帧内同类型只播放一次
+// 合成器的发声通道遵守同样的规则。play() 只遍历固定大小的数组，不分配内存。
 class AudioSystem {
 private:
+    struct SoundSource {
+        Sound sound;
+        bool loaded;                // 是否加载了音频文件（否则用合成器）
+        int firstVoice;             // 在 voices 中的起始下标
+        int voiceCount;             // 同时播放上限
+        int priority;               // 越大越重要
+        uint32_t lastPlayFrame;     // 最近一次播放所在的帧（同帧去重）
+    };
+
+    struct Voice {
+        Sound alias;                // 与 SoundSource::sound 共享采样数据
+        bool loaded;
+        int priority;
+        uint32_t startSerial;       // 开始播放的序号，越小越早
+    };
+
+    static constexpr int MAX_VOICES = 24;           // 所有类型的发声通道总数
+    static constexpr int MAX_ACTIVE_VOICES = 8;     // 同时发声上限
+
     // 音效资源
-    std::unordered_map<SoundType, Sound> sounds;
+    SoundSource sources[SOUND_TYPE_COUNT];
+    Voice voices[MAX_VOICES];
+    uint32_t frame;                 // update() 调用次数
+    uint32_t playSerial;
+
+    Synth synth;
+    bool synthMusicPlaying;
+
     Music backgroundMusic;
     bool musicLoaded;
 
@@ -54,8 +93,8 @@ public:
     bool loadSound(SoundType type, const std::string& filePath);
     bool loadBackgroundMusic(const std::string& filePath);
 
-    // 播放
-    void play(SoundType type);
+    // 播放；pitch 为音调倍率（1 = 原调）
+    void play(SoundType type, float pitch = 1.0f);
     void playBackgroundMusic();
     void stopBackgroundMusic();
     void pauseBackgroundMusic();
@@ -79,11 +118,14 @@ public:
     // 检查是否正在播放背景音乐
     bool isMusicPlaying() const;
 
-    // 生成默认音效（如果没有音频文件）
-    void generateDefaultSounds();
-
 private:
-    // 创建程序化音效
-    Sound createBeepSound(float frequency, float duration);
-    Sound createNoiseSound(float duration);
+    // 替换某类型的音效并重建它的发声通道
+    void setSource(SoundType type, Sound sound);
+    void unloadSource(SoundType type);
+    // 选一个本类型的通道：空闲的优先，否则最早开始的
+    int pickVoice(const SoundSource& source) const;
+    // 确保总发声数不超上限，必要时按优先级抢占；返回 false 表示应丢弃新声音
+    bool reserveActiveVoice(int priority);
+    void applySfxVolume();
+    void applyMusicVolume();
 };
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// ============================================================
+// 位运算小工具 - 遍历位图时用的硬件指令
+// ============================================================
+// 分块位图按 64 位一行存储，逐个取出置位的格子时
+// 用最低位计数代替逐位试探，一个置位只要一条指令。
+
+// 最低置位的下标；bits 不能为 0
+inline int countTrailingZeros(uint64_t bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// 置位个数
+inline int popCount(uint64_t bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<int>(__popcnt64(bits));
+#else
+    return __builtin_popcountll(bits);
+#endif
+}
+
+// 按从低到高的顺序对每个置位的下标调用 f(bit)
+template <typename F>
+inline void forEachSetBit(uint64_t bits, F&& f) {
+    while (bits != 0) {
+        f(countTrailingZeros(bits));
+        bits &= bits - 1;
+    }
+}
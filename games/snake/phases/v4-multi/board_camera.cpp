@@ -0,0 +1,99 @@
+#include "board_camera.h"
+#include <algorithm>
+#include <cmath>
+
+BoardCamera::BoardCamera(float cell)
+    : viewport{0.0f, 0.0f, 0.0f, 0.0f}, cellSize(cell),
+      boardWidth(0), boardHeight(0), minZoom(1.0f), maxZoom(1.0f) {
+    camera.offset = {0.0f, 0.0f};
+    camera.target = {0.0f, 0.0f};
+    camera.rotation = 0.0f;
+    camera.zoom = 1.0f;
+}
+
+void BoardCamera::setBoard(int w, int h) {
+    boardWidth = w;
+    boardHeight = h;
+    clampTarget();
+}
+
+void BoardCamera::setViewport(Rectangle area) {
+    viewport = area;
+    camera.offset = {area.x + area.width * 0.5f, area.y + area.height * 0.5f};
+    clampTarget();
+}
+
+void BoardCamera::setZoomRange(float minimum, float maximum) {
+    minZoom = minimum;
+    maxZoom = maximum;
+    camera.zoom = std::clamp(camera.zoom, minZoom, maxZoom);
+    clampTarget();
+}
+
+void BoardCamera::fit(float maxFitZoom) {
+    const float worldW = std::max(1.0f, boardWidth * cellSize);
+    const float worldH = std::max(1.0f, boardHeight * cellSize);
+    camera.zoom = std::min({maxFitZoom, viewport.width / worldW, viewport.height / worldH});
+    // 缩小到整张地图可见时要允许这个缩放
+    minZoom = std::min(minZoom, camera.zoom);
+    camera.target = {worldW * 0.5f, worldH * 0.5f};
+    clampTarget();
+}
+
+void BoardCamera::centerOn(Vector2 world) {
+    camera.target = world;
+    clampTarget();
+}
+
+void BoardCamera::pan(Vector2 screenDelta) {
+    camera.target.x -= screenDelta.x / camera.zoom;
+    camera.target.y -= screenDelta.y / camera.zoom;
+    clampTarget();
+}
+
+void BoardCamera::zoomAt(Vector2 anchor, float factor) {
+    // 缩放前后 anchor 下的世界坐标保持不动
+    Vector2 before = GetScreenToWorld2D(anchor, camera);
+    camera.zoom = std::clamp(camera.zoom * factor, minZoom, maxZoom);
+    Vector2 after = GetScreenToWorld2D(anchor, camera);
+    camera.target.x += before.x - after.x;
+    camera.target.y += before.y - after.y;
+    clampTarget();
+}
+
+void BoardCamera::screenToCell(Vector2 screen, int& x, int& y) const {
+    Vector2 world = GetScreenToWorld2D(screen, camera);
+    x = static_cast<int>(std::floor(world.x / cellSize));
+    y = static_cast<int>(std::floor(world.y / cellSize));
+}
+
+bool BoardCamera::isInViewport(Vector2 screen) const {
+    return CheckCollisionPointRec(screen, viewport);
+}
+
+Rectangle BoardCamera::getVisibleWorld() const {
+    const float w = viewport.width / camera.zoom;
+    const float h = viewport.height / camera.zoom;
+    return {camera.target.x - w * 0.5f, camera.target.y - h * 0.5f, w, h};
+}
+
+void BoardCamera::getVisibleCells(int& x0, int& y0, int& x1, int& y1) const {
+    Rectangle world = getVisibleWorld();
+    x0 = std::max(0, static_cast<int>(std::floor(world.x / cellSize)));
+    y0 = std::max(0, static_cast<int>(std::floor(world.y / cellSize)));
+    x1 = std::min(boardWidth - 1, static_cast<int>(std::floor((world.x + world.width) / cellSize)));
+    y1 = std::min(boardHeight - 1, static_cast<int>(std::floor((world.y + world.height) / cellSize)));
+}
+
+void BoardCamera::clampTarget() {
+    const float worldW = boardWidth * cellSize;
+    const float worldH = boardHeight * cellSize;
+    const float halfW = viewport.width * 0.5f / camera.zoom;
+    const float halfH = viewport.height * 0.5f / camera.zoom;
+
+    // 地图比视口小的方向居中，否则不让视口移出地图
+    camera.target.x = (worldW <= halfW * 2.0f) ? worldW * 0.5f
+                                               : std::clamp(camera.target.x, halfW, worldW - halfW);
+    camera.target.y = (worldH <= halfH * 2.0f) ? worldH * 0.5f
+                                               : std::clamp(camera.target.y, halfH, worldH - halfH);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "raylib.h"
+
+// ============================================================
+// BoardCamera - 地图相机（平移、缩放、可见范围）
+// ============================================================
+// 世界坐标以像素为单位，格子 (x, y) 占 [x*cellSize, (x+1)*cellSize)。
+// 相机把视口中心对准 target；地图在某个方向上比视口小时居中，
+// 否则 target 被限制在地图内，不会移出边界。
+// 默认 40x30 的地图正好铺满 800x600 的窗口，此时相机就是恒等变换。
+class BoardCamera {
+private:
+    Camera2D camera;
+    Rectangle viewport;         // 屏幕上的显示区域
+    float cellSize;             // zoom = 1 时一个格子的像素数
+    int boardWidth, boardHeight;
+    float minZoom, maxZoom;
+
+public:
+    explicit BoardCamera(float cellSize = 20.0f);
+
+    void setBoard(int w, int h);
+    void setViewport(Rectangle area);
+    void setZoomRange(float minimum, float maximum);
+
+    // 把整个地图放进视口并居中，最多放大到 maxFitZoom
+    void fit(float maxFitZoom = 1.0f);
+    // 视口中心对准世界坐标 world（会被限制在地图内）
+    void centerOn(Vector2 world);
+    // 按屏幕像素平移
+    void pan(Vector2 screenDelta);
+    // 以屏幕上的 anchor 为中心缩放
+    void zoomAt(Vector2 anchor, float factor);
+
+    // 屏幕坐标 -> 格子坐标（向下取整，可能越界）
+    void screenToCell(Vector2 screen, int& x, int& y) const;
+    bool isInViewport(Vector2 screen) const;
+    // 可见格子范围 [x0, x1] x [y0, y1]，已截断到地图内
+    void getVisibleCells(int& x0, int& y0, int& x1, int& y1) const;
+    // 可见区域（世界坐标）
+    Rectangle getVisibleWorld() const;
+
+    const Camera2D& get() const { return camera; }
+    Rectangle getViewport() const { return viewport; }
+    float getCellSize() const { return cellSize; }
+    float getCellPixels() const { return cellSize * camera.zoom; }
+
+private:
+    void clampTarget();
+};
@@ -0,0 +1,133 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// ============================================================
+// ByteWriter / ByteReader - 紧凑的二进制读写（小端 + 变长整数）
+// ============================================================
+// 用于模拟状态快照和回放文件。变长整数 (varint) 每字节存 7 位，
+// 小数值只占 1 个字节；有符号数先做 zigzag 编码。
+// 浮点数按原始位模式保存，读回后与写入时逐位相同。
+
+// FNV-1a 64 位哈希（关卡校验、状态校验）
+inline uint64_t hashBytes(const uint8_t* data, size_t size, uint64_t hash = 0xCBF29CE484222325ULL) {
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+class ByteWriter {
+private:
+    std::vector<uint8_t>& out;
+
+public:
+    explicit ByteWriter(std::vector<uint8_t>& buffer) : out(buffer) {}
+
+    void writeU8(uint8_t v) { out.push_back(v); }
+
+    void writeU32(uint32_t v) {
+        for (int i = 0; i < 4; i++) out.push_back(static_cast<uint8_t>(v >> (i * 8)));
+    }
+
+    void writeU64(uint64_t v) {
+        for (int i = 0; i < 8; i++) out.push_back(static_cast<uint8_t>(v >> (i * 8)));
+    }
+
+    void writeF32(float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        writeU32(bits);
+    }
+
+    void writeVarint(uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(v));
+    }
+
+    void writeSVarint(int64_t v) {
+        writeVarint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+    }
+
+    void writeBytes(const uint8_t* data, size_t size) {
+        out.insert(out.end(), data, data + size);
+    }
+
+    size_t size() const { return out.size(); }
+};
+
+// 读取越界或格式错误时不抛异常：返回 0 并置 failed，调用者最后检查 ok()
+class ByteReader {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    bool failed;
+
+public:
+    ByteReader(const uint8_t* bytes, size_t length)
+        : data(bytes), size(length), pos(0), failed(false) {}
+
+    uint8_t readU8() {
+        if (pos >= size) { failed = true; return 0; }
+        return data[pos++];
+    }
+
+    uint32_t readU32() {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++) v |= static_cast<uint32_t>(readU8()) << (i * 8);
+        return v;
+    }
+
+    uint64_t readU64() {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; i++) v |= static_cast<uint64_t>(readU8()) << (i * 8);
+        return v;
+    }
+
+    float readF32() {
+        uint32_t bits = readU32();
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+
+    uint64_t readVarint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = readU8();
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        failed = true;
+        return 0;
+    }
+
+    int64_t readSVarint() {
+        uint64_t v = readVarint();
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    // 返回指向内部数据的指针并跳过 length 个字节
+    const uint8_t* readBytes(size_t length) {
+        if (length > size - pos) { failed = true; pos = size; return nullptr; }
+        const uint8_t* p = data + pos;
+        pos += length;
+        return p;
+    }
+
+    void seek(size_t offset) {
+        if (offset > size) { failed = true; offset = size; }
+        pos = offset;
+    }
+
+    size_t position() const { return pos; }
+    bool atEnd() const { return pos >= size; }
+    bool ok() const { return !failed; }
+};
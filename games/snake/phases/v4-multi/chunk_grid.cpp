@@ -0,0 +1,63 @@
+#include "chunk_grid.h"
+#include <algorithm>
+
+ChunkedBitGrid::ChunkedBitGrid()
+    : width(0), height(0), chunksX(0), chunksY(0), count(0), allocated(0) {
+}
+
+void ChunkedBitGrid::reset(int w, int h) {
+    width = std::clamp(w, 0, MAX_SIDE);
+    height = std::clamp(h, 0, MAX_SIDE);
+    chunksX = (width + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+    chunksY = (height + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+    chunks.clear();
+    chunks.resize(static_cast<size_t>(chunksX) * chunksY);
+    count = 0;
+    allocated = 0;
+}
+
+void ChunkedBitGrid::clear() {
+    for (auto& chunk : chunks) {
+        chunk.reset();
+    }
+    count = 0;
+    allocated = 0;
+}
+
+bool ChunkedBitGrid::get(int x, int y) const {
+    if (!inBounds(x, y)) return false;
+    const Chunk* chunk = chunks[(y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT)].get();
+    if (!chunk) return false;
+    return (chunk->rows[y & (CHUNK_SIZE - 1)] >> (x & (CHUNK_SIZE - 1))) & 1;
+}
+
+bool ChunkedBitGrid::set(int x, int y, bool value) {
+    if (!inBounds(x, y)) return false;
+
+    std::unique_ptr<Chunk>& chunk = chunks[(y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT)];
+    if (!chunk) {
+        if (!value) return false;
+        chunk = std::make_unique<Chunk>();
+        std::fill(std::begin(chunk->rows), std::end(chunk->rows), 0);
+        chunk->count = 0;
+        allocated++;
+    }
+
+    uint64_t& row = chunk->rows[y & (CHUNK_SIZE - 1)];
+    const uint64_t mask = 1ull << (x & (CHUNK_SIZE - 1));
+    if (((row & mask) != 0) == value) return false;
+
+    if (value) {
+        row |= mask;
+        chunk->count++;
+        count++;
+    } else {
+        row &= ~mask;
+        count--;
+        if (--chunk->count == 0) {
+            chunk.reset();
+            allocated--;
+        }
+    }
+    return true;
+}
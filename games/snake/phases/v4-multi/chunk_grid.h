@@ -0,0 +1,76 @@
+#pragma once
+#include "bit_ops.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// ============================================================
+// ChunkedBitGrid - 分块存储的稀疏位图
+// ============================================================
+// 地图切成 64x64 的块，每块 64 个 uint64_t，块内一行正好一个字。
+// 块在第一次置位时才分配，最后一位清掉后释放：2048x2048 的空地图
+// 只有一张块指针表，内存与实际用到的区域成正比。查询和修改都是 O(1)。
+class ChunkedBitGrid {
+public:
+    static constexpr int CHUNK_SHIFT = 6;
+    static constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+    static constexpr int MAX_SIDE = 2048;       // 地图边长上限
+
+private:
+    struct Chunk {
+        uint64_t rows[CHUNK_SIZE];  // 低位在左
+        int count;                  // 块内置位数
+    };
+
+    std::vector<std::unique_ptr<Chunk>> chunks;     // 行优先，空块为 nullptr
+    int width, height;
+    int chunksX, chunksY;
+    size_t count;
+    size_t allocated;
+
+public:
+    ChunkedBitGrid();
+
+    // 清空并设置尺寸（边长截断到 MAX_SIDE）
+    void reset(int w, int h);
+    void clear();
+
+    bool inBounds(int x, int y) const {
+        return x >= 0 && x < width && y >= 0 && y < height;
+    }
+    // 越界返回 false
+    bool get(int x, int y) const;
+    // 返回是否有变化；越界忽略
+    bool set(int x, int y, bool value);
+
+    // 块 (cx, cy) 第 row 行的 64 位，空块返回 0
+    uint64_t getChunkRow(int cx, int cy, int row) const {
+        const Chunk* chunk = chunks[cy * chunksX + cx].get();
+        return chunk ? chunk->rows[row] : 0;
+    }
+    bool isChunkEmpty(int cx, int cy) const { return !chunks[cy * chunksX + cx]; }
+
+    // 按块、行的顺序对每个置位的格子调用 f(x, y)，空块整个跳过
+    template <typename F>
+    void forEach(F&& f) const {
+        for (int cy = 0; cy < chunksY; cy++) {
+            for (int cx = 0; cx < chunksX; cx++) {
+                const Chunk* chunk = chunks[cy * chunksX + cx].get();
+                if (!chunk) continue;
+                for (int row = 0; row < CHUNK_SIZE; row++) {
+                    forEachSetBit(chunk->rows[row], [&](int bit) {
+                        f((cx << CHUNK_SHIFT) + bit, (cy << CHUNK_SHIFT) + row);
+                    });
+                }
+            }
+        }
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getChunksX() const { return chunksX; }
+    int getChunksY() const { return chunksY; }
+    size_t size() const { return count; }
+    size_t getAllocatedChunks() const { return allocated; }
+};
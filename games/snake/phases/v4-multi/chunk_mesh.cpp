@@ -0,0 +1,69 @@
+#include "chunk_mesh.h"
+
+ChunkMeshCache::ChunkMeshCache()
+    : chunksX(0), chunksY(0), rebuildCount(0) {
+}
+
+void ChunkMeshCache::reset(int cx, int cy) {
+    chunksX = cx;
+    chunksY = cy;
+    meshes.assign(static_cast<size_t>(cx) * cy, Mesh{{}, true});
+}
+
+void ChunkMeshCache::invalidateAll() {
+    for (Mesh& mesh : meshes) {
+        mesh.dirty = true;
+    }
+}
+
+void ChunkMeshCache::invalidateCell(int x, int y) {
+    const int cx = x >> CHUNK_SHIFT;
+    const int cy = y >> CHUNK_SHIFT;
+    if (x < 0 || y < 0 || cx >= chunksX || cy >= chunksY) return;
+    meshes[cy * chunksX + cx].dirty = true;
+}
+
+void ChunkMeshCache::rebuild(Mesh& mesh, const uint64_t* rows, int cx, int cy) {
+    mesh.rects.clear();
+    mesh.dirty = false;
+    rebuildCount++;
+
+    const float baseX = static_cast<float>(cx << CHUNK_SHIFT);
+    const float baseY = static_cast<float>(cy << CHUNK_SHIFT);
+
+    // 上一行各段对应的矩形下标，起止相同就把矩形向下延伸
+    std::vector<size_t> open;
+    std::vector<size_t> next;
+
+    for (int row = 0; row < CHUNK_SIZE; row++) {
+        uint64_t bits = rows[row];
+        next.clear();
+        size_t candidate = 0;
+
+        int x = 0;
+        while (bits != 0 && x < CHUNK_SIZE) {
+            // 跳过空格子，再数连续的墙
+            while (x < CHUNK_SIZE && !((bits >> x) & 1)) x++;
+            int start = x;
+            while (x < CHUNK_SIZE && ((bits >> x) & 1)) x++;
+            if (start == x) break;
+
+            const float left = baseX + start;
+            const float width = static_cast<float>(x - start);
+            const float top = baseY + row;
+
+            while (candidate < open.size() && mesh.rects[open[candidate]].x < left) candidate++;
+            if (candidate < open.size()) {
+                Rectangle& above = mesh.rects[open[candidate]];
+                if (above.x == left && above.width == width && above.y + above.height == top) {
+                    above.height += 1.0f;
+                    next.push_back(open[candidate]);
+                    continue;
+                }
+            }
+            next.push_back(mesh.rects.size());
+            mesh.rects.push_back({left, top, width, 1.0f});
+        }
+        open.swap(next);
+    }
+}
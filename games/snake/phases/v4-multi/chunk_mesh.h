@@ -0,0 +1,69 @@
+#pragma once
+#include "raylib.h"
+#include "chunk_grid.h"
+#include <algorithm>
+#include <vector>
+
+// ============================================================
+// ChunkMeshCache - 按块缓存的墙壁几何
+// ============================================================
+// 每块的墙壁合并成矩形列表（坐标以格子为单位）：同一行连续的格子
+// 合成一段，上下相邻且起止相同的段再合成一个矩形。块内有格子变化时
+// 只把这一块标脏，下次取用时重建；绘制时只遍历与可见区域相交的块。
+// 几何与缩放无关，相机怎么移动都不需要重建。
+class ChunkMeshCache {
+private:
+    static constexpr int CHUNK_SHIFT = ChunkedBitGrid::CHUNK_SHIFT;
+    static constexpr int CHUNK_SIZE = ChunkedBitGrid::CHUNK_SIZE;
+
+    struct Mesh {
+        std::vector<Rectangle> rects;
+        bool dirty;
+    };
+    std::vector<Mesh> meshes;
+    int chunksX, chunksY;
+    int rebuildCount;               // 累计重建次数（调试用）
+
+public:
+    ChunkMeshCache();
+
+    // 设置块数并全部标脏
+    void reset(int cx, int cy);
+    void invalidateAll();
+    void invalidateCell(int x, int y);
+
+    // 块 (cx, cy) 的矩形列表；grid 需提供 getChunkRow(cx, cy, row)
+    template <typename Grid>
+    const std::vector<Rectangle>& get(const Grid& grid, int cx, int cy) {
+        Mesh& mesh = meshes[cy * chunksX + cx];
+        if (mesh.dirty) {
+            uint64_t rows[CHUNK_SIZE];
+            for (int row = 0; row < CHUNK_SIZE; row++) {
+                rows[row] = grid.getChunkRow(cx, cy, row);
+            }
+            rebuild(mesh, rows, cx, cy);
+        }
+        return mesh.rects;
+    }
+
+    // 对与格子区域 [x0, x1] x [y0, y1] 相交的块中的每个矩形调用 f(rect)
+    template <typename Grid, typename F>
+    void forEachRect(const Grid& grid, int x0, int y0, int x1, int y1, F&& f) {
+        const int cx0 = std::max(0, x0 >> CHUNK_SHIFT);
+        const int cy0 = std::max(0, y0 >> CHUNK_SHIFT);
+        const int cx1 = std::min(chunksX - 1, x1 >> CHUNK_SHIFT);
+        const int cy1 = std::min(chunksY - 1, y1 >> CHUNK_SHIFT);
+        for (int cy = cy0; cy <= cy1; cy++) {
+            for (int cx = cx0; cx <= cx1; cx++) {
+                for (const Rectangle& rect : get(grid, cx, cy)) {
+                    f(rect);
+                }
+            }
+        }
+    }
+
+    int getRebuildCount() const { return rebuildCount; }
+
+private:
+    void rebuild(Mesh& mesh, const uint64_t* rows, int cx, int cy);
+};
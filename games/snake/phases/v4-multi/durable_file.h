@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================
+// 落盘安全的文件读写
+// ============================================================
+// writeFileAtomic：先写同目录下的临时文件并 fsync，再 rename 覆盖目标，
+// 最后 fsync 目录。任何时刻崩溃，目标文件要么是旧内容，要么是新内容。
+// appendFileDurable：追加到文件末尾并 fsync，返回时数据已经落盘。
+// 两者都是阻塞调用，应放在后台线程里执行。
+
+// 读取整个文件；文件不存在或读取失败时返回 false
+bool readFileBytes(const std::string& path, std::vector<uint8_t>& out);
+
+bool writeFileAtomic(const std::string& path, const uint8_t* data, size_t size);
+bool appendFileDurable(const std::string& path, const uint8_t* data, size_t size);
@@ -1,5 +1,12 @@
 #include "game.h"
+#include "font_cache.h"
+#include "font_text.h"
+#include <algorithm>
 #include <cmath>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
 
 Color LerpColor(Color a, Color b, float t) {
     Color result;
@@ -10,38 +17,56 @@ Color LerpColor(Color a, Color b, float t) {
     return result;
 }
 
+// 道具颜色（模拟核心不依赖 raylib，颜色由前端决定）
+static Color getItemColor(ItemType type) {
+    switch (type) {
+        case ItemType::NORMAL:    return RED;
+        case ItemType::GOLDEN:    return GOLD;
+        case ItemType::SPEED_UP:  return SKYBLUE;
+        case ItemType::SLOW_DOWN: return PURPLE;
+    }
+    return RED;
+}
+
 Game::Game()
-    : obstacles(GRID_WIDTH, GRID_HEIGHT),
+    : particles(PARTICLE_CAPACITY),
+      camera(static_cast<float>(GRID_SIZE)),
       gameMode(GameMode::SINGLE),
       state(GameState::MENU),
-      score(0), score2(0), lives(MAX_LIVES), lives2(MAX_LIVES),
-      highScore(0), targetScore(100),
-      moveTimer(0), baseMoveInterval(0.15f),
+      scoreBoardMode(GameMode::SINGLE),
+      highScore(0),
+      moveTimer(0), replaying(false),
       ownsFont(false), messageTimer(0),
-      playerName(""), finalScore(0), finalLength(0),
+      playerName(""), finalScore(0), finalLength(0), resultPending(false),
       settingsSelection(0) {
+    startupBegin = std::chrono::steady_clock::now();
     initWindow();
     initFont();
+    initBoardTexture();
     
     AudioSystem::getInstance().init();
-    AudioSystem::getInstance().generateDefaultSounds();
     
     settingsManager.load();
     settingsManager.applyToAudio();
     
-    highScore = highScoreManager.getHighestScore();
-    
     // 初始化关卡管理器
     levelManager = std::make_unique<LevelManager>();
     levelEditor = std::make_unique<LevelEditor>(GRID_SIZE);
 }
 
 Game::~Game() {
-    settingsManager.save();
+    // 设置在修改时已交给后台写盘，SettingsManager 析构时限时等待它写完
     
+    // 输入名字时直接退出：这局仍然记进历史和榜单，用默认名字
+    if (resultPending) {
+        recordResult(DEFAULT_PLAYER_NAME, true);
+    }
+    
+    // GPU 资源必须在关闭窗口前释放
     if (ownsFont) {
         UnloadFont(uiFont);
     }
+    UnloadTexture(checkerTexture);
     
     CloseWindow();
 }
@@ -63,23 +88,15 @@ void Game::initFont() {
         nullptr
     };
     
-    const char* allText =
-        "0123456789 -:,.!?[]()%+*/"
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
-        "贪吃蛇按开始游戏暂停继续结束分数长度生命道具操作方向键选择确认移动返回菜单设置高分榜音量音效音乐难度简单普通困难玩家输入你的名字删除保存并建议双人单人编辑对战模式关卡工具墙壁橡皮橡皮擦出生点未尺寸新随机生成关卡已撞失去一条耗尽吃到普通食物金色加速减速奖励目标静音暂无记录纪录最终平局获胜主当前切换使用自定义地图左右上下退出程序"
-        "WASDENTERESCP1P2VSv4multiMuteSoundMusicVolumeEasyNormalHardEnterNamePlayerNewRecord";  // 包含所有可能用到的字符
-    
+    // FONT_TEXT 由构建时从源码字符串中提取（font_text.h），不必再手工维护字符表；
+    // 光栅化结果缓存在 data/font_cache/，之后启动不再重新光栅化
     for (int i = 0; fontPaths[i] != nullptr; i++) {
-        if (!FileExists(fontPaths[i])) continue;
-        
-        int cpCount = 0;
-        int* cps = LoadCodepoints(allText, &cpCount);
-        Font f = LoadFontEx(fontPaths[i], 64, cps, cpCount);
-        UnloadCodepoints(cps);
+        Font f = LoadFontCached(fontPaths[i], 64, FONT_TEXT);
         
         if (f.texture.id != 0) {
             uiFont = f;
             ownsFont = true;
+            textCache.clear();
             SetTextureFilter(uiFont.texture, TEXTURE_FILTER_BILINEAR);
             TraceLog(LOG_INFO, "Font loaded: %s", fontPaths[i]);
             return;
@@ -87,51 +104,53 @@ void Game::initFont() {
     }
 }
 
-void Game::init() {
-    // 根据当前关卡数据初始化
-    if (currentLevelData.spawnPoints.size() >= 1) {
-        snake = std::make_unique<Snake>(
-            static_cast<int>(currentLevelData.spawnPoints[0].x),
-            static_cast<int>(currentLevelData.spawnPoints[0].y),
-            GRID_WIDTH, GRID_HEIGHT);
-    } else {
-        snake = std::make_unique<Snake>(GRID_WIDTH / 2, GRID_HEIGHT / 2, GRID_WIDTH, GRID_HEIGHT);
-    }
-    
-    // 双人模式初始化第二条蛇
-    if (gameMode == GameMode::VERSUS) {
-        int spawnX = GRID_WIDTH / 3;
-        int spawnY = GRID_HEIGHT / 3;
-        if (currentLevelData.spawnPoints.size() >= 2) {
-            spawnX = static_cast<int>(currentLevelData.spawnPoints[1].x);
-            spawnY = static_cast<int>(currentLevelData.spawnPoints[1].y);
-        }
+void Game::initBoardTexture() {
+    // 一个纹素对应一个格子：(i mod 2, j mod 2) 正好是格子 (i, j) 的颜色。
+    // 内容与地图无关，整个程序只创建一次
+    const Color even = Fade(GREEN, 0.1f);
+    const Color odd = Fade(GREEN, 0.05f);
+    Color pixels[4] = {even, odd, odd, even};
+    Image image = {pixels, 2, 2, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+    checkerTexture = LoadTextureFromImage(image);
+    SetTextureFilter(checkerTexture, TEXTURE_FILTER_POINT);
+    SetTextureWrap(checkerTexture, TEXTURE_WRAP_REPEAT);
+}
 
-        snake2 = std::make_unique<Snake>(spawnX, spawnY, GRID_WIDTH, GRID_HEIGHT);
-    } else {
-        snake2.reset();
-    }
+SimConfig Game::makeSimConfig() const {
+    SimConfig config;
+    config.gridWidth = currentLevelData.width > 0 ? currentLevelData.width : DEFAULT_GRID_WIDTH;
+    config.gridHeight = currentLevelData.height > 0 ? currentLevelData.height : DEFAULT_GRID_HEIGHT;
+    config.versus = (gameMode == GameMode::VERSUS);
+    config.targetScore = currentLevelData.targetScore > 0 ? currentLevelData.targetScore : 100;
+    config.randomCrates = RANDOM_CRATES;
+    config.itemCount = (gameMode == GameMode::RUSH) ? RUSH_ITEM_COUNT : 1;
     
-    // 加载关卡墙壁
-    obstacles.clear();
-
     for (const auto& wall : currentLevelData.walls) {
-        obstacles.addObstacle(static_cast<int>(wall.x), static_cast<int>(wall.y));
+        config.walls.push_back({static_cast<int>(wall.x), static_cast<int>(wall.y)});
+    }
+    for (const auto& spawn : currentLevelData.spawnPoints) {
+        config.spawnPoints.push_back({static_cast<int>(spawn.x), static_cast<int>(spawn.y)});
     }
+    
+    // 对局内的随机性全部来自这个种子
+    config.seed = static_cast<uint64_t>(GetRandomValue(0, 0x7FFFFFFF));
+    return config;
+}
 
-    if (obstacles.getCount() == 0) {
-        obstacles.generate(5, *snake);
+void Game::init() {
+    if (replaying) {
+        // 回放时种子和关卡都来自回放文件
+        sim = replayPlayer.createSim();
+    } else {
+        // 根据当前关卡数据初始化，并从 tick 0 开始录制
+        sim = std::make_unique<SnakeSim>(makeSimConfig());
+        recorder.begin(*sim);
+        highScore = highScoreManager.getHighestScore(getScoreBoardLevel(), static_cast<uint8_t>(gameMode));
     }
+    pendingInput = TickInput();
+    rebuildBoard();             // 新对局的尺寸和墙壁可能不同
     
-    spawnItem();
-    score = 0;
-    score2 = 0;
-    lives = MAX_LIVES;
-    lives2 = MAX_LIVES;
-    targetScore = currentLevelData.targetScore > 0 ? currentLevelData.targetScore : 100;
     moveTimer = 0;
-    baseMoveInterval = 0.15f;
-    speedEffect = SpeedEffect();
     message.clear();
     messageTimer = 0;
     particles.clear();
@@ -142,21 +161,45 @@ void Game::init() {
 }
 
 void Game::reset() {
-    snake.reset();
-    snake2.reset();
-    currentItem.reset();
-    obstacles.clear();
+    sim.reset();
+    replaying = false;
     state = GameState::MENU;
     settingsSelection = 0;
     AudioSystem::getInstance().stopBackgroundMusic();
 }
 
+bool Game::startReplay(const Replay& replay) {
+    if (replay.tickCount == 0) {
+        return false;
+    }
+    
+    replayPlayer.open(replay);
+    replaying = true;
+    if (replay.config.versus) {
+        gameMode = GameMode::VERSUS;
+    } else {
+        gameMode = replay.config.itemCount > 1 ? GameMode::RUSH : GameMode::SINGLE;
+    }
+    init();
+    state = GameState::PLAYING;
+    showMessage("回放中  左/右键 快退/快进");
+    return true;
+}
+
 void Game::run() {
+    bool firstFrame = true;
     while (isRunning()) {
         float deltaTime = GetFrameTime();
         AudioSystem::getInstance().update();
         update(deltaTime);
         draw();
+
+        if (firstFrame) {
+            // 启动优化前后对比用
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin).count();
+            TraceLog(LOG_INFO, "STARTUP: 首帧用时 %.1f ms", ms);
+            firstFrame = false;
+        }
     }
 }
 
@@ -200,13 +243,13 @@ void Game::update(float deltaTime) {
 }
 
 void Game::updateMenu(float /* deltaTime */) {
-    // 现在菜单有4个选项：单人、双人、编辑器、设置
+    // 现在菜单有6个选项：单人、双人、道具冲刺、高分榜、编辑器、设置
     if (IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_S)) {
-        settingsSelection = (settingsSelection + 1) % 5;
+        settingsSelection = (settingsSelection + 1) % 6;
         AudioSystem::getInstance().play(SoundType::MENU_SELECT);
     }
     if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)) {
-        settingsSelection = (settingsSelection + 4) % 5;
+        settingsSelection = (settingsSelection + 5) % 6;
         AudioSystem::getInstance().play(SoundType::MENU_SELECT);
     }
 
@@ -235,154 +278,217 @@ void Game::updateMenu(float /* deltaTime */) {
                 state = GameState::PLAYING;
                 break;
             case 2:
-                state = GameState::HIGH_SCORES;
+                gameMode = GameMode::RUSH;
+                currentLevelData = levelManager->getCurrentLevel();
+                init();
+                state = GameState::PLAYING;
                 break;
             case 3:
-                levelEditor->newLevel("新关卡", GRID_WIDTH, GRID_HEIGHT);
-                state = GameState::LEVEL_EDITOR;
+                state = GameState::HIGH_SCORES;
                 break;
             case 4:
+                // 选中的是文件关卡就打开它继续编辑，否则新建
+                if (levelManager->getCurrentIndex() > 0) {
+                    levelEditor->loadLevel(levelManager->getCurrentLevel());
+                } else {
+                    levelEditor->newLevel("新关卡", DEFAULT_GRID_WIDTH, DEFAULT_GRID_HEIGHT);
+                }
+                state = GameState::LEVEL_EDITOR;
+                break;
+            case 5:
                 settingsSelection = 0;
                 state = GameState::SETTINGS;
                 break;
         }
     }
-}
-
-void Game::updatePlaying(float deltaTime) {
-    updateSpeedEffect(deltaTime);
     
-    if (currentItem) {
-        currentItem->update(deltaTime);
-        if (currentItem->isExpired()) {
-            spawnItem();
+    // R 观看上一局的回放
+    if (IsKeyPressed(KEY_R)) {
+        Replay replay;
+        if (replay.load(getReplayPath()) && startReplay(replay)) {
+            AudioSystem::getInstance().play(SoundType::PAUSE);
         }
     }
-    
-    // 玩家1输入
-    snake->updateDirection();
+}
 
-    // 玩家2输入（对战模式）
-    if (gameMode == GameMode::VERSUS && snake2) {
-        snake2->updateDirectionPlayer2();
+void Game::updatePlaying(float deltaTime) {
+    if (replaying) {
+        updateReplayControls();
+    } else {
+        readPlayerInput();
     }
     
+    // 累加器：每满一个移动间隔推进一个 tick，余下的时间保留，
+    // 所以实际 tick 频率与帧率无关，高速时一帧内也可以推进多个 tick
     moveTimer += deltaTime;
-    float interval = getCurrentMoveInterval();
     
-    if (moveTimer >= interval) {
-        moveTimer = 0;
-        updateSnakeMovement(*snake, score, lives, 1);
-
-        if (state != GameState::PLAYING) {
-            return;
+    int ticks = 0;
+    while (state == GameState::PLAYING && moveTimer >= sim->getMoveInterval()) {
+        if (ticks == MAX_TICKS_PER_FRAME) {
+            // 长时间卡顿（拖动窗口、断点）后丢弃积压，避免越追越慢
+            moveTimer = 0;
+            break;
         }
-
-        if (gameMode == GameMode::VERSUS && snake2) {
-            updateSnakeMovement(*snake2, score2, lives2, 2);
-
-            if (state != GameState::PLAYING) {
+        moveTimer -= sim->getMoveInterval();
+        ticks++;
+        
+        if (replaying) {
+            // 回放文件被截断时没有 GAME_OVER 事件，直接回到菜单
+            if (!replayPlayer.step(*sim)) {
+                reset();
                 return;
             }
-            
-            // 检查对战结束
-            if (score >= targetScore || score2 >= targetScore) {
-                state = GameState::GAME_OVER;
-                finalScore = score;
-                finalLength = snake->getLength();
-                AudioSystem::getInstance().stopBackgroundMusic();
-            }
+        } else {
+            sim->step(pendingInput);
+            recorder.record(pendingInput, *sim);
+            pendingInput = TickInput();
         }
+        handleSimEvents();
     }
 }
 
-void Game::updateSnakeMovement(Snake& snakeRef, int& playerScore, int& playerLives, int playerId) {
-    (void)playerScore;
-
-    auto resetSnakeForPlayer = [&]() {
-        int respawnX = (playerId == 1) ? GRID_WIDTH / 2 : GRID_WIDTH / 3;
-        int respawnY = (playerId == 1) ? GRID_HEIGHT / 2 : GRID_HEIGHT / 3;
-
-        if (currentLevelData.spawnPoints.size() >= static_cast<size_t>(playerId)) {
-            const Vector2& spawn = currentLevelData.spawnPoints[playerId - 1];
-            respawnX = static_cast<int>(spawn.x);
-            respawnY = static_cast<int>(spawn.y);
-        }
-
-        if (playerId == 1 && snake) {
-            snake->reset(respawnX, respawnY);
-        } else if (playerId == 2 && snake2) {
-            snake2->reset(respawnX, respawnY);
-        }
-    };
-
-    auto handleLifeLoss = [&](const char* lifeLossMsg) {
-        if (playerLives > 0) {
-            playerLives--;
-        }
+void Game::updateReplayControls() {
+    const bool forward = IsKeyPressed(KEY_RIGHT);
+    const bool backward = IsKeyPressed(KEY_LEFT);
+    if (!forward && !backward) return;
+    
+    const uint64_t tick = sim->getTick();
+    uint64_t target = 0;
+    if (forward) {
+        // 停在最后一个 tick 之前，让结束事件照常触发
+        const uint64_t last = replayPlayer.getTickCount() - 1;
+        target = std::min<uint64_t>(tick + REPLAY_SEEK_TICKS, last);
+    } else if (tick > static_cast<uint64_t>(REPLAY_SEEK_TICKS)) {
+        target = tick - REPLAY_SEEK_TICKS;
+    }
+    
+    replayPlayer.seek(*sim, target);
+    crateMesh.invalidateAll();  // 跳转前后碎掉的箱子不同
+    particles.clear();
+    moveTimer = 0;
+}
 
-        if (playerLives <= 0) {
-            playerLives = 0;
-            state = GameState::GAME_OVER;
-            finalScore = score;
-            finalLength = snake ? snake->getLength() : 0;
-            AudioSystem::getInstance().stopBackgroundMusic();
-            AudioSystem::getInstance().play(SoundType::GAME_OVER);
-            showMessage(playerId == 1 ? "P1 生命耗尽!" : "P2 生命耗尽!");
-            return;
+void Game::readPlayerInput() {
+    // 两次 tick 之间以最后一次有效按键为准；掉头在这里就过滤掉，
+    // 避免一次无效按键覆盖掉之前的有效转向
+    auto readTurn = [&](int player, int up, int down, int left, int right) {
+        const Snake* s = sim->getSnake(player);
+        if (!s) return;
+        Direction current = s->getDirection();
+        
+        struct { int key; Direction dir; TurnCommand cmd; } keys[] = {
+            {up, Direction::UP, TurnCommand::UP},
+            {down, Direction::DOWN, TurnCommand::DOWN},
+            {left, Direction::LEFT, TurnCommand::LEFT},
+            {right, Direction::RIGHT, TurnCommand::RIGHT},
+        };
+        for (const auto& k : keys) {
+            if (IsKeyPressed(k.key) && !Snake::isOpposite(current, k.dir)) {
+                pendingInput.turns[player] = k.cmd;
+            }
         }
-
-        resetSnakeForPlayer();
-        showMessage(lifeLossMsg);
     };
-
-    bool alive = snakeRef.move();
-    Position newHead = snakeRef.getHead();
     
-    if (!alive) {
-        screenShake.start(10.0f, 0.3f);
-        AudioSystem::getInstance().play(SoundType::COLLISION);
-        
-        Vector2 hitPos = {newHead.x * GRID_SIZE + GRID_SIZE / 2.0f, newHead.y * GRID_SIZE + GRID_SIZE / 2.0f};
-        particles.emitExplosion(hitPos, (playerId == 1) ? BLUE : RED, 50);
-        handleLifeLoss(playerId == 1 ? "P1 失去一条生命!" : "P2 失去一条生命!");
-        return;
-    }
+    // 玩家1 - WASD
+    readTurn(0, KEY_W, KEY_S, KEY_A, KEY_D);
     
-    if (obstacles.checkCollision(newHead.x, newHead.y)) {
-        screenShake.start(10.0f, 0.3f);
-        AudioSystem::getInstance().play(SoundType::COLLISION);
-        handleLifeLoss(playerId == 1 ? "撞墙了! 失去一条生命!" : "P2 撞墙了!");
-        return;
+    // 玩家2 - 方向键（对战模式）
+    if (gameMode == GameMode::VERSUS) {
+        readTurn(1, KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT);
     }
+}
+
+void Game::handleSimEvents() {
+    AudioSystem& audio = AudioSystem::getInstance();
     
-    if (currentItem && newHead.x == currentItem->getX() && newHead.y == currentItem->getY()) {
-        currentItem->onEat(snakeRef, *this);
-        showMessage((playerId == 1 ? "P1 " : "P2 ") + std::string("吃到") + currentItem->getName() + "!");
+    auto cellCenter = [](int x, int y) -> Vector2 {
+        return {x * GRID_SIZE + GRID_SIZE / 2.0f, y * GRID_SIZE + GRID_SIZE / 2.0f};
+    };
+    
+    for (const SimEvent& e : sim->getEvents()) {
+        const bool isP1 = (e.player == 0);
         
-        switch (currentItem->getType()) {
-            case ItemType::NORMAL: AudioSystem::getInstance().play(SoundType::EAT_NORMAL); break;
-            case ItemType::GOLDEN: AudioSystem::getInstance().play(SoundType::EAT_GOLDEN); break;
-            case ItemType::SPEED_UP: AudioSystem::getInstance().play(SoundType::EAT_SPEED); break;
-            case ItemType::SLOW_DOWN: AudioSystem::getInstance().play(SoundType::EAT_SLOW); break;
+        switch (e.type) {
+            case SimEventType::MOVED:
+                particles.emitTrail(cellCenter(e.x, e.y), Fade(isP1 ? GREEN : ORANGE, 0.5f));
+                break;
+                
+            case SimEventType::ITEM_EATEN: {
+                showMessage((isP1 ? "P1 " : "P2 ") + std::string("吃到") + getItemTypeName(e.item) + "!");
+                // 蛇越长音调越高：每 4 节升一个半音，最多升一个八度
+                int semitones = std::min(sim->getSnake(e.player)->getLength() / 4, 12);
+                float pitch = powf(2.0f, semitones / 12.0f);
+                switch (e.item) {
+                    case ItemType::NORMAL: audio.play(SoundType::EAT_NORMAL, pitch); break;
+                    case ItemType::GOLDEN: audio.play(SoundType::EAT_GOLDEN, pitch); break;
+                    case ItemType::SPEED_UP: audio.play(SoundType::EAT_SPEED, pitch); break;
+                    case ItemType::SLOW_DOWN: audio.play(SoundType::EAT_SLOW, pitch); break;
+                }
+                particles.emitExplosion(cellCenter(e.x, e.y), getItemColor(e.item), 30);
+                screenShake.start(3.0f, 0.1f);
+                break;
+            }
+                
+            case SimEventType::COLLISION:
+                screenShake.start(10.0f, 0.3f);
+                audio.play(SoundType::COLLISION);
+                if (e.blocker == CellOwner::WALL) {
+                    showMessage(isP1 ? "撞墙了! 失去一条生命!" : "P2 撞墙了!");
+                } else {
+                    particles.emitExplosion(cellCenter(e.x, e.y), isP1 ? BLUE : RED, 50);
+                    showMessage(isP1 ? "P1 失去一条生命!" : "P2 失去一条生命!");
+                }
+                break;
+                
+            case SimEventType::TILE_DAMAGED:
+                // 耐久画在格子上，直接查图层，几何不用重建
+                audio.play(SoundType::COLLISION, 1.5f);
+                screenShake.start(2.0f, 0.1f);
+                break;
+                
+            case SimEventType::TILE_DESTROYED:
+                crateMesh.invalidateCell(e.x, e.y);
+                audio.play(SoundType::COLLISION, 0.8f);
+                particles.emitExplosion(cellCenter(e.x, e.y), BROWN, 30);
+                screenShake.start(4.0f, 0.15f);
+                break;
+                
+            case SimEventType::EXTRA_LIFE:
+                showMessage("奖励生命!");
+                audio.play(SoundType::EXTRA_LIFE);
+                break;
+                
+            case SimEventType::GAME_OVER:
+                if (!replaying) {
+                    recorder.finish(*sim);
+                    saveReplay();
+                }
+                state = GameState::GAME_OVER;
+                {
+                    // 对战模式记分数较高的一方
+                    const int best = (sim->getConfig().versus && sim->getScore(1) > sim->getScore(0)) ? 1 : 0;
+                    finalScore = sim->getScore(best);
+                    finalLength = sim->getSnake(best)->getLength();
+                }
+                if (!replaying) {
+                    // 每局都进历史：上榜的等输入名字后再写，没上榜的用默认名字立即写
+                    if (finalScore > 0 &&
+                        highScoreManager.isHighScore(getScoreBoardLevel(), static_cast<uint8_t>(gameMode), finalScore)) {
+                        state = GameState::ENTER_NAME;
+                        resultPending = true;
+                    } else {
+                        recordResult(DEFAULT_PLAYER_NAME, false);
+                    }
+                }
+                audio.stopBackgroundMusic();
+                if (e.player >= 0) {
+                    // 生命耗尽（对战达到目标分数时不播放失败音效）
+                    audio.play(SoundType::GAME_OVER);
+                    showMessage(isP1 ? "P1 生命耗尽!" : "P2 生命耗尽!");
+                }
+                break;
         }
-        
-        Vector2 particlePos = {
-            currentItem->getX() * GRID_SIZE + GRID_SIZE / 2.0f,
-            currentItem->getY() * GRID_SIZE + GRID_SIZE / 2.0f
-        };
-        particles.emitExplosion(particlePos, currentItem->getColor(), 30);
-        screenShake.start(3.0f, 0.1f);
-        
-        spawnItem();
-        checkExtraLife();
     }
-    
-    Vector2 trailPos = {
-        newHead.x * GRID_SIZE + GRID_SIZE / 2.0f,
-        newHead.y * GRID_SIZE + GRID_SIZE / 2.0f
-    };
-    particles.emitTrail(trailPos, Fade((playerId == 1) ? GREEN : ORANGE, 0.5f));
 }
 
 void Game::updatePaused(float /* deltaTime */) {
@@ -393,6 +499,13 @@ void Game::updatePaused(float /* deltaTime */) {
 }
 
 void Game::updateGameOver(float /* deltaTime */) {
+    // R 从头观看本局回放
+    if (IsKeyPressed(KEY_R)) {
+        Replay replay = replaying ? replayPlayer.getReplay() : recorder.getReplay();
+        startReplay(replay);
+        return;
+    }
+    
     if (IsKeyPressed(KEY_ENTER)) {
         reset();
         state = GameState::MENU;
@@ -405,6 +518,17 @@ void Game::updateSettings(float /* deltaTime */) {
 }
 
 void Game::updateHighScores(float /* deltaTime */) {
+    // 左右键在单人/对战/道具冲刺榜单之间切换
+    if (IsKeyPressed(KEY_RIGHT)) {
+        scoreBoardMode = (scoreBoardMode == GameMode::SINGLE) ? GameMode::VERSUS
+                       : (scoreBoardMode == GameMode::VERSUS) ? GameMode::RUSH : GameMode::SINGLE;
+        AudioSystem::getInstance().play(SoundType::MENU_SELECT);
+    }
+    if (IsKeyPressed(KEY_LEFT)) {
+        scoreBoardMode = (scoreBoardMode == GameMode::SINGLE) ? GameMode::RUSH
+                       : (scoreBoardMode == GameMode::RUSH) ? GameMode::VERSUS : GameMode::SINGLE;
+        AudioSystem::getInstance().play(SoundType::MENU_SELECT);
+    }
     if (IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_ESCAPE)) {
         state = GameState::MENU;
         settingsSelection = 0;
@@ -422,9 +546,7 @@ void Game::updateEnterName(float /* deltaTime */) {
     }
     
     if (IsKeyPressed(KEY_ENTER) && !playerName.empty()) {
-        HighScoreEntry entry(playerName, finalScore, finalLength);
-        highScoreManager.addEntry(entry);
-        highScore = highScoreManager.getHighestScore();
+        saveHighScore();
         state = GameState::GAME_OVER;
     }
 }
@@ -436,11 +558,12 @@ void Game::updateLevelEditor(float /* deltaTime */) {
     // Ctrl+S 保存
     if ((IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_LEFT_SUPER)) && IsKeyPressed(KEY_S)) {
         LevelData data = levelEditor->getLevel();
-        std::string filename = "level_" + std::to_string(time(nullptr)) + ".json";
+        std::string filename = "level_" + std::to_string(time(nullptr)) + ".lvl";
         if (levelManager->saveLevel(data, filename)) {
             levelEditor->markSaved();
-            levelManager->loadAllLevels();
-            levelManager->setCurrentLevel(levelManager->getLevelCount() - 1);
+            // 保存时已增量刷新索引，选中刚保存的关卡（文件无效时不在索引里）
+            int saved = levelManager->findLevel(filename);
+            if (saved >= 0) levelManager->setCurrentLevel(saved);
             showMessage("关卡已保存!");
         }
     }
@@ -451,16 +574,6 @@ void Game::updateLevelEditor(float /* deltaTime */) {
     }
 }
 
-void Game::updateSpeedEffect(float deltaTime) {
-    if (speedEffect.active) {
-        speedEffect.remaining -= deltaTime;
-        if (speedEffect.remaining <= 0) {
-            speedEffect.active = false;
-            speedEffect.multiplier = 1.0f;
-        }
-    }
-}
-
 void Game::handleInput() {
     if (IsKeyPressed(KEY_P) || IsKeyPressed(KEY_SPACE)) {
         if (state == GameState::PLAYING) {
@@ -502,8 +615,10 @@ void Game::handleSettingsInput() {
     
     Settings& s = settingsManager.get();
     AudioSystem& audio = AudioSystem::getInstance();
+    bool changed = false;
     
     if (IsKeyPressed(KEY_LEFT) || IsKeyPressed(KEY_A)) {
+        changed = settingsSelection <= 3;
         switch (settingsSelection) {
             case 0:
                 s.masterVolume = fmaxf(0.0f, s.masterVolume - 0.1f);
@@ -527,6 +642,7 @@ void Game::handleSettingsInput() {
     }
     
     if (IsKeyPressed(KEY_RIGHT) || IsKeyPressed(KEY_D)) {
+        changed = settingsSelection <= 3;
         switch (settingsSelection) {
             case 0:
                 s.masterVolume = fminf(1.0f, s.masterVolume + 0.1f);
@@ -549,15 +665,19 @@ void Game::handleSettingsInput() {
         }
     }
     
+    if (IsKeyPressed(KEY_M)) {
+        s.muted = !s.muted;
+        audio.mute(s.muted);
+        changed = true;
+    }
+    
+    // 写盘在后台进行：连续调节时只在停下来后写一次，离开菜单时立即写
     if (IsKeyPressed(KEY_ENTER) && settingsSelection == 4) {
         settingsManager.save();
         state = GameState::MENU;
         settingsSelection = 0;
-    }
-    
-    if (IsKeyPressed(KEY_M)) {
-        s.muted = !s.muted;
-        audio.mute(s.muted);
+    } else if (changed) {
+        settingsManager.requestSave();
     }
 }
 
@@ -595,63 +715,77 @@ void Game::draw() {
     }
     
     EndDrawing();
+    textCache.endFrame();
 }
 
 void Game::drawMenu() {
     auto drawTextCentered = [&](const char* text, float y, float size, Color color) {
-        Vector2 sz = MeasureTextEx(uiFont, text, size, 1.0f);
-        DrawTextEx(uiFont, text, {(SCREEN_WIDTH - sz.x) * 0.5f, y}, size, 1.0f, color);
+        Vector2 sz = textCache.measure(uiFont, text, size, 1.0f);
+        textCache.draw(uiFont, text, {(SCREEN_WIDTH - sz.x) * 0.5f, y}, size, 1.0f, color);
     };
     
     drawTextCentered("贪吃蛇", 60, 60, DARKGREEN);
     drawTextCentered("v4-multi", 130, 30, GREEN);
     
-    const char* options[] = {"单人模式", "双人对战", "高分榜", "关卡编辑器", "设置"};
-    float startY = 200;
-    float gap = 50;
+    const char* options[] = {"单人模式", "双人对战", "道具冲刺", "高分榜", "关卡编辑器", "设置"};
+    float startY = 190;
+    float gap = 42;
     
-    for (int i = 0; i < 5; i++) {
+    for (int i = 0; i < 6; i++) {
         Color color = (i == settingsSelection) ? DARKGREEN : GRAY;
         float size = (i == settingsSelection) ? 30 : 25;
         drawTextCentered(options[i], startY + i * gap, size, color);
     }
 
-    const LevelData& selectedLevel = levelManager->getCurrentLevel();
+    // 只用索引里的名称，切换关卡时不读墙壁
+    const LevelInfo& selectedLevel = levelManager->getCurrentInfo();
     drawTextCentered(
-        TextFormat("当前关卡: %s (%d/%d)", selectedLevel.name.c_str(),
+        TextFormat("当前关卡: %s %dx%d (%d/%d)", selectedLevel.name.c_str(),
+                   selectedLevel.width, selectedLevel.height,
                    levelManager->getCurrentIndex() + 1, levelManager->getLevelCount()),
         450, 20, DARKBLUE);
     
-    if (highScore > 0) {
-        drawTextCentered(TextFormat("最高分: %d", highScore), 480, 20, GOLD);
+    // 选中关卡单人模式的最高分
+    const int levelBest = highScoreManager.getHighestScore(selectedLevel.file, static_cast<uint8_t>(GameMode::SINGLE));
+    if (levelBest > 0) {
+        drawTextCentered(TextFormat("最高分: %d", levelBest), 480, 20, GOLD);
     }
     
-    drawTextCentered("左右键切换关卡  |  上下键选择模式  |  ENTER 确认", 540, 16, DARKGRAY);
+    drawTextCentered("左右键切换关卡  |  上下键选择模式  |  ENTER 确认  |  R 上一局回放", 540, 16, DARKGRAY);
 }
 
 void Game::drawPlaying() {
+    updateCamera();
+    
     if (screenShake.isActive()) {
         Vector2 offset = screenShake.getOffset();
         BeginScissorMode(static_cast<int>(offset.x), static_cast<int>(offset.y), SCREEN_WIDTH, SCREEN_HEIGHT);
     }
     
-    drawGrid();
-    particles.draw();
-    obstacles.draw(GRID_SIZE);
-    if (currentItem) currentItem->draw(GRID_SIZE);
-    
-    // 绘制蛇（不同颜色）
-    if (snake) snake->draw(GRID_SIZE);
-    if (snake2) {
-        // 临时修改颜色绘制第二条蛇
-        for (size_t i = 0; i < snake2->getBody().size(); i++) {
-            const auto& pos = snake2->getBody()[i];
-            Color color = (i == 0) ? DARKBLUE : BLUE;
-            int padding = (i == 0) ? 1 : 2;
-            DrawRectangle(pos.x * GRID_SIZE + padding, pos.y * GRID_SIZE + padding,
-                        GRID_SIZE - padding * 2, GRID_SIZE - padding * 2, color);
+    // 地图按世界坐标绘制，只画相机可见的格子和块
+    int x0, y0, x1, y1;
+    camera.getVisibleCells(x0, y0, x1, y1);
+    BeginMode2D(camera.get());
+    drawGrid(x0, y0, x1, y1);
+    if (sim) drawObstacles(x0, y0, x1, y1);
+    
+    // 可见区域外的粒子不提交
+    particleRenderer.draw(particles, camera.getVisibleWorld());
+    
+    if (sim) {
+        // 道具冲刺模式同屏几十个道具，只画可见的
+        for (const Item& item : sim->getItems()) {
+            if (item.getX() >= x0 && item.getX() <= x1 && item.getY() >= y0 && item.getY() <= y1) {
+                drawItem(item);
+            }
         }
+        
+        // 绘制蛇（不同颜色），在上一个 tick 和当前 tick 之间插值
+        float alpha = getTickAlpha();
+        if (sim->getSnake(0)) drawSnake(*sim->getSnake(0), DARKGREEN, GREEN, alpha);
+        if (sim->getSnake(1)) drawSnake(*sim->getSnake(1), DARKBLUE, BLUE, alpha);
     }
+    EndMode2D();
     
     drawUI();
     drawMessage();
@@ -662,6 +796,11 @@ void Game::drawPlaying() {
     
     if (settingsManager.get().showFPS) {
         DrawFPS(SCREEN_WIDTH - 80, SCREEN_HEIGHT - 30);
+        // 数字每帧都在变，不走缓存
+        DrawTextEx(uiFont, TextFormat("粒子: %d  批次≈%d",
+                                      static_cast<int>(particleRenderer.getQuadCount()),
+                                      particleRenderer.getEstimatedBatches()),
+                   {SCREEN_WIDTH - 220.0f, SCREEN_HEIGHT - 55.0f}, 18, 1.0f, DARKGRAY);
     }
 }
 
@@ -669,8 +808,8 @@ void Game::drawPaused() {
     DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(BLACK, 0.5f));
     
     auto drawTextCentered = [&](const char* text, float y, float size, Color color) {
-        Vector2 sz = MeasureTextEx(uiFont, text, size, 1.0f);
-        DrawTextEx(uiFont, text, {(SCREEN_WIDTH - sz.x) * 0.5f, y}, size, 1.0f, color);
+        Vector2 sz = textCache.measure(uiFont, text, size, 1.0f);
+        textCache.draw(uiFont, text, {(SCREEN_WIDTH - sz.x) * 0.5f, y}, size, 1.0f, color);
     };
     
     drawTextCentered("暂 停", 250, 50, WHITE);
@@ -682,11 +821,13 @@ void Game::drawGameOver() {
     DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(BLACK, 0.7f));
     
     auto drawTextCentered = [&](const char* text, float y, float size, Color color) {
-        Vector2 sz = MeasureTextEx(uiFont, text, size, 1.0f);
-        DrawTextEx(uiFont, text, {(SCREEN_WIDTH - sz.x) * 0.5f, y}, size, 1.0f, color);
+        Vector2 sz = textCache.measure(uiFont, text, size, 1.0f);
+        textCache.draw(uiFont, text, {(SCREEN_WIDTH - sz.x) * 0.5f, y}, size, 1.0f, color);
     };
     
     if (gameMode == GameMode::VERSUS) {
+        const int score = sim ? sim->getScore(0) : 0;
+        const int score2 = sim ? sim->getScore(1) : 0;
         drawTextCentered("对战结束", 140, 50, RED);
         drawTextCentered(TextFormat("P1 分数: %d", score), 210, 28, BLUE);
         drawTextCentered(TextFormat("P2 分数: %d", score2), 250, 28, RED);
@@ -708,13 +849,13 @@ void Game::drawGameOver() {
         }
     }
     
-    drawTextCentered("按 ENTER 返回菜单", 400, 20, LIGHTGRAY);
+    drawTextCentered("按 ENTER 返回菜单  |  按 R 观看回放", 400, 20, LIGHTGRAY);
 }
 
 void Game::drawSettings() {
     auto drawTextCentered = [&](const char* text, float y, float size, Color color) {
-        Vector2 sz = MeasureTextEx(uiFont, text, size, 1.0f);
-        DrawTextEx(uiFont, text, {(SCREEN_WIDTH - sz.x) * 0.5f, y}, size, 1.0f, color);
+        Vector2 sz = textCache.measure(uiFont, text, size, 1.0f);
+        textCache.draw(uiFont, text, {(SCREEN_WIDTH - sz.x) * 0.5f, y}, size, 1.0f, color);
     };
     
     drawTextCentered("设 置", 60, 50, DARKGREEN);
@@ -733,9 +874,9 @@ void Game::drawSettings() {
     const char* diffStr = (s.difficulty == Settings::Difficulty::EASY) ? "简单" :
                           (s.difficulty == Settings::Difficulty::NORMAL) ? "普通" : "困难";
     Color diffColor = (settingsSelection == 3) ? DARKGREEN : BLACK;
-    DrawTextEx(uiFont, "难度", {100, y}, 25, 1.0f, diffColor);
-    Vector2 valSize = MeasureTextEx(uiFont, diffStr, 25, 1.0f);
-    DrawTextEx(uiFont, diffStr, {350 - valSize.x * 0.5f, y}, 25, 1.0f, diffColor);
+    textCache.draw(uiFont, "难度", {100, y}, 25, 1.0f, diffColor);
+    Vector2 valSize = textCache.measure(uiFont, diffStr, 25, 1.0f);
+    textCache.draw(uiFont, diffStr, {350 - valSize.x * 0.5f, y}, 25, 1.0f, diffColor);
     y += gap;
     
     Color backColor = (settingsSelection == 4) ? DARKGREEN : GRAY;
@@ -752,13 +893,20 @@ void Game::drawSettings() {
 
 void Game::drawHighScores() {
     auto drawTextCentered = [&](const char* text, float y, float size, Color color) {
-        Vector2 sz = MeasureTextEx(uiFont, text, size, 1.0f);
-        DrawTextEx(uiFont, text, {(SCREEN_WIDTH - sz.x) * 0.5f, y}, size, 1.0f, color);
+        Vector2 sz = textCache.measure(uiFont, text, size, 1.0f);
+        textCache.draw(uiFont, text, {(SCREEN_WIDTH - sz.x) * 0.5f, y}, size, 1.0f, color);
     };
     
-    drawTextCentered("高分榜", 60, 50, GOLD);
+    drawTextCentered("高分榜", 40, 50, GOLD);
+    
+    // 每个关卡、每种模式各有一个榜单
+    const LevelInfo& level = levelManager->getCurrentInfo();
+    drawTextCentered(TextFormat("%s  ·  %s", level.name.c_str(),
+                                scoreBoardMode == GameMode::VERSUS ? "双人对战"
+                                : scoreBoardMode == GameMode::RUSH ? "道具冲刺" : "单人模式"),
+                     100, 20, DARKBLUE);
     
-    const auto& entries = highScoreManager.getEntries();
+    const auto& entries = highScoreManager.getEntries(level.file, static_cast<uint8_t>(scoreBoardMode));
     float y = 130;
     
     if (entries.empty()) {
@@ -769,27 +917,28 @@ void Game::drawHighScores() {
             Color color = (i < 3) ? GOLD : DARKGRAY;
             
             const char* rankText = TextFormat("%d.", static_cast<int>(i) + 1);
-            DrawTextEx(uiFont, rankText, {150, y}, 25, 1.0f, color);
-            DrawTextEx(uiFont, e.name.c_str(), {200, y}, 25, 1.0f, BLACK);
+            textCache.draw(uiFont, rankText, {150, y}, 25, 1.0f, color);
+            textCache.draw(uiFont, e.name.c_str(), {200, y}, 25, 1.0f, BLACK);
             
             const char* scoreText = TextFormat("%d", e.score);
-            Vector2 scoreSize = MeasureTextEx(uiFont, scoreText, 25, 1.0f);
-            DrawTextEx(uiFont, scoreText, {500 - scoreSize.x, y}, 25, 1.0f, color);
-            DrawTextEx(uiFont, e.date.c_str(), {520, y}, 20, 1.0f, GRAY);
+            Vector2 scoreSize = textCache.measure(uiFont, scoreText, 25, 1.0f);
+            textCache.draw(uiFont, scoreText, {500 - scoreSize.x, y}, 25, 1.0f, color);
+            textCache.draw(uiFont, e.date.c_str(), {520, y}, 20, 1.0f, GRAY);
             
             y += 40;
         }
     }
     
-    drawTextCentered("按 ENTER 或 ESC 返回", 550, 18, DARKGRAY);
+    drawTextCentered(TextFormat("历史记录 %d 条", static_cast<int>(highScoreManager.getTotalRecords())), 525, 16, GRAY);
+    drawTextCentered("左右键切换模式  |  按 ENTER 或 ESC 返回", 550, 18, DARKGRAY);
 }
 
 void Game::drawEnterName() {
     DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(BLACK, 0.8f));
     
     auto drawTextCentered = [&](const char* text, float y, float size, Color color) {
-        Vector2 sz = MeasureTextEx(uiFont, text, size, 1.0f);
-        DrawTextEx(uiFont, text, {(SCREEN_WIDTH - sz.x) * 0.5f, y}, size, 1.0f, color);
+        Vector2 sz = textCache.measure(uiFont, text, size, 1.0f);
+        textCache.draw(uiFont, text, {(SCREEN_WIDTH - sz.x) * 0.5f, y}, size, 1.0f, color);
     };
     
     drawTextCentered("新纪录!", 150, 40, GOLD);
@@ -797,8 +946,8 @@ void Game::drawEnterName() {
     drawTextCentered("输入你的名字:", 280, 25, LIGHTGRAY);
     
     const char* nameText = playerName.empty() ? "_" : playerName.c_str();
-    Vector2 nameSize = MeasureTextEx(uiFont, nameText, 40, 1.0f);
-    DrawTextEx(uiFont, nameText, {(SCREEN_WIDTH - nameSize.x) * 0.5f, 330}, 40, 1.0f, WHITE);
+    Vector2 nameSize = textCache.measure(uiFont, nameText, 40, 1.0f);
+    textCache.draw(uiFont, nameText, {(SCREEN_WIDTH - nameSize.x) * 0.5f, 330}, 40, 1.0f, WHITE);
     
     drawTextCentered("按 ENTER 确认", 420, 20, LIGHTGRAY);
     drawTextCentered("按 BACKSPACE 删除", 450, 16, GRAY);
@@ -808,7 +957,7 @@ void Game::drawVolumeBar(const char* label, float x, float y, float width, float
     Color labelColor = selected ? DARKGREEN : BLACK;
     Color barColor = selected ? GREEN : LIGHTGRAY;
     
-    DrawTextEx(uiFont, label, {x, y}, 25, 1.0f, labelColor);
+    textCache.draw(uiFont, label, {x, y}, 25, 1.0f, labelColor);
     
     float barX = x + 150;
     float barHeight = 20;
@@ -816,42 +965,172 @@ void Game::drawVolumeBar(const char* label, float x, float y, float width, float
     DrawRectangle(static_cast<int>(barX), static_cast<int>(y + 5), static_cast<int>(width * value), static_cast<int>(barHeight), barColor);
     
     const char* valText = TextFormat("%d%%", static_cast<int>(value * 100));
-    DrawTextEx(uiFont, valText, {barX + width + 10, y}, 20, 1.0f, labelColor);
+    textCache.draw(uiFont, valText, {barX + width + 10, y}, 20, 1.0f, labelColor);
+}
+
+void Game::rebuildBoard() {
+    if (!sim) return;
+    const OccupancyGrid& grid = sim->getGrid();
+    const ObstacleManager& obstacles = sim->getObstacles();
+    boardMesh.reset(obstacles.getChunksX(), obstacles.getChunksY());
+    crateMesh.reset(obstacles.getChunksX(), obstacles.getChunksY());
+
+    camera.setViewport({0.0f, 0.0f, static_cast<float>(SCREEN_WIDTH), static_cast<float>(SCREEN_HEIGHT)});
+    camera.setBoard(grid.getWidth(), grid.getHeight());
+    updateCamera();
+}
+
+void Game::updateCamera() {
+    if (!sim || !sim->getSnake(0)) return;
+
+    // 跟随蛇头的插值位置，对战时取两条蛇头的中点；地图不比窗口大时相机不动
+    float alpha = getTickAlpha();
+    Vector2 focus = {0.0f, 0.0f};
+    int count = 0;
+    for (int p = 0; p < 2; p++) {
+        const Snake* snake = sim->getSnake(p);
+        if (!snake) continue;
+        Position from = snake->getPrevPosition(0);
+        Position to = snake->getBody()[0];
+        focus.x += from.x + (to.x - from.x) * alpha;
+        focus.y += from.y + (to.y - from.y) * alpha;
+        count++;
+    }
+    camera.centerOn({(focus.x / count + 0.5f) * GRID_SIZE, (focus.y / count + 0.5f) * GRID_SIZE});
 }
 
-void Game::drawGrid() {
-    for (int i = 0; i < GRID_WIDTH; i++) {
-        for (int j = 0; j < GRID_HEIGHT; j++) {
-            Color color = ((i + j) % 2 == 0) ? Fade(GREEN, 0.1f) : Fade(GREEN, 0.05f);
-            DrawRectangle(i * GRID_SIZE, j * GRID_SIZE, GRID_SIZE, GRID_SIZE, color);
+void Game::drawGrid(int x0, int y0, int x1, int y1) {
+    // 可见范围一次绘制：源矩形以格子为单位，超出 2x2 纹理的部分按重复平铺，
+    // 缩放和地图大小都不影响绘制次数
+    const float w = static_cast<float>(x1 - x0 + 1);
+    const float h = static_cast<float>(y1 - y0 + 1);
+    const float cell = static_cast<float>(GRID_SIZE);
+    Rectangle source = {static_cast<float>(x0), static_cast<float>(y0), w, h};
+    Rectangle dest = {x0 * cell, y0 * cell, w * cell, h * cell};
+    DrawTexturePro(checkerTexture, source, dest, {0.0f, 0.0f}, 0.0f, WHITE);
+}
+
+void Game::drawObstacles(int x0, int y0, int x1, int y1) {
+    const ObstacleManager& obstacles = sim->getObstacles();
+    
+    // 相邻的墙壁已按块合并成矩形，每个矩形画一次立体边框
+    boardMesh.forEachRect(obstacles.view(TileType::WALL), x0, y0, x1, y1, [](const Rectangle& r) {
+        const int px = static_cast<int>(r.x) * GRID_SIZE;
+        const int py = static_cast<int>(r.y) * GRID_SIZE;
+        const int w = static_cast<int>(r.width) * GRID_SIZE;
+        const int h = static_cast<int>(r.height) * GRID_SIZE;
+        
+        // 绘制墙壁 - 使用灰色和深灰色营造立体感
+        DrawRectangle(px + 1, py + 1, w - 2, h - 2, GRAY);
+        
+        // 高光
+        DrawLine(px + 2, py + 2, px + w - 3, py + 2, LIGHTGRAY);
+        DrawLine(px + 2, py + 2, px + 2, py + h - 3, LIGHTGRAY);
+        
+        // 阴影
+        DrawLine(px + w - 3, py + 3, px + w - 3, py + h - 3, DARKGRAY);
+        DrawLine(px + 3, py + h - 3, px + w - 3, py + h - 3, DARKGRAY);
+    });
+
+    // 箱子逐格画，颜色随剩余耐久变浅
+    crateMesh.forEachRect(obstacles.view(TileType::CRATE), x0, y0, x1, y1, [&](const Rectangle& r) {
+        for (int y = static_cast<int>(r.y); y < static_cast<int>(r.y + r.height); y++) {
+            for (int x = static_cast<int>(r.x); x < static_cast<int>(r.x + r.width); x++) {
+                const int px = x * GRID_SIZE;
+                const int py = y * GRID_SIZE;
+                const int hp = obstacles.getHitPoints(x, y);
+                const float health = std::min(1.0f, static_cast<float>(hp) / ObstacleManager::CRATE_HIT_POINTS);
+
+                DrawRectangle(px + 2, py + 2, GRID_SIZE - 4, GRID_SIZE - 4, Fade(BROWN, 0.4f + 0.6f * health));
+                DrawRectangleLines(px + 2, py + 2, GRID_SIZE - 4, GRID_SIZE - 4, DARKBROWN);
+                DrawLine(px + 3, py + 3, px + GRID_SIZE - 3, py + GRID_SIZE - 3, DARKBROWN);
+                if (hp < ObstacleManager::CRATE_HIT_POINTS) {
+                    DrawLine(px + GRID_SIZE - 3, py + 3, px + 3, py + GRID_SIZE - 3, DARKBROWN);
+                }
+            }
         }
+    });
+}
+
+void Game::drawItem(const Item& item) {
+    int x = item.getX();
+    int y = item.getY();
+    
+    if (item.getType() == ItemType::GOLDEN) {
+        // 金色食物闪烁效果
+        float flash = (sinf(static_cast<float>(GetTime()) * 10) + 1.0f) * 0.5f; // 0~1 闪烁
+        Color c = ColorAlpha(GOLD, 0.7f + flash * 0.3f);
+        
+        // 外圈
+        DrawRectangle(x * GRID_SIZE + 1, y * GRID_SIZE + 1, GRID_SIZE - 2, GRID_SIZE - 2, c);
+        // 内圈
+        DrawRectangle(x * GRID_SIZE + 4, y * GRID_SIZE + 4, GRID_SIZE - 8, GRID_SIZE - 8, WHITE);
+        return;
+    }
+    
+    DrawRectangle(x * GRID_SIZE + 2, y * GRID_SIZE + 2, GRID_SIZE - 4, GRID_SIZE - 4,
+                  getItemColor(item.getType()));
+}
+
+float Game::getTickAlpha() const {
+    if (!sim) return 1.0f;
+    float alpha = moveTimer / sim->getMoveInterval();
+    return alpha < 1.0f ? alpha : 1.0f;
+}
+
+void Game::drawSnake(const Snake& snakeRef, Color headColor, Color bodyColor, float alpha) {
+    // 顺序遍历环形缓冲区，内存访问是连续的；大地图上看不见的身体不画
+    const SnakeBody& body = snakeRef.getBody();
+    const Rectangle view = camera.getVisibleWorld();
+    for (int i = 0; i < snakeRef.getLength(); i++) {
+        const bool isHead = (i == 0);
+        Color color = isHead ? headColor : bodyColor;
+        
+        // 每一节从上一个 tick 的位置滑向当前位置（高刷新率下移动连续）
+        Position from = snakeRef.getPrevPosition(i);
+        Position to = body[i];
+        float x = from.x + (to.x - from.x) * alpha;
+        float y = from.y + (to.y - from.y) * alpha;
+        
+        Rectangle cell = {x * GRID_SIZE, y * GRID_SIZE, static_cast<float>(GRID_SIZE), static_cast<float>(GRID_SIZE)};
+        if (!CheckCollisionRecs(view, cell)) continue;
+        
+        // 蛇头稍微大一点
+        float padding = isHead ? 1.0f : 2.0f;
+        DrawRectangleRec({cell.x + padding, cell.y + padding,
+                          GRID_SIZE - padding * 2, GRID_SIZE - padding * 2}, color);
     }
 }
 
 void Game::drawUI() {
+    if (!sim) return;
+    const int score = sim->getScore(0);
+    const int lives = sim->getLives(0);
+    const SpeedEffect& speedEffect = sim->getSpeedEffect();
+    
     if (gameMode == GameMode::VERSUS) {
         // 双人模式UI
         const char* p1Text = TextFormat("P1 分数: %d", score);
-        DrawTextEx(uiFont, p1Text, {10.0f, 10.0f}, 22, 1.0f, BLUE);
-        DrawTextEx(uiFont, TextFormat("生命: %d", lives), {10.0f, 40.0f}, 18, 1.0f, BLUE);
+        textCache.draw(uiFont, p1Text, {10.0f, 10.0f}, 22, 1.0f, BLUE);
+        textCache.draw(uiFont, TextFormat("生命: %d", lives), {10.0f, 40.0f}, 18, 1.0f, BLUE);
         
-        const char* p2Text = TextFormat("P2 分数: %d", score2);
-        Vector2 p2Size = MeasureTextEx(uiFont, p2Text, 22, 1.0f);
-        DrawTextEx(uiFont, p2Text, {SCREEN_WIDTH - 10.0f - p2Size.x, 10.0f}, 22, 1.0f, RED);
-        DrawTextEx(uiFont, TextFormat("生命: %d", lives2), {SCREEN_WIDTH - 80.0f, 40.0f}, 18, 1.0f, RED);
+        const char* p2Text = TextFormat("P2 分数: %d", sim->getScore(1));
+        Vector2 p2Size = textCache.measure(uiFont, p2Text, 22, 1.0f);
+        textCache.draw(uiFont, p2Text, {SCREEN_WIDTH - 10.0f - p2Size.x, 10.0f}, 22, 1.0f, RED);
+        textCache.draw(uiFont, TextFormat("生命: %d", sim->getLives(1)), {SCREEN_WIDTH - 80.0f, 40.0f}, 18, 1.0f, RED);
         
         // 目标分数
-        const char* targetText = TextFormat("目标: %d", targetScore);
-        Vector2 targetSize = MeasureTextEx(uiFont, targetText, 20, 1.0f);
-        DrawTextEx(uiFont, targetText, {(SCREEN_WIDTH - targetSize.x) * 0.5f, 10.0f}, 20, 1.0f, GOLD);
+        const char* targetText = TextFormat("目标: %d", sim->getTargetScore());
+        Vector2 targetSize = textCache.measure(uiFont, targetText, 20, 1.0f);
+        textCache.draw(uiFont, targetText, {(SCREEN_WIDTH - targetSize.x) * 0.5f, 10.0f}, 20, 1.0f, GOLD);
     } else {
         // 单人模式UI
         const char* scoreText = TextFormat("分数: %d", score);
-        DrawTextEx(uiFont, scoreText, {10.0f, 10.0f}, 25, 1.0f, DARKGRAY);
+        textCache.draw(uiFont, scoreText, {10.0f, 10.0f}, 25, 1.0f, DARKGRAY);
         
-        const char* lenText = TextFormat("长度: %d", snake->getLength());
-        Vector2 lenSz = MeasureTextEx(uiFont, lenText, 25, 1.0f);
-        DrawTextEx(uiFont, lenText, {SCREEN_WIDTH - 10.0f - lenSz.x, 10.0f}, 25, 1.0f, DARKGRAY);
+        const char* lenText = TextFormat("长度: %d", sim->getSnake(0)->getLength());
+        Vector2 lenSz = textCache.measure(uiFont, lenText, 25, 1.0f);
+        textCache.draw(uiFont, lenText, {SCREEN_WIDTH - 10.0f - lenSz.x, 10.0f}, 25, 1.0f, DARKGRAY);
         
         drawLives();
     }
@@ -859,12 +1138,19 @@ void Game::drawUI() {
     if (speedEffect.active) {
         const char* speedText = TextFormat("%.1fx 速度", speedEffect.multiplier);
         Color speedColor = (speedEffect.multiplier < 1.0f) ? SKYBLUE : PURPLE;
-        Vector2 speedSz = MeasureTextEx(uiFont, speedText, 20, 1.0f);
-        DrawTextEx(uiFont, speedText, {(SCREEN_WIDTH - speedSz.x) * 0.5f, 40.0f}, 20, 1.0f, speedColor);
+        Vector2 speedSz = textCache.measure(uiFont, speedText, 20, 1.0f);
+        textCache.draw(uiFont, speedText, {(SCREEN_WIDTH - speedSz.x) * 0.5f, 40.0f}, 20, 1.0f, speedColor);
     }
     
     if (settingsManager.get().muted) {
-        DrawTextEx(uiFont, "[静音]", {SCREEN_WIDTH * 0.5f - 30.0f, 70.0f}, 20, 1.0f, RED);
+        textCache.draw(uiFont, "[静音]", {SCREEN_WIDTH * 0.5f - 30.0f, 70.0f}, 20, 1.0f, RED);
+    }
+    
+    if (replaying) {
+        const char* replayText = TextFormat("[回放] %llu / %llu",
+                                            static_cast<unsigned long long>(sim->getTick()),
+                                            static_cast<unsigned long long>(replayPlayer.getTickCount()));
+        textCache.draw(uiFont, replayText, {10.0f, SCREEN_HEIGHT - 30.0f}, 20, 1.0f, MAROON);
     }
 }
 
@@ -873,9 +1159,10 @@ void Game::drawLives() {
     float y = 45.0f;
     float size = 15.0f;
     
-    DrawTextEx(uiFont, "生命:", {x, y}, 20, 1.0f, DARKGRAY);
+    textCache.draw(uiFont, "生命:", {x, y}, 20, 1.0f, DARKGRAY);
     x += 50;
     
+    const int lives = sim ? sim->getLives(0) : 0;
     for (int i = 0; i < lives; i++) {
         DrawCircle(static_cast<int>(x + i * (size + 5) + size/2), static_cast<int>(y + size/2 + 2), size/2, RED);
     }
@@ -887,88 +1174,48 @@ void Game::drawMessage() {
     float alpha = messageTimer / 2.0f;
     if (alpha > 1.0f) alpha = 1.0f;
     
-    Vector2 sz = MeasureTextEx(uiFont, message.c_str(), 25, 1.0f);
+    Vector2 sz = textCache.measure(uiFont, message.c_str(), 25, 1.0f);
     float x = (SCREEN_WIDTH - sz.x) * 0.5f;
     float y = SCREEN_HEIGHT * 0.7f;
     
-    DrawTextEx(uiFont, message.c_str(), {x + 2, y + 2}, 25, 1.0f, Fade(BLACK, alpha * 0.5f));
-    DrawTextEx(uiFont, message.c_str(), {x, y}, 25, 1.0f, Fade(GOLD, alpha));
+    textCache.draw(uiFont, message.c_str(), {x + 2, y + 2}, 25, 1.0f, Fade(BLACK, alpha * 0.5f));
+    textCache.draw(uiFont, message.c_str(), {x, y}, 25, 1.0f, Fade(GOLD, alpha));
 }
 
-void Game::spawnItem() {
-    bool validPosition = false;
-    int x, y;
-    int attempts = 0;
-    
-    while (!validPosition && attempts < 100) {
-        attempts++;
-        x = GetRandomValue(0, GRID_WIDTH - 1);
-        y = GetRandomValue(0, GRID_HEIGHT - 1);
-        
-        validPosition = true;
-        
-        for (const auto& segment : snake->getBody()) {
-            if (segment.x == x && segment.y == y) {
-                validPosition = false;
-                break;
-            }
-        }
-        
-        if (snake2) {
-            for (const auto& segment : snake2->getBody()) {
-                if (segment.x == x && segment.y == y) {
-                    validPosition = false;
-                    break;
-                }
-            }
-        }
-        
-        if (validPosition && obstacles.checkCollision(x, y)) {
-            validPosition = false;
-        }
-    }
-    
-    if (validPosition) {
-        currentItem = ItemFactory::createWeightedItem(x, y);
-    }
+void Game::saveHighScore() {
+    recordResult(playerName, true);
 }
 
-void Game::addScore(int points) {
-    score += points;
-    if (baseMoveInterval > 0.05f) {
-        baseMoveInterval *= 0.98f;
+void Game::recordResult(const std::string& name, bool ranked) {
+    // 写盘在高分榜的后台线程里进行；先追加历史，上榜的再更新内存榜单
+    HighScoreEntry entry(name, finalScore, finalLength, getScoreBoardLevel(), static_cast<uint8_t>(gameMode));
+    HighScoreEntry record = highScoreManager.appendRecord(entry);
+    if (ranked) {
+        highScoreManager.submitToBoard(record);
+        highScore = highScoreManager.getHighestScore(record.level, record.mode);
     }
+    resultPending = false;
 }
 
-void Game::applySpeedEffect(float multiplier, float duration) {
-    speedEffect.multiplier = multiplier;
-    speedEffect.remaining = duration;
-    speedEffect.active = true;
-    
-    if (multiplier < 1.0f) {
-        showMessage("加速!");
-    } else {
-        showMessage("减速!");
-    }
+std::string Game::getScoreBoardLevel() const {
+    // 关卡文件名作为榜单的键，内置关卡为空字符串
+    return levelManager->getCurrentInfo().file;
 }
 
-void Game::showMessage(const std::string& msg) {
-    message = msg;
-    messageTimer = 2.0f;
+void Game::saveReplay() {
+    #ifdef _WIN32
+    _mkdir("data");
+    #else
+    mkdir("data", 0755);
+    #endif
+    recorder.getReplay().save(getReplayPath());
 }
 
-void Game::checkExtraLife() {
-    static int lastLifeMilestone = 0;
-    int currentMilestone = score / LIVES_PER_EXTRA;
-    
-    if (currentMilestone > lastLifeMilestone && lives < MAX_LIVES) {
-        lives++;
-        lastLifeMilestone = currentMilestone;
-        showMessage("奖励生命!");
-        AudioSystem::getInstance().play(SoundType::EXTRA_LIFE);
-    }
+std::string Game::getReplayPath() {
+    return "data/last_replay.snrp";
 }
 
-float Game::getCurrentMoveInterval() const {
-    return baseMoveInterval * speedEffect.multiplier;
+void Game::showMessage(const std::string& msg) {
+    message = msg;
+    messageTimer = 2.0f;
 }
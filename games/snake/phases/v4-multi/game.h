@@ -1,14 +1,18 @@
 #pragma once
 #include "raylib.h"
-#include "snake.h"
-#include "item.h"
-#include "obstacle.h"
+#include "snake_sim.h"
 #include "particle.h"
+#include "particle_renderer.h"
 #include "screenshake.h"
 #include "audio_system.h"
 #include "highscore.h"
 #include "settings.h"
 #include "level.h"
+#include "replay.h"
+#include "board_camera.h"
+#include "chunk_mesh.h"
+#include "text_cache.h"
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -16,7 +20,8 @@
 enum class GameMode {
     SINGLE,         // 单人模式
     VERSUS,         // 对战模式
-    EDITOR          // 关卡编辑器
+    EDITOR,         // 关卡编辑器
+    RUSH            // 道具冲刺：单人，同屏大量道具
 };
 
 // 游戏状态
@@ -31,55 +36,59 @@ enum class GameState {
     LEVEL_EDITOR    // 关卡编辑器
 };
 
-// 速度效果结构
-struct SpeedEffect {
-    float multiplier;   // 速度倍数
-    float remaining;    // 剩余时间
-    bool active;
-
-    SpeedEffect() : multiplier(1.0f), remaining(0.0f), active(false) {}
-};
-
 // ============================================================
-// Game 类 - 管理整个游戏状态和逻辑
+// Game 类 - 窗口前端：输入、渲染、音效、菜单
 // ============================================================
+// 对局逻辑全部在 SnakeSim 中，Game 把键盘输入转换成 TickInput，
+// 再把模拟事件转换成音效、粒子和提示信息。
 class Game {
 private:
     // 游戏常量
     static constexpr int SCREEN_WIDTH = 800;
     static constexpr int SCREEN_HEIGHT = 600;
     static constexpr int GRID_SIZE = 20;
-    static constexpr int GRID_WIDTH = SCREEN_WIDTH / GRID_SIZE;
-    static constexpr int GRID_HEIGHT = SCREEN_HEIGHT / GRID_SIZE;
-    static constexpr int MAX_LIVES = 3;
-    static constexpr int LIVES_PER_EXTRA = 500;  // 每500分奖励生命
-
-    // 游戏对象
-    std::unique_ptr<Snake> snake;           // 玩家1的蛇
-    std::unique_ptr<Snake> snake2;          // 玩家2的蛇（对战模式）
-    std::unique_ptr<Item> currentItem;
-    ObstacleManager obstacles;
+    // 新关卡和随机关卡的默认尺寸（正好铺满窗口）；关卡自己的尺寸可以到 2048x2048
+    static constexpr int DEFAULT_GRID_WIDTH = SCREEN_WIDTH / GRID_SIZE;
+    static constexpr int DEFAULT_GRID_HEIGHT = SCREEN_HEIGHT / GRID_SIZE;
+    static constexpr int RANDOM_CRATES = 6;             // 每局随机放置的箱子数
+    static constexpr int RUSH_ITEM_COUNT = 24;          // 道具冲刺模式同时存在的道具数
+    static constexpr size_t PARTICLE_CAPACITY = 65536;  // 对战模式连续爆炸时也不会耗尽
+    static constexpr const char* DEFAULT_PLAYER_NAME = "Player";  // 没上榜（不输入名字）的对局在历史里的名字
+
+    // 模拟核心
+    std::unique_ptr<SnakeSim> sim;
+    TickInput pendingInput;      // 两次 tick 之间累积的输入
     ParticleSystem particles;    // 粒子系统
+    ParticleRenderer particleRenderer;  // 粒子批量渲染
+    ChunkMeshCache boardMesh;    // 每块墙壁合并后的矩形（直接读模拟的障碍物图层）
+    ChunkMeshCache crateMesh;    // 每块箱子的矩形，箱子被撞碎时只重建那一块
+    Texture2D checkerTexture;    // 2x2 棋盘格纹理，重复平铺，整个可见背景一次绘制
+    BoardCamera camera;          // 地图比窗口大时跟随玩家滚动
     ScreenShake screenShake;     // 屏幕震动
 
     // 游戏模式和状态
     GameMode gameMode;
     GameState state;
-    int score;
-    int score2;                 // 玩家2的分数
-    int lives;
-    int lives2;                 // 玩家2的生命
-    int highScore;
-    int targetScore;            // 对战模式目标分数
-
-    // 移动控制
+    GameMode scoreBoardMode;     // 高分榜界面显示的模式
+    int highScore;               // 当前关卡和模式的最高分
+
+    // 启动计时：构造开始到第一帧画完
+    std::chrono::steady_clock::time_point startupBegin;
+
+    // 固定步长：moveTimer 是累加器，不足一个 tick 的时间留到下一帧
+    static constexpr int MAX_TICKS_PER_FRAME = 8;   // 卡顿后一帧最多补这么多 tick
     float moveTimer;
-    float baseMoveInterval;
-    SpeedEffect speedEffect;
+
+    // 回放：正常对局时录制，回放时由 replayPlayer 代替键盘输入
+    static constexpr int REPLAY_SEEK_TICKS = 50;    // 左右键每次跳转的 tick 数
+    ReplayRecorder recorder;
+    ReplayPlayer replayPlayer;
+    bool replaying;
 
     // UI
     Font uiFont;
     bool ownsFont;
+    TextCache textCache;         // 界面文字排版缓存（字体更换后要清空）
 
     // 消息提示
     std::string message;
@@ -91,6 +100,7 @@ private:
     std::string playerName;
     int finalScore;
     int finalLength;
+    bool resultPending;          // 上榜的这局还在等输入名字，尚未写进历史
 
     // 设置菜单选项
     int settingsSelection;
@@ -110,15 +120,14 @@ public:
     // 游戏控制
     void init();
     void reset();
+    bool startReplay(const Replay& replay);
     void update(float deltaTime);
     void draw();
 
     // 状态查询
     bool isRunning() const { return !WindowShouldClose(); }
 
-    // 道具效果
-    void addScore(int points);
-    void applySpeedEffect(float multiplier, float duration);
+    // 提示信息
     void showMessage(const std::string& msg);
 
     // 获取常量
@@ -130,7 +139,8 @@ private:
     // 初始化
     void initWindow();
     void initFont();
-    void spawnItem();
+    void initBoardTexture();
+    SimConfig makeSimConfig() const;
 
     // 更新
     void updateMenu(float deltaTime);
@@ -141,8 +151,7 @@ private:
     void updateHighScores(float deltaTime);
     void updateEnterName(float deltaTime);
     void updateLevelEditor(float deltaTime);
-    void updateSnakeMovement(Snake& snakeRef, int& playerScore, int& playerLives, int playerId);
-    void updateSpeedEffect(float deltaTime);
+    void handleSimEvents();
 
     // 绘制
     void drawMenu();
@@ -152,18 +161,28 @@ private:
     void drawSettings();
     void drawHighScores();
     void drawEnterName();
-    void drawGrid();
+    void rebuildBoard();
+    void updateCamera();
+    void drawGrid(int x0, int y0, int x1, int y1);
+    void drawObstacles(int x0, int y0, int x1, int y1);
+    void drawItem(const Item& item);
+    void drawSnake(const Snake& snakeRef, Color headColor, Color bodyColor, float alpha);
+    float getTickAlpha() const;
     void drawUI();
     void drawMessage();
     void drawLives();
     void drawVolumeBar(const char* label, float x, float y, float width, float value, bool selected);
 
     // 工具函数
-    void checkExtraLife();
-    float getCurrentMoveInterval() const;
     void saveHighScore();
+    void recordResult(const std::string& name, bool ranked);
+    std::string getScoreBoardLevel() const;
+    void saveReplay();
+    static std::string getReplayPath();
 
     // 输入处理
     void handleInput();
+    void readPlayerInput();
+    void updateReplayControls();
     void handleSettingsInput();
 };
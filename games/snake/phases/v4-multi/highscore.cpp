@@ -1,16 +1,100 @@
 #include "highscore.h"
-#include <fstream>
-#include <sstream>
-#include <iomanip>
+#include "byte_stream.h"
+#include "durable_file.h"
+#include "json.h"
+#include "raylib.h"
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <string_view>
 #include <sys/stat.h>
 
+namespace {
+
+// 文件格式：魔数 + 版本，.dat 的头部再加一个序号下限；之后是记录帧
+//   记录帧 = varint 长度 + 记录 + u32 校验和（FNV-1a 的低 32 位）
+const uint8_t DAT_MAGIC[4] = {'S', 'N', 'H', 'S'};
+const uint8_t LOG_MAGIC[4] = {'S', 'N', 'H', 'L'};
+const uint8_t STORE_VERSION = 1;
+const size_t MAX_RECORD_SIZE = 4096;
+const size_t MAX_STRING_SIZE = 256;
+
+void writeString(ByteWriter& w, const std::string& s) {
+    w.writeVarint(s.size());
+    w.writeBytes(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+}
+
+std::string readString(ByteReader& r) {
+    uint64_t size = r.readVarint();
+    if (size > MAX_STRING_SIZE) {
+        r.seek(SIZE_MAX);       // 置失败
+        return std::string();
+    }
+    const uint8_t* bytes = r.readBytes(static_cast<size_t>(size));
+    return bytes ? std::string(reinterpret_cast<const char*>(bytes), static_cast<size_t>(size)) : std::string();
+}
+
+void writeFrame(std::vector<uint8_t>& out, const HighScoreEntry& entry) {
+    std::vector<uint8_t> payload;
+    ByteWriter pw(payload);
+    entry.write(pw);
+
+    ByteWriter w(out);
+    w.writeVarint(payload.size());
+    w.writeBytes(payload.data(), payload.size());
+    w.writeU32(static_cast<uint32_t>(hashBytes(payload.data(), payload.size())));
+}
+
+void writeHeader(std::vector<uint8_t>& out, const uint8_t (&magic)[4]) {
+    ByteWriter w(out);
+    w.writeBytes(magic, sizeof(magic));
+    w.writeU8(STORE_VERSION);
+}
+
+// 检查头部，成功时 r 停在头部之后
+bool readHeader(ByteReader& r, const uint8_t (&magic)[4]) {
+    const uint8_t* bytes = r.readBytes(sizeof(magic));
+    return bytes && std::equal(magic, magic + sizeof(magic), bytes) && r.readU8() == STORE_VERSION;
+}
+
+// 从 r 的当前位置逐条解析记录帧，对每条调用 f(entry, frame, frameSize)。
+// 遇到截断或校验失败就停下（崩溃时只写了一半的尾巴），返回有效部分的结束位置。
+template <typename F>
+size_t readFrames(ByteReader& r, const uint8_t* data, F&& f) {
+    size_t valid = r.position();
+    while (!r.atEnd()) {
+        const size_t start = r.position();
+        uint64_t size = r.readVarint();
+        if (!r.ok() || size > MAX_RECORD_SIZE) break;
+        const uint8_t* payload = r.readBytes(static_cast<size_t>(size));
+        uint32_t checksum = r.readU32();
+        if (!payload || !r.ok() ||
+            checksum != static_cast<uint32_t>(hashBytes(payload, static_cast<size_t>(size)))) {
+            break;
+        }
+
+        HighScoreEntry entry;
+        ByteReader pr(payload, static_cast<size_t>(size));
+        if (!entry.read(pr)) break;
+
+        valid = r.position();
+        f(entry, data + start, valid - start);
+    }
+    return valid;
+}
+
+// 排名：分数高的在前，同分时先提交的在前
+bool ranksAbove(const HighScoreEntry& a, const HighScoreEntry& b) {
+    return a.score != b.score ? a.score > b.score : a.seq < b.seq;
+}
+
+} // namespace
+
 // ============================================================
 // HighScoreEntry 实现
 // ============================================================
-HighScoreEntry::HighScoreEntry(const std::string& n, int s, int l)
-    : name(n), score(s), length(l) {
+HighScoreEntry::HighScoreEntry(const std::string& n, int s, int l, const std::string& lvl, uint8_t m)
+    : name(n), score(s), length(l), level(lvl), mode(m), seq(0) {
     // 生成日期字符串
     time_t now = time(nullptr);
     tm* ltm = localtime(&now);
@@ -19,180 +103,442 @@ HighScoreEntry::HighScoreEntry(const std::string& n, int s, int l)
     date = buffer;
 }
 
-std::string HighScoreEntry::toJson() const {
-    std::stringstream ss;
-    ss << "{\"name\":\"" << name << "\","
-       << "\"score\":" << score << ","
-       << "\"length\":" << length << ","
-       << "\"date\":\"" << date << "\"}";
-    return ss.str();
-}
-
-HighScoreEntry HighScoreEntry::fromJson(const std::string& json) {
+HighScoreEntry HighScoreEntry::fromJson(JsonReader& r) {
     HighScoreEntry entry;
 
-    // 简单的 JSON 解析
-    size_t namePos = json.find("\"name\":\"");
-    if (namePos != std::string::npos) {
-        namePos += 8;
-        size_t nameEnd = json.find("\"", namePos);
-        entry.name = json.substr(namePos, nameEnd - namePos);
-    }
-
-    size_t scorePos = json.find("\"score\":");
-    if (scorePos != std::string::npos) {
-        scorePos += 8;
-        size_t scoreEnd = json.find(",", scorePos);
-        entry.score = std::stoi(json.substr(scorePos, scoreEnd - scorePos));
+    if (r.beginObject()) {
+        std::string_view key;
+        while (r.nextKey(key)) {
+            if (key == "name") entry.name = r.readString();
+            else if (key == "score") entry.score = r.readInt();
+            else if (key == "length") entry.length = r.readInt();
+            else if (key == "date") entry.date = r.readString();
+            else r.skipValue();
+        }
     }
 
-    size_t lenPos = json.find("\"length\":");
-    if (lenPos != std::string::npos) {
-        lenPos += 9;
-        size_t lenEnd = json.find(",", lenPos);
-        entry.length = std::stoi(json.substr(lenPos, lenEnd - lenPos));
-    }
+    return entry;
+}
 
-    size_t datePos = json.find("\"date\":\"");
-    if (datePos != std::string::npos) {
-        datePos += 8;
-        size_t dateEnd = json.find("\"", datePos);
-        entry.date = json.substr(datePos, dateEnd - datePos);
-    }
+void HighScoreEntry::write(ByteWriter& w) const {
+    w.writeVarint(seq);
+    writeString(w, name);
+    w.writeSVarint(score);
+    w.writeSVarint(length);
+    writeString(w, date);
+    writeString(w, level);
+    w.writeU8(mode);
+}
 
-    return entry;
+bool HighScoreEntry::read(ByteReader& r) {
+    seq = r.readVarint();
+    name = readString(r);
+    score = static_cast<int>(r.readSVarint());
+    length = static_cast<int>(r.readSVarint());
+    date = readString(r);
+    level = readString(r);
+    mode = r.readU8();
+    return r.ok();
 }
 
 // ============================================================
 // HighScoreManager 实现
 // ============================================================
 HighScoreManager::HighScoreManager(const std::string& fname)
-    : filename(fname) {
+    : filename(fname), nextSeq(1), totalRecords(0), bestScore(0),
+      pendingCount(0), clearRequested(false), clearedSeq(0),
+      compactRequested(false), stopping(false),
+      logRecords(0), logReady(false) {
     load();
+    ioThread = std::thread(&HighScoreManager::ioLoop, this);
 }
 
-bool HighScoreManager::load() {
-    std::string fullPath = getFullPath();
-    std::ifstream file(fullPath);
-
-    if (!file.is_open()) {
-        // 文件不存在，使用空列表
-        return true;
+HighScoreManager::~HighScoreManager() {
+    // 退出前 I/O 线程会把排队的记录写完
+    {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        stopping = true;
     }
+    ioWake.notify_one();
+    ioThread.join();
+}
 
-    entries.clear();
-    std::string line;
-    std::string json;
+void HighScoreManager::load() {
+    auto startTime = std::chrono::steady_clock::now();
 
-    while (std::getline(file, line)) {
-        json += line;
+    std::vector<uint8_t> datBytes, logBytes;
+    const bool hasDat = readFileBytes(getFullPath(".dat"), datBytes);
+    const bool hasLog = readFileBytes(getFullPath(".log"), logBytes);
+
+    if (!hasDat && !hasLog) {
+        importLegacyJson();
+        return;
     }
 
-    // 解析 JSON 数组
-    size_t pos = 0;
-    while ((pos = json.find("{", pos)) != std::string::npos) {
-        size_t end = json.find("}", pos);
-        if (end == std::string::npos) break;
+    uint64_t seqFloor = 0;
+    uint64_t maxSeq = 0;
+    auto add = [&](const HighScoreEntry& entry, const uint8_t*, size_t) {
+        insert(entry);
+        maxSeq = std::max(maxSeq, entry.seq);
+        totalRecords++;
+    };
 
-        std::string entryJson = json.substr(pos, end - pos + 1);
-        entries.push_back(HighScoreEntry::fromJson(entryJson));
-        pos = end + 1;
+    if (hasDat) {
+        ByteReader r(datBytes.data(), datBytes.size());
+        if (readHeader(r, DAT_MAGIC)) {
+            seqFloor = r.readU64();
+            if (readFrames(r, datBytes.data(), add) != datBytes.size()) {
+                // .dat 只会被整体替换，走到这里说明文件被外部改坏了
+                TraceLog(LOG_WARNING, "HIGHSCORE: [%s] 数据损坏，只保留前 %d 条记录",
+                         getFullPath(".dat").c_str(), static_cast<int>(totalRecords));
+                compactRequested = true;
+            }
+        } else {
+            TraceLog(LOG_WARNING, "HIGHSCORE: [%s] 文件头无效", getFullPath(".dat").c_str());
+        }
     }
 
-    // 按分数排序
-    std::sort(entries.begin(), entries.end(),
-        [](const HighScoreEntry& a, const HighScoreEntry& b) {
-            return a.score > b.score;
-        });
+    if (hasLog) {
+        ByteReader r(logBytes.data(), logBytes.size());
+        if (readHeader(r, LOG_MAGIC)) {
+            logReady = true;
+            size_t stale = 0;
+            size_t valid = readFrames(r, logBytes.data(), [&](const HighScoreEntry& entry, const uint8_t* frame, size_t size) {
+                logRecords++;
+                // 压缩后没来得及清空日志时，已并入 .dat 的记录会在这里重复出现
+                if (entry.seq <= seqFloor) {
+                    stale++;
+                    return;
+                }
+                add(entry, frame, size);
+            });
+            if (valid != logBytes.size()) {
+                TraceLog(LOG_WARNING, "HIGHSCORE: [%s] 丢弃末尾 %d 字节不完整的记录",
+                         getFullPath(".log").c_str(), static_cast<int>(logBytes.size() - valid));
+            }
+            // 残缺的尾巴之后不能再追加，重复的记录也没必要留着
+            if (valid != logBytes.size() || stale > 0) {
+                compactRequested = true;
+            }
+        }
+    }
 
-    return true;
+    nextSeq = std::max(seqFloor, maxSeq) + 1;
+    for (auto& board : boards) {
+        rankBoard(board.second);
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    TraceLog(LOG_INFO, "HIGHSCORE: 读取 %d 条记录，%d 个榜单，用时 %.2f ms",
+             static_cast<int>(totalRecords), static_cast<int>(boards.size()), elapsed);
 }
 
-bool HighScoreManager::save() const {
-    ensureDirectory();
-    std::string fullPath = getFullPath();
-    std::ofstream file(fullPath);
+void HighScoreManager::importLegacyJson() {
+    std::vector<uint8_t> bytes;
+    if (!readFileBytes(getFullPath(".json"), bytes)) {
+        return;
+    }
 
-    if (!file.is_open()) {
-        return false;
+    std::vector<HighScoreEntry> imported;
+    JsonReader r(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()));
+    if (r.beginArray()) {
+        while (r.nextElement()) {
+            imported.push_back(HighScoreEntry::fromJson(r));
+        }
+    }
+    if (!r.finish()) {
+        TraceLog(LOG_WARNING, "HIGHSCORE: [%s] %s", getFullPath(".json").c_str(), r.getError().c_str());
+        return;
     }
 
-    file << "[";
-    for (size_t i = 0; i < entries.size(); i++) {
-        if (i > 0) file << ",";
-        file << entries[i].toJson();
+    // 旧文件只有单人模式的全局榜，归到内置关卡下，由 I/O 线程写成 .dat
+    std::stable_sort(imported.begin(), imported.end(),
+        [](const HighScoreEntry& a, const HighScoreEntry& b) { return a.score > b.score; });
+    for (HighScoreEntry& entry : imported) {
+        entry.seq = nextSeq++;
+        insert(entry);
+        writeFrame(pendingRecords, entry);
+        pendingCount++;
+        totalRecords++;
+    }
+    for (auto& board : boards) {
+        rankBoard(board.second);
     }
-    file << "]";
+    compactRequested = true;
+    TraceLog(LOG_INFO, "HIGHSCORE: 从 %s 导入 %d 条记录", getFullPath(".json").c_str(), static_cast<int>(imported.size()));
+}
 
-    return true;
+HighScoreEntry HighScoreManager::appendRecord(const HighScoreEntry& entry) {
+    HighScoreEntry record = entry;
+    record.seq = nextSeq++;
+    totalRecords++;
+
+    {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        writeFrame(pendingRecords, record);
+        pendingCount++;
+    }
+    ioWake.notify_one();
+    return record;
 }
 
-bool HighScoreManager::addEntry(const HighScoreEntry& entry) {
-    entries.push_back(entry);
+bool HighScoreManager::submitToBoard(const HighScoreEntry& record) {
+    bool ranked = insert(record);
+    if (ranked) {
+        rankBoard(boards[{record.level, record.mode}]);
+    }
+    return ranked;
+}
 
-    // 按分数排序
-    std::sort(entries.begin(), entries.end(),
-        [](const HighScoreEntry& a, const HighScoreEntry& b) {
-            return a.score > b.score;
-        });
+bool HighScoreManager::insert(const HighScoreEntry& entry) {
+    bestScore = std::max(bestScore, entry.score);
 
-    // 只保留前 MAX_ENTRIES 个
-    if (entries.size() > MAX_ENTRIES) {
-        entries.resize(MAX_ENTRIES);
+    // 小顶堆：堆顶是榜上最差的一条，新记录只需要和它比
+    std::vector<HighScoreEntry>& heap = boards[{entry.level, entry.mode}].heap;
+    if (static_cast<int>(heap.size()) < MAX_ENTRIES) {
+        heap.push_back(entry);
+        std::push_heap(heap.begin(), heap.end(), ranksAbove);
+        return true;
     }
+    if (!ranksAbove(entry, heap.front())) {
+        return false;
+    }
+    std::pop_heap(heap.begin(), heap.end(), ranksAbove);
+    heap.back() = entry;
+    std::push_heap(heap.begin(), heap.end(), ranksAbove);
+    return true;
+}
 
-    return save();
+void HighScoreManager::rankBoard(Board& board) {
+    board.ranked = board.heap;
+    std::sort(board.ranked.begin(), board.ranked.end(), ranksAbove);
 }
 
-bool HighScoreManager::isHighScore(int score) const {
-    if (entries.size() < MAX_ENTRIES) {
+const HighScoreManager::Board* HighScoreManager::findBoard(const std::string& level, uint8_t mode) const {
+    auto it = boards.find({level, mode});
+    return it != boards.end() ? &it->second : nullptr;
+}
+
+bool HighScoreManager::isHighScore(const std::string& level, uint8_t mode, int score) const {
+    const Board* board = findBoard(level, mode);
+    if (!board || static_cast<int>(board->heap.size()) < MAX_ENTRIES) {
         return true;
     }
-    return score > entries.back().score;
+    // 同分时先到者排前，新记录要严格更高才能挤掉堆顶
+    return score > board->heap.front().score;
 }
 
-int HighScoreManager::getRank(int score) const {
-    for (size_t i = 0; i < entries.size(); i++) {
-        if (score > entries[i].score) {
+int HighScoreManager::getRank(const std::string& level, uint8_t mode, int score) const {
+    const Board* board = findBoard(level, mode);
+    if (!board) {
+        return 1;
+    }
+    for (size_t i = 0; i < board->ranked.size(); i++) {
+        if (score > board->ranked[i].score) {
             return static_cast<int>(i) + 1;
         }
     }
-    if (entries.size() < MAX_ENTRIES) {
-        return static_cast<int>(entries.size()) + 1;
+    if (static_cast<int>(board->ranked.size()) < MAX_ENTRIES) {
+        return static_cast<int>(board->ranked.size()) + 1;
     }
     return 0;
 }
 
-int HighScoreManager::getHighestScore() const {
-    if (entries.empty()) {
-        return 0;
-    }
-    return entries[0].score;
+const std::vector<HighScoreEntry>& HighScoreManager::getEntries(const std::string& level, uint8_t mode) const {
+    static const std::vector<HighScoreEntry> empty;
+    const Board* board = findBoard(level, mode);
+    return board ? board->ranked : empty;
+}
+
+int HighScoreManager::getHighestScore(const std::string& level, uint8_t mode) const {
+    const Board* board = findBoard(level, mode);
+    return (board && !board->ranked.empty()) ? board->ranked.front().score : 0;
 }
 
 void HighScoreManager::clear() {
-    entries.clear();
-    save();
+    boards.clear();
+    totalRecords = 0;
+    bestScore = 0;
+    {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        // 还没写出去的记录也一起作废
+        pendingRecords.clear();
+        pendingCount = 0;
+        clearRequested = true;
+        clearedSeq = nextSeq - 1;
+    }
+    ioWake.notify_one();
 }
 
-void HighScoreManager::ensureDirectory() const {
-    // 获取父目录
-    size_t pos = filename.find_last_of("/\\");
-    if (pos != std::string::npos) {
-        std::string dir = filename.substr(0, pos);
-        #ifdef _WIN32
-        _mkdir(dir.c_str());
-        #else
-        ::mkdir(dir.c_str(), 0755);
-        #endif
+// ============================================================
+// 后台 I/O 线程
+// ============================================================
+void HighScoreManager::ioLoop() {
+    std::vector<uint8_t> batch;
+    std::vector<uint8_t> unwritten;     // 写失败的记录，下次和新记录一起重试
+    size_t unwrittenCount = 0;
+    bool logDamaged = false;            // 追加失败过：日志末尾可能有半条记录，压缩成功前不再追加
+
+    for (;;) {
+        bool doClear, doCompact, exiting;
+        uint64_t seqFloor;
+        size_t batchCount;
+        {
+            std::unique_lock<std::mutex> lock(ioMutex);
+            ioWake.wait(lock, [&] {
+                return stopping || clearRequested || compactRequested || !pendingRecords.empty();
+            });
+            batch.swap(pendingRecords);
+            batchCount = pendingCount;
+            pendingCount = 0;
+            doClear = clearRequested;
+            doCompact = compactRequested;
+            exiting = stopping;
+            seqFloor = clearedSeq;
+            clearRequested = false;
+            compactRequested = false;
+        }
+
+        ensureDirectory();
+
+        if (doClear) {
+            unwritten.clear();
+            unwrittenCount = 0;
+            if (resetFiles(seqFloor)) {
+                logDamaged = false;
+            } else {
+                TraceLog(LOG_WARNING, "HIGHSCORE: 清除记录失败");
+            }
+        }
+
+        unwritten.insert(unwritten.end(), batch.begin(), batch.end());
+        unwrittenCount += batchCount;
+        batch.clear();
+
+        if (!unwritten.empty() || doCompact) {
+            bool written;
+            if (doCompact || logDamaged || logRecords + unwrittenCount >= COMPACT_THRESHOLD) {
+                written = compact(unwritten);
+            } else {
+                // 追加失败时日志末尾可能留下半条记录，改为整体重写
+                written = appendRecords(unwritten, unwrittenCount);
+                if (!written) {
+                    logDamaged = true;
+                    written = compact(unwritten);
+                }
+            }
+            if (written) {
+                logDamaged = false;
+                unwritten.clear();
+                unwrittenCount = 0;
+            } else {
+                TraceLog(LOG_WARNING, "HIGHSCORE: 写入失败，%d 条记录稍后重试", static_cast<int>(unwrittenCount));
+            }
+        }
+
+        if (exiting) break;
     }
 }
 
-std::string HighScoreManager::getFullPath() const {
-    // 使用应用程序目录下的 data 文件夹
+bool HighScoreManager::appendRecords(const std::vector<uint8_t>& records, size_t count) {
+    if (!logReady && !resetLog()) {
+        return false;
+    }
+    if (!appendFileDurable(getFullPath(".log"), records.data(), records.size())) {
+        return false;
+    }
+    logRecords += count;
+    return true;
+}
+
+bool HighScoreManager::compact(const std::vector<uint8_t>& extraRecords) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    std::vector<uint8_t> datBytes, logBytes;
+    readFileBytes(getFullPath(".dat"), datBytes);
+    readFileBytes(getFullPath(".log"), logBytes);
+
+    // 原样拷贝所有有效的记录帧：旧 .dat、日志里还没并入的、再加上这次的
+    std::vector<uint8_t> out;
+    writeHeader(out, DAT_MAGIC);
+    const size_t floorPos = out.size();
+    ByteWriter(out).writeU64(0);
+
+    uint64_t seqFloor = 0;
+    uint64_t maxSeq = 0;
+    size_t count = 0;
+    auto copy = [&](const HighScoreEntry& entry, const uint8_t* frame, size_t size) {
+        out.insert(out.end(), frame, frame + size);
+        maxSeq = std::max(maxSeq, entry.seq);
+        count++;
+    };
+
+    ByteReader datReader(datBytes.data(), datBytes.size());
+    if (readHeader(datReader, DAT_MAGIC)) {
+        seqFloor = datReader.readU64();
+        readFrames(datReader, datBytes.data(), copy);
+    }
+    ByteReader logReader(logBytes.data(), logBytes.size());
+    if (readHeader(logReader, LOG_MAGIC)) {
+        readFrames(logReader, logBytes.data(), [&](const HighScoreEntry& entry, const uint8_t* frame, size_t size) {
+            if (entry.seq > seqFloor) copy(entry, frame, size);
+        });
+    }
+    // 追加写了一半失败时，开头几条已经在日志里了（上面拷过），这里按序号跳过；
+    // 记录序号单调递增，待写的记录里序号不超过已拷贝最大值的都是重复
+    const uint64_t copiedSeq = maxSeq;
+    ByteReader extraReader(extraRecords.data(), extraRecords.size());
+    readFrames(extraReader, extraRecords.data(), [&](const HighScoreEntry& entry, const uint8_t* frame, size_t size) {
+        if (entry.seq > copiedSeq) copy(entry, frame, size);
+    });
+
+    // 新的下限覆盖日志里的所有记录：换完 .dat 后来不及清空日志也不会重复加载
+    seqFloor = std::max(seqFloor, maxSeq);
+    for (int i = 0; i < 8; i++) {
+        out[floorPos + i] = static_cast<uint8_t>(seqFloor >> (i * 8));
+    }
+
+    if (!writeFileAtomic(getFullPath(".dat"), out.data(), out.size())) {
+        return false;
+    }
+    // 日志清空失败不要紧：里面的记录序号都不超过下限，下次加载会跳过
+    if (!resetLog()) {
+        TraceLog(LOG_WARNING, "HIGHSCORE: [%s] 清空日志失败", getFullPath(".log").c_str());
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    TraceLog(LOG_INFO, "HIGHSCORE: 压缩 %d 条记录（%d 字节）用时 %.2f ms",
+             static_cast<int>(count), static_cast<int>(out.size()), elapsed);
+    return true;
+}
+
+bool HighScoreManager::resetFiles(uint64_t seqFloor) {
+    std::vector<uint8_t> out;
+    writeHeader(out, DAT_MAGIC);
+    ByteWriter(out).writeU64(seqFloor);
+    if (!writeFileAtomic(getFullPath(".dat"), out.data(), out.size())) {
+        return false;
+    }
+    return resetLog();
+}
+
+bool HighScoreManager::resetLog() {
+    std::vector<uint8_t> header;
+    writeHeader(header, LOG_MAGIC);
+    logReady = writeFileAtomic(getFullPath(".log"), header.data(), header.size());
+    logRecords = 0;
+    return logReady;
+}
+
+void HighScoreManager::ensureDirectory() const {
     #ifdef _WIN32
-    return "data/" + filename;
+    _mkdir("data");
     #else
-    return "data/" + filename;
+    mkdir("data", 0755);
     #endif
 }
+
+std::string HighScoreManager::getFullPath(const char* extension) const {
+    // 使用应用程序目录下的 data 文件夹
+    return "data/" + filename + extension;
+}
@@ -1,8 +1,18 @@
 #pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 #include <ctime>
 
+class JsonReader;
+class ByteWriter;
+class ByteReader;
+
 // ============================================================
 // 高分记录结构
 // ============================================================
@@ -11,55 +21,117 @@ struct HighScoreEntry {
     int score;              // 分数
     int length;             // 蛇的长度
     std::string date;       // 日期字符串
+    std::string level;      // 关卡文件名（内置关卡为空）
+    uint8_t mode;           // 游戏模式（GameMode 的值）
+    uint64_t seq;           // 记录序号，写入时分配，同分时先到者排前
+
+    HighScoreEntry() : score(0), length(0), mode(0), seq(0) {}
+    HighScoreEntry(const std::string& n, int s, int l, const std::string& lvl = "", uint8_t m = 0);
 
-    HighScoreEntry() : score(0), length(0) {}
-    HighScoreEntry(const std::string& n, int s, int l);
+    // 从旧版 highscores.json 导入（读一个对象）
+    static HighScoreEntry fromJson(JsonReader& r);
 
-    // 序列化到 JSON
-    std::string toJson() const;
-    // 从 JSON 反序列化
-    static HighScoreEntry fromJson(const std::string& json);
+    // 记录日志里的二进制格式
+    void write(ByteWriter& w) const;
+    bool read(ByteReader& r);
 };
 
 // ============================================================
 // 高分榜管理器
 // ============================================================
+// 磁盘上是只追加的记录日志，保留全部历史（可用于统计分析）：
+//   <name>.dat  压缩后的历史记录，只通过“临时文件 + fsync + rename”整体替换
+//   <name>.log  之后新增的记录，逐条追加；每条带长度和校验和
+// 崩溃时最多丢掉日志末尾写了一半的那条，加载时校验失败就停在那里。
+// 日志攒到 COMPACT_THRESHOLD 条后合并进 .dat 并清空日志。
+//
+// 内存里只按 (关卡, 模式) 维护前 MAX_ENTRIES 名：加载时每条记录进一个
+// 有界的小顶堆，O(log k)。追加历史和更新榜单是两步：每局结束都追加
+// 记录（没上榜的也写），上榜的再更新内存榜单。编码好的记录交给
+// 后台 I/O 线程，游戏线程不碰磁盘。
 class HighScoreManager {
+public:
+    static constexpr int MAX_ENTRIES = 10;          // 每个榜单的名次数
+    static constexpr int COMPACT_THRESHOLD = 256;   // 日志超过这么多条就压缩
+
 private:
-    static constexpr int MAX_ENTRIES = 10;
-    std::vector<HighScoreEntry> entries;
+    using BoardKey = std::pair<std::string, uint8_t>;   // (关卡, 模式)
+    struct Board {
+        std::vector<HighScoreEntry> heap;       // 小顶堆：堆顶是榜上最差的一条
+        std::vector<HighScoreEntry> ranked;     // 按名次排好的副本，供界面显示
+    };
+
+    std::map<BoardKey, Board> boards;
     std::string filename;
+    uint64_t nextSeq;
+    size_t totalRecords;            // 历史记录总数（包括没上榜的）
+    int bestScore;                  // 所有榜单的最高分
+
+    // 后台 I/O 线程
+    std::thread ioThread;
+    std::mutex ioMutex;
+    std::condition_variable ioWake;
+    std::vector<uint8_t> pendingRecords;    // 已编码、待追加的记录
+    size_t pendingCount;
+    bool clearRequested;
+    uint64_t clearedSeq;            // 清除时已分配的最大序号，旧日志里的记录都不超过它
+    bool compactRequested;
+    bool stopping;
+
+    // 以下只在构造时和 I/O 线程里访问
+    size_t logRecords;              // 日志里的记录数
+    bool logReady;                  // 日志文件存在且头部完好
 
 public:
-    HighScoreManager(const std::string& filename = "highscores.json");
+    HighScoreManager(const std::string& filename = "highscores");
+    ~HighScoreManager();
 
-    // 加载和保存
-    bool load();
-    bool save() const;
+    HighScoreManager(const HighScoreManager&) = delete;
+    HighScoreManager& operator=(const HighScoreManager&) = delete;
 
-    // 添加新记录
-    bool addEntry(const HighScoreEntry& entry);
+    // 把一局的结果追加到历史（分配序号，写盘在后台进行），不碰榜单；返回带序号的记录
+    HighScoreEntry appendRecord(const HighScoreEntry& entry);
+    // 把已追加的记录放进对应榜单，返回是否上榜
+    bool submitToBoard(const HighScoreEntry& record);
+    // 上面两步合在一起：追加历史并更新榜单；返回是否上榜
+    bool addEntry(const HighScoreEntry& entry) { return submitToBoard(appendRecord(entry)); }
 
-    // 检查分数是否能上榜
-    bool isHighScore(int score) const;
+    // 检查分数是否能上 (关卡, 模式) 的榜
+    bool isHighScore(const std::string& level, uint8_t mode, int score) const;
 
     // 获取排名（1-10，0表示未上榜）
-    int getRank(int score) const;
+    int getRank(const std::string& level, uint8_t mode, int score) const;
 
-    // 获取所有记录
-    const std::vector<HighScoreEntry>& getEntries() const { return entries; }
+    // 获取某个榜单的记录（按名次排列）
+    const std::vector<HighScoreEntry>& getEntries(const std::string& level, uint8_t mode) const;
 
-    // 获取最高分
-    int getHighestScore() const;
+    // 获取最高分（某个榜单 / 全部）
+    int getHighestScore(const std::string& level, uint8_t mode) const;
+    int getHighestScore() const { return bestScore; }
 
-    // 清除所有记录
+    // 清除所有记录（包括历史）
     void clear();
 
-    // 获取记录数量
-    int getCount() const { return static_cast<int>(entries.size()); }
+    // 历史记录总数
+    size_t getTotalRecords() const { return totalRecords; }
 
 private:
+    // 加载 .dat 和 .log（构造时在游戏线程执行，此时 I/O 线程还没启动）
+    void load();
+    void importLegacyJson();
+    // 放进对应榜单的堆里，返回是否上榜（ranked 由调用者刷新）
+    bool insert(const HighScoreEntry& entry);
+    static void rankBoard(Board& board);
+    const Board* findBoard(const std::string& level, uint8_t mode) const;
+
+    // I/O 线程
+    void ioLoop();
+    bool appendRecords(const std::vector<uint8_t>& records, size_t count);
+    bool compact(const std::vector<uint8_t>& extraRecords);
+    bool resetFiles(uint64_t seqFloor);
+    bool resetLog();
+
     // 确保目录存在
     void ensureDirectory() const;
-    std::string getFullPath() const;
+    std::string getFullPath(const char* extension) const;
 };
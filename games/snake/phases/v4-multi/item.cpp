@@ -1,113 +1,76 @@
 #include "item.h"
-#include "snake.h"
-#include "game.h"
-#include <cmath>
 
-// ============================================================
-// Item 基类实现
-// ============================================================
-Item::Item(int x, int y, float lifetime)
-    : x(x), y(y), lifetime(lifetime), expired(false) {
-}
+ItemType rollItemType(SimRandom& rng) {
+    int roll = rng.range(1, 100);
 
-void Item::update(float deltaTime) {
-    if (lifetime > 0) {
-        lifetime -= deltaTime;
-        if (lifetime <= 0) {
-            expired = true;
+    // 按表里的顺序累加权重
+    int threshold = 0;
+    for (int i = 0; i < ITEM_TYPE_COUNT - 1; i++) {
+        threshold += ITEM_TRAITS[i].weight;
+        if (roll <= threshold) {
+            return static_cast<ItemType>(i);
         }
     }
-}
-
-void Item::draw(int gridSize) const {
-    Color c = getColor();
-    DrawRectangle(x * gridSize + 2, y * gridSize + 2,
-                  gridSize - 4, gridSize - 4, c);
+    return static_cast<ItemType>(ITEM_TYPE_COUNT - 1);
 }
 
 // ============================================================
-// NormalFood 实现
+// ItemPool 实现
 // ============================================================
-NormalFood::NormalFood(int x, int y) : Item(x, y, -1.0f) {
-}
-
-void NormalFood::onEat(Snake& snake, Game& game) {
-    snake.grow(1);
-    game.addScore(getScore());
+ItemPool::ItemPool(int w, int h)
+    : count(0), width(w), height(h) {
+    clear();
 }
 
-// ============================================================
-// GoldenFood 实现
-// ============================================================
-GoldenFood::GoldenFood(int x, int y) : Item(x, y, 5.0f) { // 5秒后消失
-}
-
-void GoldenFood::onEat(Snake& snake, Game& game) {
-    snake.grow(3);
-    game.addScore(getScore());
+void ItemPool::clear() {
+    for (auto& slot : cellIndex) {
+        slot.cell = -1;
+    }
+    count = 0;
 }
 
-void GoldenFood::draw(int gridSize) const {
-    // 金色食物闪烁效果
-    float flash = (sin(GetTime() * 10) + 1.0f) * 0.5f; // 0~1 闪烁
-    Color c = ColorAlpha(GOLD, 0.7f + flash * 0.3f);
-
-    // 外圈
-    DrawRectangle(x * gridSize + 1, y * gridSize + 1,
-                  gridSize - 2, gridSize - 2, c);
-    // 内圈
-    DrawRectangle(x * gridSize + 4, y * gridSize + 4,
-                  gridSize - 8, gridSize - 8, WHITE);
-}
+int ItemPool::spawn(ItemType type, int x, int y) {
+    if (full() || x < 0 || x >= width || y < 0 || y >= height) return -1;
 
-// ============================================================
-// SpeedUpFood 实现
-// ============================================================
-SpeedUpFood::SpeedUpFood(int x, int y) : Item(x, y, -1.0f) {
-}
+    const int32_t cell = y * width + x;
+    int slot = homeSlot(cell);
+    for (; cellIndex[slot].cell >= 0; slot = (slot + 1) & (INDEX_SIZE - 1)) {
+        if (cellIndex[slot].cell == cell) return -1;
+    }
 
-void SpeedUpFood::onEat(Snake& snake, Game& game) {
-    snake.grow(1);
-    game.addScore(getScore());
-    game.applySpeedEffect(0.5f, 5.0f); // 速度减半（更快）
+    int i = count++;
+    items[i] = Item(type, x, y);
+    cellIndex[slot] = {cell, i};
+    return i;
 }
 
-// ============================================================
-// SlowDownFood 实现
-// ============================================================
-SlowDownFood::SlowDownFood(int x, int y) : Item(x, y, -1.0f) {
-}
+void ItemPool::remove(int i) {
+    eraseSlot(findSlot(cellOf(items[i])));
 
-void SlowDownFood::onEat(Snake& snake, Game& game) {
-    snake.grow(1);
-    game.addScore(getScore());
-    game.applySpeedEffect(2.0f, 5.0f); // 速度加倍（更慢）
+    int last = --count;
+    if (i != last) {
+        items[i] = items[last];
+        cellIndex[findSlot(cellOf(items[i]))].item = i;
+    }
 }
 
-// ============================================================
-// ItemFactory 实现
-// ============================================================
-std::unique_ptr<Item> ItemFactory::createRandomItem(int x, int y) {
-    int type = GetRandomValue(0, 3);
-    switch (type) {
-        case 0: return std::make_unique<NormalFood>(x, y);
-        case 1: return std::make_unique<GoldenFood>(x, y);
-        case 2: return std::make_unique<SpeedUpFood>(x, y);
-        case 3: return std::make_unique<SlowDownFood>(x, y);
-        default: return std::make_unique<NormalFood>(x, y);
+int ItemPool::findSlot(int32_t cell) const {
+    for (int slot = homeSlot(cell); cellIndex[slot].cell >= 0; slot = (slot + 1) & (INDEX_SIZE - 1)) {
+        if (cellIndex[slot].cell == cell) return slot;
     }
+    return -1;
 }
 
-std::unique_ptr<Item> ItemFactory::createWeightedItem(int x, int y) {
-    int roll = GetRandomValue(1, 100);
-
-    if (roll <= 70) {
-        return std::make_unique<NormalFood>(x, y);
-    } else if (roll <= 80) {
-        return std::make_unique<GoldenFood>(x, y);
-    } else if (roll <= 92) {
-        return std::make_unique<SpeedUpFood>(x, y);
-    } else {
-        return std::make_unique<SlowDownFood>(x, y);
+void ItemPool::eraseSlot(int slot) {
+    // 后移补位：空洞之后同一条探测链上的项，如果它的起始槽不在 (空洞, 当前位置] 之间就挪进空洞
+    const int mask = INDEX_SIZE - 1;
+    int hole = slot;
+    for (int j = (slot + 1) & mask; cellIndex[j].cell >= 0; j = (j + 1) & mask) {
+        int home = homeSlot(cellIndex[j].cell);
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            cellIndex[hole] = cellIndex[j];
+            hole = j;
+        }
     }
+    cellIndex[hole].cell = -1;
 }
@@ -1,119 +1,150 @@
 #pragma once
-#include "raylib.h"
-#include <memory>
-#include <string>
+#include "sim_random.h"
+#include <cstddef>
+#include <cstdint>
 
-// 前向声明
-class Snake;
-class Game;
-
-// 食物类型枚举
-enum class ItemType {
+// 食物类型枚举（同时是 ITEM_TRAITS 的下标）
+enum class ItemType : uint8_t {
     NORMAL,     // 普通食物
     GOLDEN,     // 金色食物（高分，限时）
     SPEED_UP,   // 加速
     SLOW_DOWN   // 减速
 };
 
+constexpr int ITEM_TYPE_COUNT = 4;
+
+// ============================================================
+// 道具属性表 - 编译期常量，按 ItemType 查表代替虚函数
+// ============================================================
+// 吃道具的效果全部由这张表描述：长 growth 节、加 score 分，
+// effectDuration > 0 时再施加 speedMultiplier 倍的移动间隔。
+struct ItemTraits {
+    const char* name;       // 显示名称
+    int score;              // 分数
+    int growth;             // 增长节数
+    float lifetime;         // 存在时间（秒），<0 表示永久
+    float speedMultiplier;  // 移动间隔倍数（<1 更快）
+    float effectDuration;   // 速度效果持续时间（秒），0 表示没有
+    int weight;             // 生成权重（百分比，合计 100）
+};
+
+inline constexpr ItemTraits ITEM_TRAITS[ITEM_TYPE_COUNT] = {
+    //  名称         分数  增长  存在时间  速度倍数  效果时间  权重
+    {"普通食物",     10,   1,   -1.0f,   1.0f,    0.0f,   70},
+    {"金色食物",     50,   3,    5.0f,   1.0f,    0.0f,   10},
+    {"加速食物",     15,   1,   -1.0f,   0.5f,    5.0f,   12},   // 速度减半（更快）
+    {"减速食物",     20,   1,   -1.0f,   2.0f,    5.0f,    8},   // 速度加倍（更慢）
+};
+
+constexpr const ItemTraits& getItemTraits(ItemType type) {
+    return ITEM_TRAITS[static_cast<size_t>(type)];
+}
+
+// 道具类型的显示名称（前端处理吃道具事件时道具可能已被替换）
+inline const char* getItemTypeName(ItemType type) { return getItemTraits(type).name; }
+
+// 按权重随机选一种道具类型：普通 70%，金色 10%，加速 12%，减速 8%
+ItemType rollItemType(SimRandom& rng);
+
 // ============================================================
-// 道具基类 - 使用多态实现不同效果
+// 道具 - 带类型标签的值类型
 // ============================================================
+// 属于模拟核心，不依赖 raylib；颜色和绘制由 Game 按 ItemType 决定。
+// 没有虚函数、不单独分配，直接存放在 ItemPool 的固定数组里。
 class Item {
-protected:
+private:
     int x, y;           // 位置
     float lifetime;     // 剩余生命周期（秒）
+    ItemType type;
     bool expired;       // 是否已过期
 
 public:
-    Item(int x, int y, float lifetime = -1.0f);
-    virtual ~Item() = default;
-
-    // 纯虚函数 - 子类必须实现
-    virtual void onEat(Snake& snake, Game& game) = 0;
-    virtual Color getColor() const = 0;
-    virtual int getScore() const = 0;
-    virtual ItemType getType() const = 0;
-    virtual std::string getName() const = 0;
-    virtual float getEffectDuration() const { return 0.0f; }
-
-    // 通用方法
-    void update(float deltaTime);
+    Item() : x(0), y(0), lifetime(-1.0f), type(ItemType::NORMAL), expired(false) {}
+    Item(ItemType type, int x, int y)
+        : x(x), y(y), lifetime(getItemTraits(type).lifetime), type(type), expired(false) {}
+
+    void update(float deltaTime) {
+        if (lifetime > 0) {
+            lifetime -= deltaTime;
+            if (lifetime <= 0) {
+                expired = true;
+            }
+        }
+    }
+
+    ItemType getType() const { return type; }
+    const ItemTraits& getTraits() const { return getItemTraits(type); }
+    const char* getName() const { return getTraits().name; }
+    int getScore() const { return getTraits().score; }
+    float getEffectDuration() const { return getTraits().effectDuration; }
+
     bool isExpired() const { return expired; }
     float getRemainingLife() const { return lifetime; }
+    void setRemainingLife(float life) { lifetime = life; expired = false; }
 
     int getX() const { return x; }
     int getY() const { return y; }
-
-    // 绘制食物（可被子类重写）
-    virtual void draw(int gridSize) const;
 };
 
 // ============================================================
-// 具体食物类型
+// 道具池 - 固定容量的稠密数组 + 格子到下标的索引
 // ============================================================
-
-// 普通食物
-class NormalFood : public Item {
+// 同屏最多 MAX_ITEMS 个道具（道具冲刺模式同时有几十个）。
+// 生成追加到末尾，移除与末尾交换后弹出，都不分配内存；
+// 格子到下标的索引是容量固定的开放寻址哈希表（线性探测，删除时后移补位），
+// 内存与地图大小无关，按格子查道具平均 O(1)，吃道具检测是 O(1)。
+// 迭代顺序只取决于生成/移除的操作序列，快照按这个顺序保存即可复现。
+class ItemPool {
 public:
-    NormalFood(int x, int y);
+    static constexpr int MAX_ITEMS = 64;
+    static constexpr int INDEX_SIZE = MAX_ITEMS * 2;    // 2 的幂，装载率不超过一半
 
-    void onEat(Snake& snake, Game& game) override;
-    Color getColor() const override { return RED; }
-    int getScore() const override { return 10; }
-    ItemType getType() const override { return ItemType::NORMAL; }
-    std::string getName() const override { return "普通食物"; }
-};
-
-// 金色食物（限时，高分）
-class GoldenFood : public Item {
-public:
-    GoldenFood(int x, int y);
-
-    void onEat(Snake& snake, Game& game) override;
-    Color getColor() const override { return GOLD; }
-    int getScore() const override { return 50; }
-    ItemType getType() const override { return ItemType::GOLDEN; }
-    std::string getName() const override { return "金色食物"; }
-
-    // 金色食物有闪烁效果
-    void draw(int gridSize) const override;
-};
-
-// 加速食物
-class SpeedUpFood : public Item {
-public:
-    SpeedUpFood(int x, int y);
-
-    void onEat(Snake& snake, Game& game) override;
-    Color getColor() const override { return SKYBLUE; }
-    int getScore() const override { return 15; }
-    ItemType getType() const override { return ItemType::SPEED_UP; }
-    std::string getName() const override { return "加速食物"; }
-    float getEffectDuration() const override { return 5.0f; } // 5秒效果
-};
+private:
+    struct IndexSlot {
+        int32_t cell;   // 格子线性下标，-1 表示空槽
+        int32_t item;   // items 中的下标
+    };
 
-// 减速食物
-class SlowDownFood : public Item {
-public:
-    SlowDownFood(int x, int y);
-
-    void onEat(Snake& snake, Game& game) override;
-    Color getColor() const override { return PURPLE; }
-    int getScore() const override { return 20; }
-    ItemType getType() const override { return ItemType::SLOW_DOWN; }
-    std::string getName() const override { return "减速食物"; }
-    float getEffectDuration() const override { return 5.0f; }
-};
+    Item items[MAX_ITEMS];
+    int count;
+    IndexSlot cellIndex[INDEX_SIZE];
+    int width, height;
 
-// ============================================================
-// 食物工厂 - 使用工厂模式创建不同类型的食物
-// ============================================================
-class ItemFactory {
 public:
-    // 随机创建一种食物
-    static std::unique_ptr<Item> createRandomItem(int x, int y);
-
-    // 按概率创建食物
-    // 普通: 70%, 金色: 10%, 加速: 12%, 减速: 8%
-    static std::unique_ptr<Item> createWeightedItem(int x, int y);
+    ItemPool(int w, int h);
+
+    // 清空（索引表是固定大小，O(1)）
+    void clear();
+
+    // 在 (x, y) 生成道具，返回下标；池满、越界或格子已有道具时返回 -1
+    int spawn(ItemType type, int x, int y);
+    // 移除第 i 个道具；末尾的道具会换到位置 i
+    void remove(int i);
+
+    // (x, y) 上道具的下标，没有时返回 -1
+    int findAt(int x, int y) const {
+        if (x < 0 || x >= width || y < 0 || y >= height) return -1;
+        int slot = findSlot(y * width + x);
+        return slot >= 0 ? cellIndex[slot].item : -1;
+    }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == MAX_ITEMS; }
+
+    Item& at(int i) { return items[i]; }
+    const Item& at(int i) const { return items[i]; }
+
+    const Item* begin() const { return items; }
+    const Item* end() const { return items + count; }
+
+private:
+    static_assert(INDEX_SIZE == 128, "homeSlot 取乘积的高 7 位");
+    static int homeSlot(int32_t cell) {
+        return static_cast<int>((static_cast<uint32_t>(cell) * 0x9E3779B1u) >> 25);
+    }
+    int cellOf(const Item& item) const { return item.getY() * width + item.getX(); }
+    // cell 所在的槽，没有时返回 -1
+    int findSlot(int32_t cell) const;
+    void eraseSlot(int slot);
 };
@@ -0,0 +1,470 @@
+#include "json.h"
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+// 4 位十六进制
+bool parseHex4(std::string_view s, size_t at, unsigned& out) {
+    if (at + 4 > s.size()) return false;
+    out = 0;
+    for (size_t i = at; i < at + 4; i++) {
+        char c = s[i];
+        out <<= 4;
+        if (c >= '0' && c <= '9') out |= c - '0';
+        else if (c >= 'a' && c <= 'f') out |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') out |= c - 'A' + 10;
+        else return false;
+    }
+    return true;
+}
+
+void appendUtf8(std::string& out, unsigned cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+} // namespace
+
+// ============================================================
+// JsonWriter 实现
+// ============================================================
+void JsonWriter::separate() {
+    if (needComma) out += ',';
+}
+
+void JsonWriter::writeString(std::string_view s) {
+    static const char HEX[] = "0123456789abcdef";
+
+    out += '"';
+    size_t runStart = 0;
+    for (size_t i = 0; i < s.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        // 不需要转义的一段整体追加
+        out.append(s.data() + runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default:
+                out += "\\u00";
+                out += HEX[c >> 4];
+                out += HEX[c & 0xF];
+                break;
+        }
+    }
+    out.append(s.data() + runStart, s.size() - runStart);
+    out += '"';
+}
+
+void JsonWriter::beginObject() {
+    separate();
+    out += '{';
+    needComma = false;
+}
+
+void JsonWriter::endObject() {
+    out += '}';
+    needComma = true;
+}
+
+void JsonWriter::beginArray() {
+    separate();
+    out += '[';
+    needComma = false;
+}
+
+void JsonWriter::endArray() {
+    out += ']';
+    needComma = true;
+}
+
+void JsonWriter::key(std::string_view name) {
+    separate();
+    writeString(name);
+    out += ':';
+    needComma = false;
+}
+
+void JsonWriter::value(int v) {
+    separate();
+    char buf[16];
+    auto result = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, result.ptr);
+    needComma = true;
+}
+
+void JsonWriter::value(float v) {
+    separate();
+    if (!std::isfinite(v)) v = 0.0f;    // JSON 没有 NaN/Inf
+    char buf[32];
+    int len = snprintf(buf, sizeof(buf), "%.6g", v);
+    out.append(buf, len);
+    needComma = true;
+}
+
+void JsonWriter::value(bool v) {
+    separate();
+    out += v ? "true" : "false";
+    needComma = true;
+}
+
+void JsonWriter::value(std::string_view v) {
+    separate();
+    writeString(v);
+    needComma = true;
+}
+
+// ============================================================
+// JsonReader 实现
+// ============================================================
+JsonReader::JsonReader(std::string_view json)
+    : text(json), pos(0), expectFirst(false), failed(false), errorPos(0), errorReason("") {
+}
+
+void JsonReader::fail(const char* reason) {
+    if (failed) return;     // 只保留第一个错误
+    failed = true;
+    errorPos = pos;
+    errorReason = reason;
+}
+
+std::string JsonReader::getError() const {
+    if (!failed) return "";
+
+    int line = 1;
+    int column = 1;
+    for (size_t i = 0; i < errorPos && i < text.size(); i++) {
+        if (text[i] == '\n') {
+            line++;
+            column = 1;
+        } else {
+            column++;
+        }
+    }
+
+    char buf[128];
+    snprintf(buf, sizeof(buf), "第 %d 行第 %d 列: ", line, column);
+    return buf + std::string(errorReason);
+}
+
+void JsonReader::skipWhitespace() {
+    while (pos < text.size()) {
+        char c = text[pos];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') break;
+        pos++;
+    }
+}
+
+bool JsonReader::consume(char c) {
+    if (pos < text.size() && text[pos] == c) {
+        pos++;
+        return true;
+    }
+    return false;
+}
+
+bool JsonReader::expect(char c, const char* reason) {
+    if (consume(c)) return true;
+    fail(reason);
+    return false;
+}
+
+bool JsonReader::scanString(std::string_view& raw) {
+    skipWhitespace();
+    if (!expect('"', "期望字符串")) return false;
+
+    size_t start = pos;
+    while (pos < text.size()) {
+        unsigned char c = static_cast<unsigned char>(text[pos]);
+        if (c == '"') {
+            raw = text.substr(start, pos - start);
+            pos++;
+            return true;
+        }
+        if (c < 0x20) {
+            fail("字符串中有未转义的控制字符");
+            return false;
+        }
+        pos += (c == '\\') ? 2 : 1;
+    }
+
+    pos = start;
+    fail("字符串没有结束");
+    return false;
+}
+
+bool JsonReader::scanNumber(double& result) {
+    skipWhitespace();
+    const size_t start = pos;
+    const bool negative = consume('-');
+
+    auto isDigit = [this]() { return pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; };
+
+    if (!isDigit()) {
+        pos = start;
+        fail("期望数字");
+        return false;
+    }
+
+    double value = 0.0;
+    while (isDigit()) {
+        value = value * 10.0 + (text[pos++] - '0');
+    }
+
+    if (consume('.')) {
+        if (!isDigit()) {
+            fail("小数点后缺少数字");
+            return false;
+        }
+        double scale = 1.0;
+        while (isDigit()) {
+            value = value * 10.0 + (text[pos++] - '0');
+            scale *= 10.0;
+        }
+        value /= scale;
+    }
+
+    if (consume('e') || consume('E')) {
+        bool negativeExp = consume('-');
+        if (!negativeExp) consume('+');
+        if (!isDigit()) {
+            fail("指数缺少数字");
+            return false;
+        }
+        int exponent = 0;
+        while (isDigit()) {
+            exponent = std::min(exponent * 10 + (text[pos++] - '0'), 400);
+        }
+        value *= std::pow(10.0, negativeExp ? -exponent : exponent);
+    }
+
+    result = negative ? -value : value;
+    return true;
+}
+
+bool JsonReader::scanLiteral(std::string_view literal) {
+    skipWhitespace();
+    if (text.substr(pos, literal.size()) == literal) {
+        pos += literal.size();
+        return true;
+    }
+    return false;
+}
+
+bool JsonReader::beginObject() {
+    if (failed) return false;
+    skipWhitespace();
+    if (!expect('{', "期望 '{'")) return false;
+    expectFirst = true;
+    return true;
+}
+
+bool JsonReader::beginArray() {
+    if (failed) return false;
+    skipWhitespace();
+    if (!expect('[', "期望 '['")) return false;
+    expectFirst = true;
+    return true;
+}
+
+bool JsonReader::nextInContainer(char close) {
+    if (failed) return false;
+    skipWhitespace();
+
+    // 容器结束后回到上一层，上一层的下一个元素前面要有逗号
+    if (consume(close)) {
+        expectFirst = false;
+        return false;
+    }
+    if (!expectFirst && !expect(',', close == '}' ? "期望 ',' 或 '}'" : "期望 ',' 或 ']'")) {
+        return false;
+    }
+    expectFirst = false;
+    return true;
+}
+
+bool JsonReader::nextKey(std::string_view& key) {
+    if (!nextInContainer('}')) return false;
+    if (!scanString(key)) return false;
+    skipWhitespace();
+    return expect(':', "期望 ':'");
+}
+
+bool JsonReader::nextElement() {
+    return nextInContainer(']');
+}
+
+int JsonReader::readInt() {
+    if (failed) return 0;
+    double value = 0.0;
+    if (!scanNumber(value)) return 0;
+    if (value < INT_MIN || value > INT_MAX || value != std::floor(value)) {
+        fail("期望整数");
+        return 0;
+    }
+    return static_cast<int>(value);
+}
+
+float JsonReader::readFloat() {
+    if (failed) return 0.0f;
+    double value = 0.0;
+    if (!scanNumber(value)) return 0.0f;
+    return static_cast<float>(value);
+}
+
+bool JsonReader::readBool() {
+    if (failed) return false;
+    if (scanLiteral("true")) return true;
+    if (scanLiteral("false")) return false;
+    fail("期望 true 或 false");
+    return false;
+}
+
+std::string_view JsonReader::readRawString() {
+    if (failed) return {};
+    std::string_view raw;
+    if (!scanString(raw)) return {};
+    return raw;
+}
+
+std::string JsonReader::readString() {
+    std::string_view raw = readRawString();
+    std::string result;
+    if (!failed && !unescape(raw, result)) {
+        fail("无效的转义序列");
+        result.clear();
+    }
+    return result;
+}
+
+void JsonReader::skipValue() {
+    skipValue(0);
+}
+
+void JsonReader::skipValue(int depth) {
+    if (failed) return;
+    if (depth > MAX_DEPTH) {
+        fail("嵌套过深");
+        return;
+    }
+
+    skipWhitespace();
+    if (pos >= text.size()) {
+        fail("意外的文件结尾");
+        return;
+    }
+
+    switch (text[pos]) {
+        case '{': {
+            beginObject();
+            std::string_view key;
+            while (nextKey(key)) skipValue(depth + 1);
+            break;
+        }
+        case '[':
+            beginArray();
+            while (nextElement()) skipValue(depth + 1);
+            break;
+        case '"':
+            readRawString();
+            break;
+        case 't':
+        case 'f':
+            readBool();
+            break;
+        case 'n':
+            if (!scanLiteral("null")) fail("无效的值");
+            break;
+        default: {
+            double ignored;
+            scanNumber(ignored);
+            break;
+        }
+    }
+}
+
+bool JsonReader::finish() {
+    if (failed) return false;
+    skipWhitespace();
+    if (pos != text.size()) fail("多余的内容");
+    return !failed;
+}
+
+bool JsonReader::unescape(std::string_view raw, std::string& out) {
+    out.clear();
+    out.reserve(raw.size());
+
+    size_t runStart = 0;
+    size_t i = 0;
+    while (i < raw.size()) {
+        if (raw[i] != '\\') {
+            i++;
+            continue;
+        }
+
+        out.append(raw.data() + runStart, i - runStart);
+        if (i + 1 >= raw.size()) return false;
+
+        char c = raw[i + 1];
+        i += 2;
+        switch (c) {
+            case '"':  out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/':  out += '/'; break;
+            case 'b':  out += '\b'; break;
+            case 'f':  out += '\f'; break;
+            case 'n':  out += '\n'; break;
+            case 'r':  out += '\r'; break;
+            case 't':  out += '\t'; break;
+            case 'u': {
+                unsigned cp;
+                if (!parseHex4(raw, i, cp)) return false;
+                i += 4;
+                // UTF-16 代理对
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    unsigned low;
+                    if (i + 1 >= raw.size() || raw[i] != '\\' || raw[i + 1] != 'u' ||
+                        !parseHex4(raw, i + 2, low) || low < 0xDC00 || low > 0xDFFF) {
+                        return false;
+                    }
+                    i += 6;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    return false;
+                }
+                appendUtf8(out, cp);
+                break;
+            }
+            default:
+                return false;
+        }
+        runStart = i;
+    }
+
+    out.append(raw.data() + runStart, raw.size() - runStart);
+    return true;
+}
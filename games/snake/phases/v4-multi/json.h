@@ -0,0 +1,111 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// ============================================================
+// JsonWriter / JsonReader - 单遍 JSON 读写（关卡、高分榜、设置共用）
+// ============================================================
+// JsonWriter 直接往 std::string 末尾追加，逗号自动处理，字符串按 JSON 规则转义。
+//
+// JsonReader 是拉取式的：调用者按自己期望的结构一边走一边取值，只扫描一遍，
+// 键和字符串在源文本上以 string_view 返回（零拷贝），只有真正要保存的字符串
+// 才解码成 std::string。未知的键用 skipValue() 跳过。
+//
+// 与 ByteReader 一样不抛异常：出错后所有读取返回默认值并置 failed，
+// 调用者最后检查 ok()，getError() 给出行号、列号和原因。
+//
+//   JsonReader r(text);
+//   if (r.beginObject()) {
+//       std::string_view key;
+//       while (r.nextKey(key)) {
+//           if (key == "name") name = r.readString();
+//           else r.skipValue();
+//       }
+//   }
+//   if (!r.ok()) puts(r.getError().c_str());
+
+class JsonWriter {
+private:
+    std::string& out;
+    bool needComma;     // 下一个值/键前面要不要加逗号
+
+    void separate();
+    void writeString(std::string_view s);
+
+public:
+    explicit JsonWriter(std::string& buffer) : out(buffer), needComma(false) {}
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    void key(std::string_view name);
+
+    void value(int v);
+    void value(float v);
+    void value(bool v);
+    void value(std::string_view v);
+    void value(const char* v) { value(std::string_view(v)); }
+    void value(const std::string& v) { value(std::string_view(v)); }
+
+    // key + value
+    template <typename T>
+    void field(std::string_view name, const T& v) {
+        key(name);
+        value(v);
+    }
+};
+
+class JsonReader {
+private:
+    static constexpr int MAX_DEPTH = 64;    // skipValue 递归深度上限
+
+    std::string_view text;
+    size_t pos;
+    bool expectFirst;   // 刚进入容器，下一个元素前面没有逗号
+    bool failed;
+    size_t errorPos;
+    const char* errorReason;
+
+    void skipWhitespace();
+    bool consume(char c);
+    bool expect(char c, const char* reason);
+    bool scanString(std::string_view& raw);
+    bool scanNumber(double& result);
+    bool scanLiteral(std::string_view literal);
+    bool nextInContainer(char close);
+    void skipValue(int depth);
+
+public:
+    explicit JsonReader(std::string_view json);
+
+    bool beginObject();
+    bool beginArray();
+
+    // 读下一个键；遇到 '}' 时消费它并返回 false
+    bool nextKey(std::string_view& key);
+    // 是否还有下一个数组元素；遇到 ']' 时消费它并返回 false
+    bool nextElement();
+
+    int readInt();
+    float readFloat();
+    bool readBool();
+    std::string readString();               // 解码转义
+    std::string_view readRawString();       // 不解码，零拷贝
+
+    void skipValue();
+
+    // 整个文本读完后调用：后面只能有空白
+    bool finish();
+
+    // 以调用者的身份报告错误（例如数值超出范围）
+    void fail(const char* reason);
+
+    bool ok() const { return !failed; }
+    std::string getError() const;
+
+    // 解码 JSON 字符串内容（不含两侧引号）
+    static bool unescape(std::string_view raw, std::string& out);
+};
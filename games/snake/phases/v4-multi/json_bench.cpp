@@ -0,0 +1,121 @@
+// ============================================================
+// json_bench - 关卡 JSON 解析吞吐量测试
+// ============================================================
+// 用法: snake-json-bench [最大墙壁数=160000]
+// 生成与 LevelData::toJson 结构相同的关卡，墙壁数从 1000 开始翻倍到最大值，
+// 用 JsonReader 解析并输出每面墙的平均耗时。解析是线性的，这一列应基本不变。
+#include "json.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Cell {
+    int x, y;
+};
+
+std::string makeLevel(int wallCount) {
+    std::string json;
+    JsonWriter w(json);
+    w.beginObject();
+    w.field("name", "bench \"walls\"");
+    w.field("author", "bench");
+    w.field("width", 1000);
+    w.field("height", 1000);
+    w.field("targetScore", 100);
+    w.key("walls");
+    w.beginArray();
+    for (int i = 0; i < wallCount; i++) {
+        w.beginObject();
+        w.field("x", i % 1000);
+        w.field("y", i / 1000);
+        w.endObject();
+    }
+    w.endArray();
+    w.key("spawnPoints");
+    w.beginArray();
+    w.beginObject();
+    w.field("x", 1);
+    w.field("y", 1);
+    w.endObject();
+    w.endArray();
+    w.endObject();
+    return json;
+}
+
+// 与 LevelData::fromJson 相同的读取方式
+bool parseLevel(const std::string& json, std::string& name, std::vector<Cell>& walls, std::string& error) {
+    walls.clear();
+    JsonReader r(json);
+    if (r.beginObject()) {
+        std::string_view key;
+        while (r.nextKey(key)) {
+            if (key == "name") {
+                name = r.readString();
+            } else if (key == "walls") {
+                if (!r.beginArray()) break;
+                while (r.nextElement()) {
+                    Cell c = {0, 0};
+                    if (r.beginObject()) {
+                        std::string_view field;
+                        while (r.nextKey(field)) {
+                            if (field == "x") c.x = r.readInt();
+                            else if (field == "y") c.y = r.readInt();
+                            else r.skipValue();
+                        }
+                    }
+                    walls.push_back(c);
+                }
+            } else {
+                r.skipValue();
+            }
+        }
+    }
+    if (!r.finish()) {
+        error = r.getError();
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int maxWalls = (argc > 1) ? std::atoi(argv[1]) : 160000;
+    if (maxWalls < 1000) maxWalls = 1000;
+
+    std::printf("%10s %12s %10s %12s\n", "墙壁数", "JSON 字节", "耗时(ms)", "ns/墙");
+
+    std::vector<Cell> walls;
+    std::string name;
+    std::string error;
+
+    for (int count = 1000; count <= maxWalls; count *= 2) {
+        const std::string json = makeLevel(count);
+
+        // 每档至少解析约 200 万面墙，减少计时误差
+        const int repeats = std::max(1, 2000000 / count);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeats; i++) {
+            if (!parseLevel(json, name, walls, error)) {
+                std::fprintf(stderr, "解析失败: %s\n", error.c_str());
+                return 1;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        if (static_cast<int>(walls.size()) != count || name != "bench \"walls\"") {
+            std::fprintf(stderr, "解析结果不一致\n");
+            return 1;
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(end - start).count() / repeats;
+        std::printf("%10d %12zu %10.3f %12.1f\n", count, json.size(), ms, ms * 1e6 / count);
+    }
+
+    return 0;
+}
@@ -1,121 +1,99 @@
 #include "level.h"
+#include "byte_stream.h"
+#include "durable_file.h"
+#include "json.h"
+#include "level_file.h"
+#include "mapped_file.h"
+#include <chrono>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <filesystem>
 #include <sys/stat.h>
 
 // ============================================================
 // LevelData 实现
 // ============================================================
-std::string LevelData::toJson() const {
-    std::stringstream ss;
-    ss << "{";
-    ss << "\"name\":\"" << name << "\",";
-    ss << "\"author\":\"" << author << "\",";
-    ss << "\"width\":" << width << ",";
-    ss << "\"height\":" << height << ",";
-    ss << "\"targetScore\":" << targetScore << ",";
-    
-    // 墙壁
-    ss << "\"walls\":[";
-    for (size_t i = 0; i < walls.size(); i++) {
-        if (i > 0) ss << ",";
-        ss << "{\"x\":" << walls[i].x << ",\"y\":" << walls[i].y << "}";
-    }
-    ss << "],";
-    
-    // 出生点
-    ss << "\"spawnPoints\":[";
-    for (size_t i = 0; i < spawnPoints.size(); i++) {
-        if (i > 0) ss << ",";
-        ss << "{\"x\":" << spawnPoints[i].x << ",\"y\":" << spawnPoints[i].y << "}";
+namespace {
+
+void writePositions(JsonWriter& w, const std::vector<Vector2>& positions) {
+    w.beginArray();
+    for (const Vector2& p : positions) {
+        w.beginObject();
+        w.field("x", static_cast<int>(p.x));
+        w.field("y", static_cast<int>(p.y));
+        w.endObject();
     }
-    ss << "]";
-    
-    ss << "}";
-    return ss.str();
+    w.endArray();
 }
 
-LevelData LevelData::fromJson(const std::string& json) {
-    LevelData level;
-    
-    // 简单解析
-    auto parseString = [&json](const std::string& key) -> std::string {
-        size_t pos = json.find("\"" + key + "\":");
-        if (pos != std::string::npos) {
-            pos += key.length() + 4;
-            size_t end = json.find("\"", pos);
-            return json.substr(pos, end - pos);
-        }
-        return "";
-    };
-    
-    auto parseInt = [&json](const std::string& key) -> int {
-        size_t pos = json.find("\"" + key + "\":");
-        if (pos != std::string::npos) {
-            pos += key.length() + 3;
-            size_t end = json.find(",", pos);
-            if (end == std::string::npos) end = json.find("}", pos);
-            return std::stoi(json.substr(pos, end - pos));
-        }
-        return 0;
-    };
-    
-    level.name = parseString("name");
-    level.author = parseString("author");
-    level.width = parseInt("width");
-    level.height = parseInt("height");
-    level.targetScore = parseInt("targetScore");
-    
-    // 解析墙壁
-    size_t wallsPos = json.find("\"walls\":");
-    if (wallsPos != std::string::npos) {
-        wallsPos += 9;
-        size_t wallsEnd = json.find("]", wallsPos);
-        std::string wallsStr = json.substr(wallsPos, wallsEnd - wallsPos);
-        
-        size_t pos = 0;
-        while ((pos = wallsStr.find("{", pos)) != std::string::npos) {
-            size_t end = wallsStr.find("}", pos);
-            std::string wall = wallsStr.substr(pos, end - pos + 1);
-            
-            size_t xPos = wall.find("\"x\":");
-            size_t yPos = wall.find("\"y\":");
-            if (xPos != std::string::npos && yPos != std::string::npos) {
-                int x = std::stoi(wall.substr(xPos + 4));
-                int y = std::stoi(wall.substr(yPos + 4));
-                level.walls.push_back({(float)x, (float)y});
+void readPositions(JsonReader& r, std::vector<Vector2>& positions) {
+    if (!r.beginArray()) return;
+    while (r.nextElement()) {
+        int x = 0;
+        int y = 0;
+        if (r.beginObject()) {
+            std::string_view key;
+            while (r.nextKey(key)) {
+                if (key == "x") x = r.readInt();
+                else if (key == "y") y = r.readInt();
+                else r.skipValue();
             }
-            pos = end + 1;
         }
+        positions.push_back({(float)x, (float)y});
     }
-    
-    // 解析出生点
-    size_t spawnPos = json.find("\"spawnPoints\":");
-    if (spawnPos != std::string::npos) {
-        spawnPos += 15;
-        size_t spawnEnd = json.find("]", spawnPos);
-        std::string spawnStr = json.substr(spawnPos, spawnEnd - spawnPos);
-        
-        size_t pos = 0;
-        while ((pos = spawnStr.find("{", pos)) != std::string::npos) {
-            size_t end = spawnStr.find("}", pos);
-            std::string spawn = spawnStr.substr(pos, end - pos + 1);
-            
-            size_t xPos = spawn.find("\"x\":");
-            size_t yPos = spawn.find("\"y\":");
-            if (xPos != std::string::npos && yPos != std::string::npos) {
-                int x = std::stoi(spawn.substr(xPos + 4));
-                int y = std::stoi(spawn.substr(yPos + 4));
-                level.spawnPoints.push_back({(float)x, (float)y});
-            }
-            pos = end + 1;
+}
+
+} // namespace
+
+std::string LevelData::toJson() const {
+    std::string json;
+    JsonWriter w(json);
+    w.beginObject();
+    w.field("name", name);
+    w.field("author", author);
+    w.field("width", width);
+    w.field("height", height);
+    w.field("targetScore", targetScore);
+
+    // 墙壁
+    w.key("walls");
+    writePositions(w, walls);
+
+    // 出生点
+    w.key("spawnPoints");
+    writePositions(w, spawnPoints);
+
+    w.endObject();
+    return json;
+}
+
+bool LevelData::fromJson(std::string_view json, LevelData& level, std::string& error) {
+    level = LevelData();
+
+    // 单遍解析：墙壁再多也只扫描一次
+    JsonReader r(json);
+    if (r.beginObject()) {
+        std::string_view key;
+        while (r.nextKey(key)) {
+            if (key == "name") level.name = r.readString();
+            else if (key == "author") level.author = r.readString();
+            else if (key == "width") level.width = r.readInt();
+            else if (key == "height") level.height = r.readInt();
+            else if (key == "targetScore") level.targetScore = r.readInt();
+            else if (key == "walls") readPositions(r, level.walls);
+            else if (key == "spawnPoints") readPositions(r, level.spawnPoints);
+            else r.skipValue();
         }
     }
-    
-    return level;
+
+    if (!r.finish()) {
+        error = r.getError();
+        return false;
+    }
+    return true;
 }
 
 bool LevelData::isValid() const {
@@ -126,14 +104,51 @@ bool LevelData::isValid() const {
 // ============================================================
 // LevelManager 实现
 // ============================================================
+namespace {
+
+// 文件里没写的字段用默认值补上；索引和完整关卡用同一套规则
+template <typename T>
+void applyDefaults(T& level, const std::filesystem::path& path) {
+    if (level.name.empty()) {
+        level.name = path.stem().string();
+    }
+    if (level.author.empty()) {
+        level.author = "Player";
+    }
+    if (level.targetScore <= 0) {
+        level.targetScore = 100;
+    }
+}
+
+bool readTextFile(const std::filesystem::path& path, std::string& text) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    text = buffer.str();
+    return !text.empty();
+}
+
+} // namespace
+
 LevelManager::LevelManager(const std::string& dir)
-    : levelsDir(dir), currentLevel(0) {
-    loadAllLevels();
+    : useStamp(0), levelsDir(dir), currentLevel(0) {
+    // 创建默认关卡
+    builtinLevel.name = "随机生成";
+    builtinLevel.author = "System";
+    builtinLevel.width = 40;
+    builtinLevel.height = 30;
+    builtinLevel.spawnPoints.push_back({20, 15});
+    builtinLevel.spawnPoints.push_back({10, 10});
+    // 预留好容量，getLevel 返回的引用在缓存填满前也不会因扩容失效
+    cache.reserve(LEVEL_CACHE_SIZE);
+    refresh();
 }
 
-bool LevelManager::loadLevel(int index) {
-    if (index >= 0 && index < static_cast<int>(levels.size())) {
-        currentLevel = index;
+bool LevelManager::loadLevel(int i) {
+    if (i >= 0 && i < static_cast<int>(index.size())) {
+        currentLevel = i;
         return true;
     }
     return false;
@@ -142,98 +157,223 @@ bool LevelManager::loadLevel(int index) {
 bool LevelManager::saveLevel(const LevelData& level, const std::string& filename) {
     ensureDirectory();
     
-    std::string fullPath = getFullPath(filename);
-    std::ofstream file(fullPath);
-    if (!file.is_open()) {
+    // .json 作为导出格式保留，其他一律存为 .lvl 二进制
+    std::vector<uint8_t> data;
+    if (std::filesystem::path(filename).extension() == ".json") {
+        const std::string json = level.toJson();
+        data.assign(json.begin(), json.end());
+    } else {
+        writeLevelFile(level, data);
+    }
+
+    // 原子替换：保存途中崩溃时旧文件还在，不会留下被索引拒绝的半截文件
+    if (!writeFileAtomic(getFullPath(filename), data.data(), data.size())) {
         return false;
     }
-    
-    file << level.toJson();
+
+    // 只有刚写的文件需要重新读取
+    refresh();
     return true;
 }
 
-bool LevelManager::loadAllLevels() {
+void LevelManager::refresh() {
     namespace fs = std::filesystem;
 
-    levels.clear();
     ensureDirectory();
-    
-    // 创建默认关卡
-    LevelData defaultLevel;
-    defaultLevel.name = "随机生成";
-    defaultLevel.author = "System";
-    defaultLevel.width = 40;
-    defaultLevel.height = 30;
-    defaultLevel.spawnPoints.push_back({20, 15});
-    defaultLevel.spawnPoints.push_back({10, 10});
-    levels.push_back(defaultLevel);
-
-    std::vector<fs::path> levelFiles;
-    try {
-        for (const auto& entry : fs::directory_iterator(levelsDir)) {
-            if (!entry.is_regular_file()) continue;
-            if (entry.path().extension() == ".json") {
-                levelFiles.push_back(entry.path());
+    auto startTime = std::chrono::steady_clock::now();
+
+    // 刷新后保持选中同一个文件
+    const std::string selectedFile = index.empty() ? std::string() : index[currentLevel].file;
+
+    std::unordered_map<std::string, size_t> known;
+    known.reserve(index.size());
+    for (size_t i = 1; i < index.size(); i++) {
+        known.emplace(index[i].file, i);
+    }
+
+    std::vector<LevelInfo> entries;
+    entries.reserve(index.size());
+    std::unordered_map<std::string, FileStamp> stillRejected;
+    int reread = 0;
+
+    std::error_code ec;
+    for (fs::directory_iterator it(levelsDir, ec), end; !ec && it != end; it.increment(ec)) {
+        const fs::directory_entry& entry = *it;
+        std::error_code statError;
+        if (!entry.is_regular_file(statError)) continue;
+        const fs::path ext = entry.path().extension();
+        if (ext != ".lvl" && ext != ".json") continue;
+
+        std::string file = entry.path().filename().string();
+        const int64_t modifiedTime = static_cast<int64_t>(entry.last_write_time(statError).time_since_epoch().count());
+        const uint64_t fileSize = static_cast<uint64_t>(entry.file_size(statError));
+        if (statError) continue;
+
+        // 修改时间和大小都没变，沿用旧条目
+        auto old = known.find(file);
+        if (old != known.end()) {
+            LevelInfo& info = index[old->second];
+            if (info.modifiedTime == modifiedTime && info.fileSize == fileSize) {
+                entries.push_back(std::move(info));
+                continue;
             }
         }
-    } catch (...) {
-        if (currentLevel >= static_cast<int>(levels.size())) {
-            currentLevel = 0;
+        auto rejected = rejectedFiles.find(file);
+        if (rejected != rejectedFiles.end() &&
+            rejected->second.modifiedTime == modifiedTime && rejected->second.fileSize == fileSize) {
+            stillRejected.emplace(std::move(file), rejected->second);
+            continue;
         }
-        return true;
+
+        LevelInfo info;
+        reread++;
+        if (!readInfo(entry.path(), info)) {
+            stillRejected.emplace(std::move(file), FileStamp{modifiedTime, fileSize});
+            continue;
+        }
+        info.file = std::move(file);
+        info.modifiedTime = modifiedTime;
+        info.fileSize = fileSize;
+        entries.push_back(std::move(info));
     }
 
-    std::sort(levelFiles.begin(), levelFiles.end());
+    // 已删除的无效文件不再记着
+    rejectedFiles = std::move(stillRejected);
 
-    for (const auto& filePath : levelFiles) {
-        std::ifstream file(filePath);
-        if (!file.is_open()) continue;
+    std::sort(entries.begin(), entries.end(),
+              [](const LevelInfo& a, const LevelInfo& b) { return a.file < b.file; });
 
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        const std::string json = buffer.str();
-        if (json.empty()) continue;
+    LevelInfo builtin;
+    builtin.name = builtinLevel.name;
+    builtin.author = builtinLevel.author;
+    builtin.width = builtinLevel.width;
+    builtin.height = builtinLevel.height;
+    builtin.targetScore = builtinLevel.targetScore;
+    builtin.spawnCount = static_cast<int>(builtinLevel.spawnPoints.size());
+    entries.insert(entries.begin(), std::move(builtin));
+    index = std::move(entries);
 
-        try {
-            LevelData level = LevelData::fromJson(json);
-            if (level.name.empty()) {
-                level.name = filePath.stem().string();
-            }
-            if (level.author.empty()) {
-                level.author = "Player";
-            }
-            if (level.targetScore <= 0) {
-                level.targetScore = 100;
-            }
+    const int selected = findLevel(selectedFile);
+    currentLevel = selected >= 0 ? selected : 0;
 
-            if (!level.isValid()) {
-                continue;
-            }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    TraceLog(LOG_INFO, "LEVEL: 索引 %d 个关卡（重新读取 %d 个）用时 %.2f ms",
+             static_cast<int>(index.size()) - 1, reread, ms);
+}
 
-            if (level.width > 40 || level.height > 30) {
-                continue;
-            }
+int LevelManager::findLevel(const std::string& filename) const {
+    for (size_t i = 0; i < index.size(); i++) {
+        if (index[i].file == filename) return static_cast<int>(i);
+    }
+    return -1;
+}
 
-            levels.push_back(level);
-        } catch (...) {
-            continue;
+const LevelData& LevelManager::getLevel(int i) {
+    if (i <= 0 || i >= static_cast<int>(index.size())) {
+        return builtinLevel;
+    }
+    const LevelInfo& info = index[i];
+
+    // 文件改过后哈希不同，旧的缓存条目不会再命中，慢慢被挤出去
+    for (CachedLevel& cached : cache) {
+        if (cached.file == info.file && cached.contentHash == info.contentHash) {
+            cached.lastUsed = ++useStamp;
+            return cached.data;
         }
     }
 
-    if (currentLevel >= static_cast<int>(levels.size())) {
-        currentLevel = 0;
+    LevelData level;
+    if (!readLevel(info, level)) {
+        return builtinLevel;
     }
-    
+
+    CachedLevel* slot = nullptr;
+    if (cache.size() < LEVEL_CACHE_SIZE) {
+        cache.emplace_back();
+        slot = &cache.back();
+    } else {
+        slot = &*std::min_element(cache.begin(), cache.end(),
+            [](const CachedLevel& a, const CachedLevel& b) { return a.lastUsed < b.lastUsed; });
+    }
+    slot->file = info.file;
+    slot->contentHash = info.contentHash;
+    slot->data = std::move(level);
+    slot->lastUsed = ++useStamp;
+    return slot->data;
+}
+
+bool LevelManager::readInfo(const std::filesystem::path& path, LevelInfo& info) const {
+    std::string error;
+    if (path.extension() == ".lvl") {
+        // 二进制关卡：映射后只读头部、名称和作者，用不到的页不会读盘
+        MappedFile mapped;
+        if (!mapped.open(path.string())) return false;
+        if (!readLevelFileInfo(mapped.getData(), mapped.getSize(), info, error)) {
+            TraceLog(LOG_WARNING, "LEVEL: [%s] %s", path.string().c_str(), error.c_str());
+            return false;
+        }
+    } else {
+        // JSON 没有头部，只能整个解析一遍
+        std::string json;
+        if (!readTextFile(path, json)) return false;
+
+        LevelData level;
+        if (!LevelData::fromJson(json, level, error)) {
+            TraceLog(LOG_WARNING, "LEVEL: [%s] %s", path.string().c_str(), error.c_str());
+            return false;
+        }
+        info.name = std::move(level.name);
+        info.author = std::move(level.author);
+        info.width = level.width;
+        info.height = level.height;
+        info.targetScore = level.targetScore;
+        info.wallCount = static_cast<int>(level.walls.size());
+        info.spawnCount = static_cast<int>(level.spawnPoints.size());
+        info.contentHash = hashBytes(reinterpret_cast<const uint8_t*>(json.data()), json.size());
+    }
+
+    applyDefaults(info, path);
+
+    // 与 LevelData::isValid 相同的条件，外加地图尺寸上限
+    if (info.width <= 0 || info.height <= 0 || info.spawnCount < 1) {
+        return false;
+    }
+    if (info.width > ChunkedBitGrid::MAX_SIDE || info.height > ChunkedBitGrid::MAX_SIDE) {
+        return false;
+    }
+    return true;
+}
+
+bool LevelManager::readLevel(const LevelInfo& info, LevelData& level) const {
+    const std::filesystem::path path = getFullPath(info.file);
+    std::string error;
+    bool ok = false;
+
+    if (path.extension() == ".lvl") {
+        MappedFile mapped;
+        ok = mapped.open(path.string()) &&
+             readLevelFile(mapped.getData(), mapped.getSize(), level, error);
+    } else {
+        std::string json;
+        ok = readTextFile(path, json) && LevelData::fromJson(json, level, error);
+    }
+
+    if (!ok) {
+        // 索引之后文件被删或被改坏了，下次 refresh 会更新索引
+        TraceLog(LOG_WARNING, "LEVEL: [%s] 读取失败 %s", path.string().c_str(), error.c_str());
+        return false;
+    }
+    applyDefaults(level, path);
     return true;
 }
 
 void LevelManager::nextLevel() {
-    currentLevel = (currentLevel + 1) % static_cast<int>(levels.size());
+    currentLevel = (currentLevel + 1) % static_cast<int>(index.size());
 }
 
 void LevelManager::prevLevel() {
-    currentLevel = (currentLevel + static_cast<int>(levels.size()) - 1) % 
-                   static_cast<int>(levels.size());
+    currentLevel = (currentLevel + static_cast<int>(index.size()) - 1) % 
+                   static_cast<int>(index.size());
 }
 
 LevelData LevelManager::createNewLevel(const std::string& name) {
@@ -247,11 +387,11 @@ LevelData LevelManager::createNewLevel(const std::string& name) {
     return level;
 }
 
-bool LevelManager::deleteLevel(int index) {
-    if (index > 0 && index < static_cast<int>(levels.size())) {
-        levels.erase(levels.begin() + index);
-        if (currentLevel >= static_cast<int>(levels.size())) {
-            currentLevel = static_cast<int>(levels.size()) - 1;
+bool LevelManager::deleteLevel(int i) {
+    if (i > 0 && i < static_cast<int>(index.size())) {
+        index.erase(index.begin() + i);
+        if (currentLevel >= static_cast<int>(index.size())) {
+            currentLevel = static_cast<int>(index.size()) - 1;
         }
         return true;
     }
@@ -274,22 +414,65 @@ void LevelManager::ensureDirectory() const {
 // LevelEditor 实现
 // ============================================================
 LevelEditor::LevelEditor(int grid)
-    : baseGridSize(grid), gridSize(grid), offsetX(0), offsetY(0), 
-      isDirty(false), currentTool(Tool::WALL), selectedSpawnPoint(0) {
+    : camera(static_cast<float>(grid)), needsFit(true),
+      historyPos(0), savedPos(0), pending(), editing(false),
+      stroking(false), strokeX(0), strokeY(0),
+      currentTool(Tool::WALL), selectedSpawnPoint(0) {
 }
 
 void LevelEditor::newLevel(const std::string& name, int width, int height) {
-    editingLevel = LevelData();
-    editingLevel.name = name;
-    editingLevel.width = width;
-    editingLevel.height = height;
-    editingLevel.spawnPoints.push_back({static_cast<float>(width / 2), static_cast<float>(height / 2)});
-    isDirty = false;
+    LevelData level;
+    level.name = name;
+    level.width = width;
+    level.height = height;
+    level.spawnPoints.push_back({static_cast<float>(width / 2), static_cast<float>(height / 2)});
+    loadLevel(level);
 }
 
 void LevelEditor::loadLevel(const LevelData& level) {
     editingLevel = level;
-    isDirty = false;
+    editingLevel.walls.clear();
+    editingLevel.width = std::clamp(level.width, 1, ChunkedBitGrid::MAX_SIDE);
+    editingLevel.height = std::clamp(level.height, 1, ChunkedBitGrid::MAX_SIDE);
+
+    walls.reset(editingLevel.width, editingLevel.height);
+    for (const auto& wall : level.walls) {
+        walls.set(static_cast<int>(wall.x), static_cast<int>(wall.y), true);
+    }
+    wallMesh.reset(walls.getChunksX(), walls.getChunksY());
+
+    clearHistory();
+    stroking = false;
+    needsFit = true;
+}
+
+void LevelEditor::resizeLevel(int width, int height) {
+    width = std::clamp(width, 8, ChunkedBitGrid::MAX_SIDE);
+    height = std::clamp(height, 8, ChunkedBitGrid::MAX_SIDE);
+    if (width == editingLevel.width && height == editingLevel.height) {
+        return;
+    }
+
+    // 越界的墙壁在 loadLevel 里被丢掉，出生点挪回地图内
+    LevelData level = getLevel();
+    level.width = width;
+    level.height = height;
+    for (auto& spawn : level.spawnPoints) {
+        spawn.x = std::min(spawn.x, static_cast<float>(width - 1));
+        spawn.y = std::min(spawn.y, static_cast<float>(height - 1));
+    }
+    loadLevel(level);
+    // 撤销日志里的格子下标依赖宽度，尺寸变了只能清空，并且算作未保存
+    markDirty();
+}
+
+LevelData LevelEditor::getLevel() const {
+    LevelData level = editingLevel;
+    level.walls.reserve(walls.size());
+    walls.forEach([&level](int x, int y) {
+        level.walls.push_back({static_cast<float>(x), static_cast<float>(y)});
+    });
+    return level;
 }
 
 void LevelEditor::update() {
@@ -303,51 +486,91 @@ void LevelEditor::updateLayout(int screenWidth, int screenHeight) {
 
     const int availableWidth = std::max(1, screenWidth - sidePadding * 2);
     const int availableHeight = std::max(1, screenHeight - topPadding - bottomPadding);
-
-    const int fitWidth = std::max(1, availableWidth / std::max(1, editingLevel.width));
-    const int fitHeight = std::max(1, availableHeight / std::max(1, editingLevel.height));
-    gridSize = std::max(8, std::min({baseGridSize, fitWidth, fitHeight}));
-
-    const int pixelWidth = editingLevel.width * gridSize;
-    const int pixelHeight = editingLevel.height * gridSize;
-
-    offsetX = (screenWidth - pixelWidth) / 2;
-    offsetY = topPadding + (availableHeight - pixelHeight) / 2;
+    camera.setViewport({static_cast<float>(sidePadding), static_cast<float>(topPadding),
+                        static_cast<float>(availableWidth), static_cast<float>(availableHeight)});
+
+    if (needsFit) {
+        // 小地图整张放下；大地图先缩小到整张可见，之后滚轮放大、右键拖动
+        camera.setBoard(editingLevel.width, editingLevel.height);
+        camera.setZoomRange(1.0f, 4.0f);
+        camera.fit(1.0f);
+        needsFit = false;
+    }
 }
 
 void LevelEditor::draw(int screenWidth, int screenHeight, Font font) {
     updateLayout(screenWidth, screenHeight);
-    drawGrid();
-    drawLevel();
+
+    int x0, y0, x1, y1;
+    camera.getVisibleCells(x0, y0, x1, y1);
+
+    Rectangle view = camera.getViewport();
+    BeginScissorMode(static_cast<int>(view.x), static_cast<int>(view.y),
+                     static_cast<int>(view.width), static_cast<int>(view.height));
+    BeginMode2D(camera.get());
+    drawGrid(x0, y0, x1, y1);
+    drawWalls(x0, y0, x1, y1);
+    drawSpawnPoints();
+    EndMode2D();
+    EndScissorMode();
+
     drawToolbar(screenWidth, screenHeight, font);
 }
 
 void LevelEditor::handleInput() {
+    handleCameraInput();
     handleMouseInput();
     handleKeyboardInput();
 }
 
+void LevelEditor::handleCameraInput() {
+    Vector2 mousePos = GetMousePosition();
+
+    // 滚轮以鼠标位置为中心缩放
+    float wheel = GetMouseWheelMove();
+    if (wheel != 0.0f && camera.isInViewport(mousePos)) {
+        camera.zoomAt(mousePos, wheel > 0.0f ? 1.25f : 0.8f);
+    }
+
+    // 右键或中键拖动平移
+    if (IsMouseButtonDown(MOUSE_RIGHT_BUTTON) || IsMouseButtonDown(MOUSE_MIDDLE_BUTTON)) {
+        camera.pan(GetMouseDelta());
+    }
+
+    // 方向键平移
+    const float step = 600.0f * GetFrameTime();
+    Vector2 delta = {0.0f, 0.0f};
+    if (IsKeyDown(KEY_LEFT)) delta.x += step;
+    if (IsKeyDown(KEY_RIGHT)) delta.x -= step;
+    if (IsKeyDown(KEY_UP)) delta.y += step;
+    if (IsKeyDown(KEY_DOWN)) delta.y -= step;
+    if (delta.x != 0.0f || delta.y != 0.0f) {
+        camera.pan(delta);
+    }
+}
+
 void LevelEditor::handleMouseInput() {
+    Vector2 mousePos = GetMousePosition();
+    int x, y;
+    camera.screenToCell(mousePos, x, y);
+
     if (IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
-        Vector2 mousePos = GetMousePosition();
-        Vector2 gridPos = screenToGrid(static_cast<int>(mousePos.x), static_cast<int>(mousePos.y));
-        
-        int x = static_cast<int>(gridPos.x);
-        int y = static_cast<int>(gridPos.y);
-        
-        if (isInGrid(x, y)) {
-            switch (currentTool) {
-                case Tool::WALL:
-                    addWall(x, y);
-                    break;
-                case Tool::ERASE:
-                    removeWall(x, y);
-                    break;
-                case Tool::SPAWN_POINT:
-                    setSpawnPoint(x, y);
-                    break;
-            }
+        if (!stroking) {
+            // 只有在地图视口内按下才开始一笔
+            if (!camera.isInViewport(mousePos)) return;
+            // 一笔拖动从按下到松开只算一条命令
+            stroking = true;
+            beginEdit();
+            applyTool(x, y);
+        } else if (x != strokeX || y != strokeY) {
+            // 鼠标移动快时两帧之间会跨过好几格，按直线补齐
+            applyLine(strokeX, strokeY, x, y);
         }
+        strokeX = x;
+        strokeY = y;
+    } else if (stroking) {
+        stroking = false;
+        commitEdit();
     }
 }
 
@@ -361,39 +584,75 @@ void LevelEditor::handleKeyboardInput() {
         currentTool = Tool::SPAWN_POINT;
     }
     
-    // 清除所有
-    if (IsKeyPressed(KEY_C) && (IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_LEFT_SUPER))) {
-        editingLevel.walls.clear();
-        isDirty = true;
+    const bool ctrl = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_LEFT_SUPER);
+    if (!ctrl || stroking) {
+        return;
+    }
+
+    // 清除所有：作为一条命令，可以撤销
+    if (IsKeyPressed(KEY_C)) {
+        beginEdit();
+        const int width = editingLevel.width;
+        walls.forEach([this, width](int x, int y) {
+            editCells.push_back(static_cast<uint32_t>(y * width + x));
+        });
+        walls.clear();
+        wallMesh.invalidateAll();
+        commitEdit();
     }
-}
 
-void LevelEditor::drawGrid() {
-    for (int i = 0; i <= editingLevel.width; i++) {
-        int x = offsetX + i * gridSize;
-        DrawLine(x, offsetY, x, offsetY + editingLevel.height * gridSize, LIGHTGRAY);
+    // Ctrl+= / Ctrl+- 把地图尺寸加倍或减半
+    if (IsKeyPressed(KEY_EQUAL) || IsKeyPressed(KEY_KP_ADD)) {
+        resizeLevel(editingLevel.width * 2, editingLevel.height * 2);
+    } else if (IsKeyPressed(KEY_MINUS) || IsKeyPressed(KEY_KP_SUBTRACT)) {
+        resizeLevel(editingLevel.width / 2, editingLevel.height / 2);
     }
-    for (int i = 0; i <= editingLevel.height; i++) {
-        int y = offsetY + i * gridSize;
-        DrawLine(offsetX, y, offsetX + editingLevel.width * gridSize, y, LIGHTGRAY);
+
+    // Ctrl+Z 撤销，Ctrl+Y / Ctrl+Shift+Z 重做
+    if (IsKeyPressed(KEY_Z)) {
+        if (IsKeyDown(KEY_LEFT_SHIFT)) {
+            redo();
+        } else {
+            undo();
+        }
+    } else if (IsKeyPressed(KEY_Y)) {
+        redo();
     }
 }
 
-void LevelEditor::drawLevel() {
-    // 绘制墙壁
-    for (const auto& wall : editingLevel.walls) {
-        int x = offsetX + static_cast<int>(wall.x) * gridSize;
-        int y = offsetY + static_cast<int>(wall.y) * gridSize;
-        DrawRectangle(x, y, gridSize, gridSize, GRAY);
+void LevelEditor::drawGrid(int x0, int y0, int x1, int y1) {
+    // 世界坐标，只画可见范围内的线；缩得太小时网格线会糊成一片，只画边框
+    const float cell = camera.getCellSize();
+    const float pixelWidth = editingLevel.width * cell;
+    const float pixelHeight = editingLevel.height * cell;
+
+    if (camera.getCellPixels() >= GRID_LINE_MIN_PIXELS) {
+        for (int i = x0; i <= x1 + 1; i++) {
+            float x = i * cell;
+            DrawLineV({x, y0 * cell}, {x, std::min(pixelHeight, (y1 + 1) * cell)}, LIGHTGRAY);
+        }
+        for (int i = y0; i <= y1 + 1; i++) {
+            float y = i * cell;
+            DrawLineV({x0 * cell, y}, {std::min(pixelWidth, (x1 + 1) * cell), y}, LIGHTGRAY);
+        }
     }
-    
-    // 绘制出生点
+    DrawRectangleLinesEx({0.0f, 0.0f, pixelWidth, pixelHeight}, 1.0f / camera.get().zoom, DARKGRAY);
+}
+
+void LevelEditor::drawWalls(int x0, int y0, int x1, int y1) {
+    // 每块缓存的是合并后的矩形，空旷区域和大片墙壁都只需要几次绘制
+    const float cell = camera.getCellSize();
+    wallMesh.forEachRect(walls, x0, y0, x1, y1, [cell](const Rectangle& r) {
+        DrawRectangleRec({r.x * cell, r.y * cell, r.width * cell, r.height * cell}, GRAY);
+    });
+}
+
+void LevelEditor::drawSpawnPoints() {
+    const float cell = camera.getCellSize();
     for (size_t i = 0; i < editingLevel.spawnPoints.size(); i++) {
         const auto& spawn = editingLevel.spawnPoints[i];
-        int x = offsetX + static_cast<int>(spawn.x) * gridSize;
-        int y = offsetY + static_cast<int>(spawn.y) * gridSize;
         Color color = (static_cast<int>(i) == selectedSpawnPoint) ? GREEN : BLUE;
-        DrawCircle(x + gridSize/2, y + gridSize/2, gridSize/3, color);
+        DrawCircleV({(spawn.x + 0.5f) * cell, (spawn.y + 0.5f) * cell}, cell / 3.0f, color);
     }
 }
 
@@ -403,7 +662,7 @@ void LevelEditor::drawToolbar(int /* screenWidth */, int screenHeight, Font font
 
     DrawTextEx(font, currentToolName, {10.0f, 10.0f}, 20, 1.0f, DARKGRAY);
     
-    if (isDirty) {
+    if (hasUnsavedChanges()) {
         DrawTextEx(font, "*未保存", {100.0f, 10.0f}, 20, 1.0f, RED);
     }
     
@@ -412,44 +671,160 @@ void LevelEditor::drawToolbar(int /* screenWidth */, int screenHeight, Font font
                {10.0f, static_cast<float>(screenHeight - 30)}, 16, 1.0f, GRAY);
     DrawTextEx(font, TextFormat("尺寸: %dx%d", editingLevel.width, editingLevel.height),
                {200.0f, static_cast<float>(screenHeight - 30)}, 16, 1.0f, GRAY);
-    DrawTextEx(font, "ENTER 返回菜单  |  ESC 退出程序",
+    DrawTextEx(font, "滚轮缩放  右键拖动  Ctrl+=/- 调整尺寸  |  ENTER 返回菜单  |  ESC 退出程序",
                {10.0f, static_cast<float>(screenHeight - 50)}, 16, 1.0f, DARKGRAY);
 }
 
-Vector2 LevelEditor::screenToGrid(int screenX, int screenY) const {
-    int x = static_cast<int>(std::floor((screenX - offsetX) / static_cast<float>(gridSize)));
-    int y = static_cast<int>(std::floor((screenY - offsetY) / static_cast<float>(gridSize)));
-    return {(float)x, (float)y};
-}
-
 bool LevelEditor::isInGrid(int x, int y) const {
     return x >= 0 && x < editingLevel.width && y >= 0 && y < editingLevel.height;
 }
 
+void LevelEditor::flipCell(uint32_t cell) {
+    const int x = static_cast<int>(cell % editingLevel.width);
+    const int y = static_cast<int>(cell / editingLevel.width);
+    walls.set(x, y, !walls.get(x, y));
+    wallMesh.invalidateCell(x, y);
+}
+
 void LevelEditor::addWall(int x, int y) {
-    // 检查是否已存在
-    for (const auto& wall : editingLevel.walls) {
-        if ((int)wall.x == x && (int)wall.y == y) {
-            return;
-        }
+    if (walls.get(x, y)) {
+        return;
     }
-    editingLevel.walls.push_back({(float)x, (float)y});
-    isDirty = true;
+    uint32_t cell = static_cast<uint32_t>(y * editingLevel.width + x);
+    flipCell(cell);
+    editCells.push_back(cell);
 }
 
 void LevelEditor::removeWall(int x, int y) {
-    editingLevel.walls.erase(
-        std::remove_if(editingLevel.walls.begin(), editingLevel.walls.end(),
-            [x, y](const Vector2& w) { return (int)w.x == x && (int)w.y == y; }),
-        editingLevel.walls.end()
-    );
-    isDirty = true;
+    if (!walls.get(x, y)) {
+        return;     // 按住鼠标擦空格子时不记录
+    }
+    uint32_t cell = static_cast<uint32_t>(y * editingLevel.width + x);
+    flipCell(cell);
+    editCells.push_back(cell);
+}
+
+void LevelEditor::applyTool(int x, int y) {
+    if (!isInGrid(x, y)) {
+        return;
+    }
+    switch (currentTool) {
+        case Tool::WALL:
+            addWall(x, y);
+            break;
+        case Tool::ERASE:
+            removeWall(x, y);
+            break;
+        case Tool::SPAWN_POINT:
+            setSpawnPoint(x, y);
+            break;
+    }
+}
+
+void LevelEditor::applyLine(int x0, int y0, int x1, int y1) {
+    // Bresenham，起点上一帧已经处理过
+    const int dx = std::abs(x1 - x0);
+    const int dy = -std::abs(y1 - y0);
+    const int sx = x0 < x1 ? 1 : -1;
+    const int sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    while (x0 != x1 || y0 != y1) {
+        int e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+        applyTool(x0, y0);
+    }
+}
+
+void LevelEditor::beginEdit() {
+    // 新命令会丢弃所有可重做的记录
+    if (historyPos < static_cast<int>(history.size())) {
+        editCells.resize(historyPos > 0 ? history[historyPos - 1].cellEnd : 0);
+        history.resize(historyPos);
+        if (savedPos > historyPos) savedPos = -1;
+    }
+
+    pending.cellBegin = static_cast<uint32_t>(editCells.size());
+    pending.spawnIndex = -1;
+    editing = true;
+}
+
+void LevelEditor::commitEdit() {
+    if (!editing) {
+        return;
+    }
+    editing = false;
+    pending.cellEnd = static_cast<uint32_t>(editCells.size());
+
+    bool spawnMoved = pending.spawnIndex >= 0 &&
+        (pending.spawnBefore.x != pending.spawnAfter.x || pending.spawnBefore.y != pending.spawnAfter.y);
+    if (!spawnMoved) pending.spawnIndex = -1;
+    if (pending.cellEnd == pending.cellBegin && !spawnMoved) {
+        return;     // 什么都没改
+    }
+
+    history.push_back(pending);
+    historyPos++;
+
+    // 超出上限时丢掉最旧的一条，后面的格子下标整体前移
+    if (static_cast<int>(history.size()) > MAX_HISTORY) {
+        const uint32_t dropped = history.front().cellEnd;
+        editCells.erase(editCells.begin(), editCells.begin() + dropped);
+        history.erase(history.begin());
+        for (EditCommand& command : history) {
+            command.cellBegin -= dropped;
+            command.cellEnd -= dropped;
+        }
+        historyPos--;
+        savedPos = (savedPos > 0) ? savedPos - 1 : -1;
+    }
+}
+
+bool LevelEditor::undo() {
+    if (historyPos == 0) {
+        return false;
+    }
+    const EditCommand& command = history[--historyPos];
+    for (uint32_t i = command.cellBegin; i < command.cellEnd; i++) {
+        flipCell(editCells[i]);
+    }
+    if (command.spawnIndex >= 0) {
+        editingLevel.spawnPoints[command.spawnIndex] = command.spawnBefore;
+    }
+    return true;
+}
+
+bool LevelEditor::redo() {
+    if (historyPos == static_cast<int>(history.size())) {
+        return false;
+    }
+    const EditCommand& command = history[historyPos++];
+    for (uint32_t i = command.cellBegin; i < command.cellEnd; i++) {
+        flipCell(editCells[i]);
+    }
+    if (command.spawnIndex >= 0) {
+        editingLevel.spawnPoints[command.spawnIndex] = command.spawnAfter;
+    }
+    return true;
+}
+
+void LevelEditor::clearHistory() {
+    editCells.clear();
+    history.clear();
+    historyPos = 0;
+    savedPos = 0;
+    editing = false;
 }
 
 void LevelEditor::setSpawnPoint(int x, int y) {
     if (selectedSpawnPoint < static_cast<int>(editingLevel.spawnPoints.size())) {
-        editingLevel.spawnPoints[selectedSpawnPoint] = {(float)x, (float)y};
-        isDirty = true;
+        Vector2& spawn = editingLevel.spawnPoints[selectedSpawnPoint];
+        if (pending.spawnIndex < 0) {
+            pending.spawnIndex = selectedSpawnPoint;
+            pending.spawnBefore = spawn;
+        }
+        spawn = {(float)x, (float)y};
+        pending.spawnAfter = spawn;
     }
 }
 
@@ -1,6 +1,13 @@
 #pragma once
 #include "raylib.h"
+#include "board_camera.h"
+#include "chunk_grid.h"
+#include "chunk_mesh.h"
+#include <cstdint>
+#include <filesystem>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 // ============================================================
@@ -16,20 +23,61 @@ struct LevelData {
     
     LevelData() : width(40), height(30), targetScore(100) {}
     
-    // 序列化
+    // 序列化；解析失败时返回 false，error 为带行列号的原因
     std::string toJson() const;
-    static LevelData fromJson(const std::string& json);
+    static bool fromJson(std::string_view json, LevelData& level, std::string& error);
     
     // 验证关卡是否有效
     bool isValid() const;
 };
 
+// ============================================================
+// 关卡索引条目
+// ============================================================
+// 菜单只需要名称、作者和尺寸，墙壁等到真正开始游戏时才读取
+struct LevelInfo {
+    std::string file;           // levels/ 下的文件名，内置关卡为空
+    std::string name;
+    std::string author;
+    int width, height;
+    int targetScore;
+    int wallCount;
+    int spawnCount;
+    int64_t modifiedTime;       // 文件修改时间，没变就不再读取
+    uint64_t fileSize;
+    uint64_t contentHash;       // .lvl 为正文校验和，.json 为整个文件的哈希
+
+    LevelInfo()
+        : width(0), height(0), targetScore(0), wallCount(0), spawnCount(0),
+          modifiedTime(0), fileSize(0), contentHash(0) {}
+};
+
 // ============================================================
 // 关卡管理器
 // ============================================================
+// 内存里常驻的只有索引；refresh() 扫描目录时按修改时间和大小判断，
+// 只重新读取新增或改动过的文件的头部。完整关卡按需加载，
+// 最近用过的几个留在 LRU 缓存里，关卡再多菜单和保存也不会变慢。
 class LevelManager {
 private:
-    std::vector<LevelData> levels;
+    struct CachedLevel {
+        std::string file;
+        uint64_t contentHash;
+        LevelData data;
+        uint32_t lastUsed;
+    };
+    static constexpr size_t LEVEL_CACHE_SIZE = 8;
+
+    LevelData builtinLevel;         // 随机生成，始终是第 0 个
+    std::vector<LevelInfo> index;
+    std::vector<CachedLevel> cache;
+    struct FileStamp {
+        int64_t modifiedTime;
+        uint64_t fileSize;
+    };
+    // 无效文件 -> 修改时间和大小，都没变就不再读；每次刷新只保留磁盘上还在的
+    std::unordered_map<std::string, FileStamp> rejectedFiles;
+    uint32_t useStamp;
     std::string levelsDir;
     int currentLevel;
     
@@ -37,31 +85,36 @@ public:
     LevelManager(const std::string& dir = "levels/");
     
     // 加载和保存
-    bool loadLevel(int index);
+    bool loadLevel(int i);
     bool saveLevel(const LevelData& level, const std::string& filename);
-    bool loadAllLevels();
+    // 增量刷新索引
+    void refresh();
     
-    // 获取关卡
-    LevelData& getCurrentLevel() { return levels[currentLevel]; }
-    const LevelData& getLevel(int index) const { return levels[index]; }
-    int getLevelCount() const { return static_cast<int>(levels.size()); }
+    // 关卡元数据
+    const LevelInfo& getCurrentInfo() const { return index[currentLevel]; }
+    const LevelInfo& getInfo(int i) const { return index[i]; }
+    int getLevelCount() const { return static_cast<int>(index.size()); }
     int getCurrentIndex() const { return currentLevel; }
+    int findLevel(const std::string& filename) const;
+    
+    // 完整关卡，按需读取；文件读不出来时退回内置关卡
+    const LevelData& getCurrentLevel() { return getLevel(currentLevel); }
+    const LevelData& getLevel(int i);
     
     // 切换关卡
-    void setCurrentLevel(int index) { currentLevel = index; }
+    void setCurrentLevel(int i) { currentLevel = i; }
     void nextLevel();
     void prevLevel();
     
-    // 获取关卡列表
-    const std::vector<LevelData>& getAllLevels() const { return levels; }
-    
     // 创建新关卡
     LevelData createNewLevel(const std::string& name);
     
     // 删除关卡
-    bool deleteLevel(int index);
+    bool deleteLevel(int i);
     
 private:
+    bool readInfo(const std::filesystem::path& path, LevelInfo& info) const;
+    bool readLevel(const LevelInfo& info, LevelData& level) const;
     std::string getFullPath(const std::string& filename) const;
     void ensureDirectory() const;
 };
@@ -69,13 +122,39 @@ private:
 // ============================================================
 // 关卡编辑器
 // ============================================================
+// 编辑期间墙壁保存在分块位图里，增删查都是 O(1)，地图最大 2048x2048；
+// 只有 getLevel()（保存时）才转换回 LevelData 的墙壁列表。
+// 绘制时只遍历相机可见的块，每块的几何缓存到块内有改动为止。
+// 每次操作（一笔拖动、一次清空）作为一条命令记进撤销日志：
+// 日志只存被翻转的格子下标，撤销和重做都是把这些格子再翻转一次。
 class LevelEditor {
 private:
-    LevelData editingLevel;
-    int baseGridSize;
-    int gridSize;
-    int offsetX, offsetY;
-    bool isDirty;  // 是否有未保存的更改
+    // 一条编辑命令
+    struct EditCommand {
+        uint32_t cellBegin, cellEnd;    // 翻转过的格子在 editCells 中的范围
+        int spawnIndex;                 // 移动过的出生点，-1 表示没有
+        Vector2 spawnBefore, spawnAfter;
+    };
+    static constexpr int MAX_HISTORY = 256;
+    static constexpr float GRID_LINE_MIN_PIXELS = 6.0f;    // 格子比这更小时不画网格线
+
+    LevelData editingLevel;         // 名称、尺寸、出生点；墙壁在 walls 里
+    ChunkedBitGrid walls;
+    ChunkMeshCache wallMesh;
+    BoardCamera camera;
+    bool needsFit;                  // 换了地图，下次布局时重新适配视口
+
+    // 撤销日志：history[0, historyPos) 已生效，之后的可以重做
+    std::vector<uint32_t> editCells;
+    std::vector<EditCommand> history;
+    int historyPos;
+    int savedPos;                   // 保存时的 historyPos，-1 表示保存点已不在日志里
+    EditCommand pending;            // 正在进行的命令
+    bool editing;
+
+    // 当前笔画，相邻两次鼠标采样之间按直线补齐格子
+    bool stroking;
+    int strokeX, strokeY;
     
     // 工具类型
     enum class Tool {
@@ -92,6 +171,8 @@ public:
     // 初始化
     void newLevel(const std::string& name, int width, int height);
     void loadLevel(const LevelData& level);
+    // 改变地图尺寸，超出新边界的墙壁被丢弃（会清空撤销日志）
+    void resizeLevel(int width, int height);
     
     // 更新和绘制
     void updateLayout(int screenWidth, int screenHeight);
@@ -101,11 +182,16 @@ public:
     // 输入处理
     void handleInput();
     void handleMouseInput();
+    void handleCameraInput();
     void handleKeyboardInput();
     
-    // 获取编辑后的关卡
-    LevelData getLevel() const { return editingLevel; }
-    bool hasUnsavedChanges() const { return isDirty; }
+    // 获取编辑后的关卡（从位图重建墙壁列表）
+    LevelData getLevel() const;
+    bool hasUnsavedChanges() const { return historyPos != savedPos; }
+    
+    // 撤销/重做
+    bool undo();
+    bool redo();
     
     // 工具切换
     void setTool(Tool tool) { currentTool = tool; }
@@ -113,22 +199,30 @@ public:
     const char* getToolName() const;
     
     // 保存提示
-    void markSaved() { isDirty = false; }
-    void markDirty() { isDirty = true; }
+    void markSaved() { savedPos = historyPos; }
+    void markDirty() { savedPos = -1; }
     
 private:
-    // 绘制网格
-    void drawGrid();
-    // 绘制关卡
-    void drawLevel();
+    // 绘制可见范围 [x0, x1] x [y0, y1] 内的网格和墙壁
+    void drawGrid(int x0, int y0, int x1, int y1);
+    void drawWalls(int x0, int y0, int x1, int y1);
+    // 绘制出生点
+    void drawSpawnPoints();
     // 绘制工具栏
     void drawToolbar(int screenWidth, int screenHeight, Font font);
-    // 网格坐标转换
-    Vector2 screenToGrid(int screenX, int screenY) const;
     bool isInGrid(int x, int y) const;
-    // 添加/删除墙壁
+    // 墙壁位图
+    void flipCell(uint32_t cell);
+    // 添加/删除墙壁，改动记进当前命令
     void addWall(int x, int y);
     void removeWall(int x, int y);
     // 设置出生点
     void setSpawnPoint(int x, int y);
+    // 对一个格子/一条线段上的格子应用当前工具
+    void applyTool(int x, int y);
+    void applyLine(int x0, int y0, int x1, int y1);
+    // 命令的开始和提交（没有实际改动的命令会被丢弃）
+    void beginEdit();
+    void commitEdit();
+    void clearHistory();
 };
@@ -0,0 +1,271 @@
+#include "level_file.h"
+#include "bit_ops.h"
+#include "byte_stream.h"
+#include <cstring>
+
+namespace {
+
+// PackBits：头字节 n < 128 表示后面 n+1 个原样字节；
+// n > 128 表示下一个字节重复 257-n 次 (2-128)
+void packBits(const std::vector<uint8_t>& src, std::vector<uint8_t>& out) {
+    size_t i = 0;
+    while (i < src.size()) {
+        size_t run = 1;
+        while (i + run < src.size() && run < 128 && src[i + run] == src[i]) run++;
+
+        if (run >= 2) {
+            out.push_back(static_cast<uint8_t>(257 - run));
+            out.push_back(src[i]);
+            i += run;
+            continue;
+        }
+
+        // 原样段一直延续到下一个重复段开始
+        size_t start = i;
+        while (i < src.size() && i - start < 128) {
+            if (i + 1 < src.size() && src[i] == src[i + 1]) break;
+            i++;
+        }
+        out.push_back(static_cast<uint8_t>(i - start - 1));
+        out.insert(out.end(), src.begin() + start, src.begin() + i);
+    }
+}
+
+bool unpackBits(const uint8_t* src, size_t size, std::vector<uint8_t>& out, size_t expected) {
+    out.assign(expected, 0);
+    size_t i = 0;
+    size_t o = 0;
+    while (i < size) {
+        uint8_t header = src[i++];
+        if (header < 128) {
+            size_t len = header + 1u;
+            if (len > size - i || len > expected - o) return false;
+            std::memcpy(out.data() + o, src + i, len);
+            i += len;
+            o += len;
+        } else if (header > 128) {
+            size_t len = 257u - header;
+            if (i >= size || len > expected - o) return false;
+            std::memset(out.data() + o, src[i++], len);
+            o += len;
+        }
+    }
+    return o == expected;
+}
+
+struct LevelHeader {
+    uint32_t flags;
+    uint32_t width;
+    uint32_t height;
+    int32_t targetScore;
+    uint32_t wallCount;
+    uint32_t spawnCount;
+    uint32_t nameLength;
+    uint32_t authorLength;
+    uint32_t wallBytes;
+    uint64_t checksum;
+};
+
+// 读取并检查定长头部，r 停在正文开头
+bool readHeader(ByteReader& r, LevelHeader& h, std::string& error) {
+    const uint32_t magic = r.readU32();
+    const uint32_t version = r.readU32();
+    h.flags = r.readU32();
+    h.width = r.readU32();
+    h.height = r.readU32();
+    h.targetScore = static_cast<int32_t>(r.readU32());
+    h.wallCount = r.readU32();
+    h.spawnCount = r.readU32();
+    h.nameLength = r.readU32();
+    h.authorLength = r.readU32();
+    h.wallBytes = r.readU32();
+    h.checksum = r.readU64();
+
+    if (!r.ok() || magic != LEVEL_FILE_MAGIC) {
+        error = "不是关卡文件";
+        return false;
+    }
+    if (version != LEVEL_FILE_VERSION) {
+        error = "不支持的关卡版本 " + std::to_string(version);
+        return false;
+    }
+    if (h.width == 0 || h.height == 0 || h.width > ChunkedBitGrid::MAX_SIDE || h.height > ChunkedBitGrid::MAX_SIDE ||
+        h.wallCount > h.width * h.height || h.spawnCount > h.width * h.height) {
+        error = "关卡尺寸无效";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+void writeLevelFile(const LevelData& level, std::vector<uint8_t>& out) {
+    const int width = level.width;
+    const int height = level.height;
+
+    // 墙壁位图
+    std::vector<uint8_t> bitmap((static_cast<size_t>(width) * height + 7) / 8, 0);
+    uint32_t wallCount = 0;
+    for (const Vector2& wall : level.walls) {
+        int x = static_cast<int>(wall.x);
+        int y = static_cast<int>(wall.y);
+        if (x < 0 || y < 0 || x >= width || y >= height) continue;
+
+        size_t bit = static_cast<size_t>(y) * width + x;
+        uint8_t mask = static_cast<uint8_t>(1u << (bit & 7));
+        if (bitmap[bit >> 3] & mask) continue;
+        bitmap[bit >> 3] |= mask;
+        wallCount++;
+    }
+
+    std::vector<uint8_t> packed;
+    packBits(bitmap, packed);
+    const bool rle = packed.size() < bitmap.size();
+    const std::vector<uint8_t>& walls = rle ? packed : bitmap;
+
+    // 正文
+    std::vector<uint8_t> body;
+    ByteWriter b(body);
+    b.writeBytes(reinterpret_cast<const uint8_t*>(level.name.data()), level.name.size());
+    b.writeBytes(reinterpret_cast<const uint8_t*>(level.author.data()), level.author.size());
+    uint32_t spawnCount = 0;
+    for (const Vector2& spawn : level.spawnPoints) {
+        // 坐标按无符号 varint 存，负数和越界的出生点读取时也会被拒绝
+        int x = static_cast<int>(spawn.x);
+        int y = static_cast<int>(spawn.y);
+        if (x < 0 || y < 0 || x >= width || y >= height) continue;
+        b.writeVarint(static_cast<uint64_t>(x));
+        b.writeVarint(static_cast<uint64_t>(y));
+        spawnCount++;
+    }
+    b.writeBytes(walls.data(), walls.size());
+
+    // 头部
+    out.clear();
+    ByteWriter w(out);
+    w.writeU32(LEVEL_FILE_MAGIC);
+    w.writeU32(LEVEL_FILE_VERSION);
+    w.writeU32(rle ? LEVEL_FLAG_RLE : 0);
+    w.writeU32(static_cast<uint32_t>(width));
+    w.writeU32(static_cast<uint32_t>(height));
+    w.writeU32(static_cast<uint32_t>(level.targetScore));
+    w.writeU32(wallCount);
+    w.writeU32(spawnCount);
+    w.writeU32(static_cast<uint32_t>(level.name.size()));
+    w.writeU32(static_cast<uint32_t>(level.author.size()));
+    w.writeU32(static_cast<uint32_t>(walls.size()));
+    w.writeU64(hashBytes(body.data(), body.size()));
+    w.writeBytes(body.data(), body.size());
+}
+
+bool readLevelFileInfo(const uint8_t* data, size_t size, LevelInfo& info, std::string& error) {
+    ByteReader r(data, size);
+    LevelHeader h;
+    if (!readHeader(r, h, error)) return false;
+
+    // 名称和作者紧跟在头部后面，墙壁数据不碰
+    const uint8_t* name = r.readBytes(h.nameLength);
+    const uint8_t* author = r.readBytes(h.authorLength);
+    if (!r.ok()) {
+        error = "文件已截断";
+        return false;
+    }
+
+    info.name.assign(reinterpret_cast<const char*>(name), h.nameLength);
+    info.author.assign(reinterpret_cast<const char*>(author), h.authorLength);
+    info.width = static_cast<int>(h.width);
+    info.height = static_cast<int>(h.height);
+    info.targetScore = h.targetScore;
+    info.wallCount = static_cast<int>(h.wallCount);
+    info.spawnCount = static_cast<int>(h.spawnCount);
+    info.contentHash = h.checksum;
+    return true;
+}
+
+bool readLevelFile(const uint8_t* data, size_t size, LevelData& level, std::string& error) {
+    level = LevelData();
+
+    ByteReader r(data, size);
+    LevelHeader h;
+    if (!readHeader(r, h, error)) return false;
+
+    const uint8_t* body = data + r.position();
+    const size_t bodySize = size - r.position();
+    if (hashBytes(body, bodySize) != h.checksum) {
+        error = "校验和不匹配";
+        return false;
+    }
+
+    ByteReader b(body, bodySize);
+    const uint8_t* name = b.readBytes(h.nameLength);
+    const uint8_t* author = b.readBytes(h.authorLength);
+    // 校验和不带密钥，挡不住故意构造的文件：头部的数量先和剩余正文比一下再分配，
+    // 每个出生点至少占 2 字节
+    if (!b.ok() || h.spawnCount > (bodySize - b.position()) / 2) {
+        error = "文件已截断或长度不符";
+        return false;
+    }
+    std::vector<Vector2> spawns;
+    spawns.reserve(h.spawnCount);
+    for (uint32_t i = 0; i < h.spawnCount && b.ok(); i++) {
+        uint64_t x = b.readVarint();
+        uint64_t y = b.readVarint();
+        if (x >= h.width || y >= h.height) {
+            error = "出生点超出地图";
+            return false;
+        }
+        spawns.push_back({static_cast<float>(x), static_cast<float>(y)});
+    }
+    const uint8_t* walls = b.readBytes(h.wallBytes);
+    if (!b.ok() || !b.atEnd()) {
+        error = "文件已截断或长度不符";
+        return false;
+    }
+
+    // 不压缩时直接在原数据（通常是映射内存）上扫描
+    const size_t bitmapSize = (static_cast<size_t>(h.width) * h.height + 7) / 8;
+    std::vector<uint8_t> unpacked;
+    const uint8_t* bitmap = walls;
+    if (h.flags & LEVEL_FLAG_RLE) {
+        if (!unpackBits(walls, h.wallBytes, unpacked, bitmapSize)) {
+            error = "墙壁数据损坏";
+            return false;
+        }
+        bitmap = unpacked.data();
+    } else if (h.wallBytes != bitmapSize) {
+        error = "墙壁数据长度不符";
+        return false;
+    }
+
+    // 墙壁数按位图里实际置位的格子核对后才分配（位图最大 2048x2048 位 = 512 KB）
+    const size_t cellCount = static_cast<size_t>(h.width) * h.height;
+    size_t setBits = 0;
+    for (size_t i = 0; i < bitmapSize; i++) {
+        setBits += popCount(bitmap[i]);
+    }
+    if (cellCount & 7) {
+        setBits -= popCount(bitmap[bitmapSize - 1] >> (cellCount & 7));
+    }
+    if (setBits != h.wallCount) {
+        error = "墙壁数量不符";
+        return false;
+    }
+
+    level.walls.reserve(h.wallCount);
+    for (size_t i = 0; i < bitmapSize; i++) {
+        // 大部分字节是 0，整字节跳过
+        forEachSetBit(bitmap[i], [&](int bit) {
+            size_t cell = i * 8 + bit;
+            if (cell >= cellCount) return;
+            level.walls.push_back({static_cast<float>(cell % h.width), static_cast<float>(cell / h.width)});
+        });
+    }
+
+    level.name.assign(reinterpret_cast<const char*>(name), h.nameLength);
+    level.author.assign(reinterpret_cast<const char*>(author), h.authorLength);
+    level.width = static_cast<int>(h.width);
+    level.height = static_cast<int>(h.height);
+    level.targetScore = h.targetScore;
+    level.spawnPoints = std::move(spawns);
+    return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "level.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================
+// .lvl 二进制关卡格式
+// ============================================================
+// 墙壁总是落在有限网格的整数格子上，没必要存成 JSON 里的浮点坐标。
+// 文件结构（小端）：
+//   头部   magic "SLVL", 版本, 标志, 宽, 高, 目标分数, 墙壁数, 出生点数,
+//          名称长度, 作者长度, 墙壁数据长度, 正文校验和 (FNV-1a)
+//   正文   名称, 作者 (UTF-8), 出生点 (varint x, y), 墙壁数据
+// 墙壁数据是 width * height 位的位图（行优先，低位在前）；
+// 压缩后更小时用 PackBits 行程编码保存（LEVEL_FLAG_RLE）。
+// 40x30 的关卡位图只有 150 字节，空旷的大地图压缩后更小。
+//
+// 读取时调用者通常传入 MappedFile 的内容：头部定长，位图不压缩时
+// 直接在映射内存上逐位扫描，不需要任何文本解析或中间拷贝。
+
+constexpr uint32_t LEVEL_FILE_MAGIC = 0x4C564C53;   // "SLVL"
+constexpr uint32_t LEVEL_FILE_VERSION = 1;
+constexpr uint32_t LEVEL_FLAG_RLE = 1u << 0;
+
+// 编码整个关卡（越界和重复的墙壁、越界的出生点被忽略）
+void writeLevelFile(const LevelData& level, std::vector<uint8_t>& out);
+
+// 解码；失败时返回 false，error 为原因
+bool readLevelFile(const uint8_t* data, size_t size, LevelData& level, std::string& error);
+
+// 只读头部、名称和作者，用于关卡索引（contentHash 为正文校验和，不做校验）
+bool readLevelFileInfo(const uint8_t* data, size_t size, LevelInfo& info, std::string& error);
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ============================================================
+// MappedFile - 只读内存映射文件
+// ============================================================
+// 把整个文件映射进地址空间，getData() 直接指向文件内容：
+// 不需要先分配缓冲区再 read 一遍，用不到的页也不会真正读盘。
+// 映射在 close() 或析构时解除，之后 getData() 返回的指针失效。
+// 空文件无法映射，open() 返回 false。
+class MappedFile {
+private:
+    const uint8_t* data;
+    size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+    const uint8_t* getData() const { return data; }
+    size_t getSize() const { return size; }
+};
@@ -1,99 +1,186 @@
 #include "obstacle.h"
 #include "snake.h"
-
-// ============================================================
-// Obstacle 实现
-// ============================================================
-Obstacle::Obstacle(int x, int y, bool /* destructible */)
-    : x(x), y(y) {
-}
-
-void Obstacle::draw(int gridSize) const {
-    int px = x * gridSize;
-    int py = y * gridSize;
-
-    // 绘制墙壁 - 使用灰色和深灰色营造立体感
-    DrawRectangle(px + 1, py + 1, gridSize - 2, gridSize - 2, GRAY);
-
-    // 高光
-    DrawLine(px + 2, py + 2, px + gridSize - 3, py + 2, LIGHTGRAY);
-    DrawLine(px + 2, py + 2, px + 2, py + gridSize - 3, LIGHTGRAY);
-
-    // 阴影
-    DrawLine(px + gridSize - 3, py + 3, px + gridSize - 3, py + gridSize - 3, DARKGRAY);
-    DrawLine(px + 3, py + gridSize - 3, px + gridSize - 3, py + gridSize - 3, DARKGRAY);
-}
-
-bool Obstacle::checkCollision(int px, int py) const {
-    return x == px && y == py;
-}
+#include <algorithm>
+#include <cstdlib>
 
 // ============================================================
 // ObstacleManager 实现
 // ============================================================
 ObstacleManager::ObstacleManager(int gridW, int gridH)
-    : gridWidth(gridW), gridHeight(gridH) {
+    : gridWidth(gridW), gridHeight(gridH),
+      chunksX((gridW + CHUNK_SIZE - 1) >> CHUNK_SHIFT),
+      chunksY((gridH + CHUNK_SIZE - 1) >> CHUNK_SHIFT),
+      count(0), grid(nullptr) {
+    chunks.resize(static_cast<size_t>(chunksX) * chunksY);
 }
 
-void ObstacleManager::generate(int count, const Snake& snake) {
-    obstacles.clear();
+void ObstacleManager::bindGrid(OccupancyGrid* occupancy) {
+    grid = occupancy;
+    if (!grid) return;
+    forEach([&](int x, int y, TileType, int) {
+        grid->set(x, y, CellOwner::WALL);
+    });
+}
 
+void ObstacleManager::generate(int total, TileType type, const Snake& snake, SimRandom& rng) {
+    int placed = 0;
     int attempts = 0;
-    int maxAttempts = count * 100;  // 防止无限循环
+    int maxAttempts = total * 100;  // 防止无限循环
 
-    while (static_cast<int>(obstacles.size()) < count && attempts < maxAttempts) {
+    while (placed < total && attempts < maxAttempts) {
         attempts++;
 
-        int x = GetRandomValue(0, gridWidth - 1);
-        int y = GetRandomValue(0, gridHeight - 1);
+        int x, y;
+        if (grid) {
+            // 从空闲格子集合取样，只需排除中间的出生区域
+            int freeCount = grid->getFreeCount();
+            if (freeCount == 0) break;
+            grid->getFreeCell(rng.range(0, freeCount - 1), x, y);
+        } else {
+            x = rng.range(0, gridWidth - 1);
+            y = rng.range(0, gridHeight - 1);
+        }
 
         // 检查是否与蛇或已有障碍物重叠
         if (isValidPosition(x, y, snake)) {
-            obstacles.emplace_back(x, y, false);
+            addObstacle(x, y, type);
+            placed++;
         }
     }
 }
 
-void ObstacleManager::addObstacle(int x, int y) {
-    if (x < 0 || x >= gridWidth || y < 0 || y >= gridHeight) {
+void ObstacleManager::addObstacle(int x, int y, TileType type, int hitPoints) {
+    if (!inBounds(x, y) || type == TileType::EMPTY) {
         return;
     }
-    if (checkCollision(x, y)) {
-        return;
+
+    std::unique_ptr<Chunk>& chunk = chunks[(y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT)];
+    if (!chunk) {
+        chunk = std::make_unique<Chunk>();
+        std::fill(std::begin(chunk->tiles), std::end(chunk->tiles), 0);
+        std::fill(std::begin(chunk->rows), std::end(chunk->rows), 0);
+        chunk->count = 0;
+    }
+
+    uint64_t& row = chunk->rows[y & (CHUNK_SIZE - 1)];
+    const uint64_t mask = 1ull << (x & (CHUNK_SIZE - 1));
+    if (row & mask) {
+        return;     // 已有障碍物，保留原来的
+    }
+
+    if (!isDestructible(type)) {
+        hitPoints = 0;
+    } else if (hitPoints <= 0) {
+        hitPoints = CRATE_HIT_POINTS;
+    }
+    hitPoints = std::min(hitPoints, MAX_HIT_POINTS);
+
+    chunk->tiles[tileIndex(x, y)] = static_cast<uint8_t>(static_cast<uint8_t>(type) | (hitPoints << 4));
+    row |= mask;
+    chunk->count++;
+    count++;
+
+    if (grid) {
+        // 关卡墙壁可能压在出生的蛇身上，墙壁优先
+        grid->set(x, y, CellOwner::WALL);
     }
-    obstacles.emplace_back(x, y, false);
 }
 
-void ObstacleManager::clear() {
-    obstacles.clear();
+void ObstacleManager::removeObstacle(int x, int y) {
+    if (!inBounds(x, y)) return;
+
+    std::unique_ptr<Chunk>& chunk = chunks[(y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT)];
+    if (!chunk) return;
+
+    uint64_t& row = chunk->rows[y & (CHUNK_SIZE - 1)];
+    const uint64_t mask = 1ull << (x & (CHUNK_SIZE - 1));
+    if (!(row & mask)) return;
+
+    row &= ~mask;
+    chunk->tiles[tileIndex(x, y)] = 0;
+    count--;
+    if (--chunk->count == 0) {
+        chunk.reset();
+    }
+
+    if (grid) {
+        grid->release(x, y, CellOwner::WALL);
+    }
 }
 
-bool ObstacleManager::checkCollision(int x, int y) const {
-    for (const auto& obs : obstacles) {
-        if (obs.checkCollision(x, y)) {
-            return true;
-        }
+void ObstacleManager::clear() {
+    if (grid) {
+        forEach([&](int x, int y, TileType, int) {
+            grid->release(x, y, CellOwner::WALL);
+        });
     }
-    return false;
+    for (auto& chunk : chunks) {
+        chunk.reset();
+    }
+    count = 0;
 }
 
-void ObstacleManager::draw(int gridSize) const {
-    for (const auto& obs : obstacles) {
-        obs.draw(gridSize);
+int ObstacleManager::damage(int x, int y) {
+    if (!inBounds(x, y)) return -1;
+    Chunk* chunk = chunkAt(x, y);
+    if (!chunk) return -1;
+
+    uint8_t& tile = chunk->tiles[tileIndex(x, y)];
+    const TileType type = static_cast<TileType>(tile & 0x0F);
+    if (!isDestructible(type)) return -1;
+
+    const int remaining = (tile >> 4) - 1;
+    if (remaining <= 0) {
+        removeObstacle(x, y);
+        return 0;
     }
+    tile = static_cast<uint8_t>(static_cast<uint8_t>(type) | (remaining << 4));
+    return remaining;
+}
+
+TileType ObstacleManager::getType(int x, int y) const {
+    if (!inBounds(x, y)) return TileType::EMPTY;
+    const Chunk* chunk = chunkAt(x, y);
+    return chunk ? static_cast<TileType>(chunk->tiles[tileIndex(x, y)] & 0x0F) : TileType::EMPTY;
+}
+
+int ObstacleManager::getHitPoints(int x, int y) const {
+    if (!inBounds(x, y)) return 0;
+    const Chunk* chunk = chunkAt(x, y);
+    return chunk ? chunk->tiles[tileIndex(x, y)] >> 4 : 0;
+}
+
+uint64_t ObstacleManager::getChunkRow(int cx, int cy, int row, TileType type) const {
+    const Chunk* chunk = chunks[cy * chunksX + cx].get();
+    if (!chunk) return 0;
+
+    // 只检查有障碍物的格子
+    uint64_t result = 0;
+    const uint8_t* tiles = chunk->tiles + (row << CHUNK_SHIFT);
+    forEachSetBit(chunk->rows[row], [&](int bit) {
+        if (static_cast<TileType>(tiles[bit] & 0x0F) == type) {
+            result |= 1ull << bit;
+        }
+    });
+    return result;
 }
 
 bool ObstacleManager::isValidPosition(int x, int y, const Snake& snake) const {
-    // 检查是否在蛇身上
-    for (const auto& segment : snake.getBody()) {
-        if (segment.x == x && segment.y == y) {
+    if (grid) {
+        // 蛇身、道具和已有障碍物都记录在网格里
+        if (!grid->isEmpty(x, y)) {
             return false;
         }
-    }
+    } else {
+        // 检查是否在蛇身上
+        for (const auto& segment : snake.getBody()) {
+            if (segment.x == x && segment.y == y) {
+                return false;
+            }
+        }
 
-    // 检查是否与已有障碍物重叠
-    for (const auto& obs : obstacles) {
-        if (obs.getX() == x && obs.getY() == y) {
+        // 检查是否与已有障碍物重叠
+        if (checkCollision(x, y)) {
             return false;
         }
     }
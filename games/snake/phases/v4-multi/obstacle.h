@@ -1,55 +1,121 @@
 #pragma once
-#include "raylib.h"
+#include "occupancy.h"
+#include "sim_random.h"
+#include "chunk_grid.h"
+#include <cstdint>
+#include <memory>
 #include <vector>
 
 // 前向声明
 class Snake;
 
+// 障碍物格子类型（4 位即可表示）
+enum class TileType : uint8_t {
+    EMPTY = 0,      // 没有障碍物
+    WALL,           // 墙壁，不可破坏
+    CRATE           // 箱子，每撞一次耐久减一，归零后消失
+};
+
 // ============================================================
-// 障碍物类 - 表示墙壁或障碍物
+// 障碍物管理器 - 分块存储的障碍物图层
 // ============================================================
-class Obstacle {
-private:
-    int x, y;
-
+// 纯逻辑类（属于模拟核心），绘制由 Game 负责。
+// 每个格子一个字节：低 4 位类型，高 4 位剩余耐久。地图按 64x64 分块，
+// 块在第一次放障碍物时分配、最后一个障碍物移除后释放，另有每行一个字
+// 的位图记录哪些格子有障碍物（和 ChunkedBitGrid 同样的布局，
+// ChunkMeshCache 可以直接读）。查询是一次下标计算，与障碍物数量无关。
+class ObstacleManager {
 public:
-    Obstacle(int x, int y, bool /* destructible */ = false);
+    static constexpr int CHUNK_SHIFT = ChunkedBitGrid::CHUNK_SHIFT;
+    static constexpr int CHUNK_SIZE = ChunkedBitGrid::CHUNK_SIZE;
+    static constexpr int MAX_HIT_POINTS = 15;
+    static constexpr int CRATE_HIT_POINTS = 2;     // 随机生成的箱子的耐久
 
-    void draw(int gridSize) const;
-    bool checkCollision(int px, int py) const;
+    // 只看某一类格子的视图，供 ChunkMeshCache 按类型分别生成几何
+    class TypeView {
+    private:
+        const ObstacleManager& tiles;
+        TileType type;
 
-    int getX() const { return x; }
-    int getY() const { return y; }
-};
+    public:
+        TypeView(const ObstacleManager& owner, TileType t) : tiles(owner), type(t) {}
+        uint64_t getChunkRow(int cx, int cy, int row) const {
+            return tiles.getChunkRow(cx, cy, row, type);
+        }
+    };
 
-// ============================================================
-// 障碍物管理器 - 管理所有障碍物
-// ============================================================
-class ObstacleManager {
 private:
-    std::vector<Obstacle> obstacles;
+    struct Chunk {
+        uint8_t tiles[CHUNK_SIZE * CHUNK_SIZE];     // 低4位=类型，高4位=耐久
+        uint64_t rows[CHUNK_SIZE];                  // 有障碍物的格子，低位在左
+        int count;                                  // 块内障碍物数
+    };
+
+    std::vector<std::unique_ptr<Chunk>> chunks;     // 行优先，空块为 nullptr
     int gridWidth, gridHeight;
+    int chunksX, chunksY;
+    int count;
+    OccupancyGrid* grid;    // 共享占用网格（可为空）
 
 public:
     ObstacleManager(int gridW, int gridH);
 
-    // 生成障碍物
-    void generate(int count, const Snake& snake);
-    void addObstacle(int x, int y);
+    // 绑定占用网格，之后增删障碍物都会同步写入网格
+    void bindGrid(OccupancyGrid* occupancy);
+
+    // 随机生成 count 个 type 类型的障碍物（不清除已有的）
+    void generate(int count, TileType type, const Snake& snake, SimRandom& rng);
+    // 放置障碍物，hitPoints 只对可破坏的类型有意义（<= 0 时取默认值）
+    void addObstacle(int x, int y, TileType type = TileType::WALL, int hitPoints = 0);
+    void removeObstacle(int x, int y);
     void clear();
 
-    // 检查碰撞
-    bool checkCollision(int x, int y) const;
+    // 对 (x, y) 的可破坏障碍物造成一点伤害：返回剩余耐久（0 表示已被摧毁并移除），
+    // 不可破坏或没有障碍物时返回 -1
+    int damage(int x, int y);
 
-    // 绘制
-    void draw(int gridSize) const;
+    // 查询（越界视为没有障碍物）
+    bool checkCollision(int x, int y) const { return getType(x, y) != TileType::EMPTY; }
+    TileType getType(int x, int y) const;
+    int getHitPoints(int x, int y) const;
+    static bool isDestructible(TileType type) { return type == TileType::CRATE; }
 
     // 获取数量
-    int getCount() const { return static_cast<int>(obstacles.size()); }
+    int getCount() const { return count; }
+
+    // 块 (cx, cy) 第 row 行有障碍物的格子，空块返回 0
+    uint64_t getChunkRow(int cx, int cy, int row) const {
+        const Chunk* chunk = chunks[cy * chunksX + cx].get();
+        return chunk ? chunk->rows[row] : 0;
+    }
+    // 同上，只保留 type 类型的格子
+    uint64_t getChunkRow(int cx, int cy, int row, TileType type) const;
+    TypeView view(TileType type) const { return TypeView(*this, type); }
+    int getChunksX() const { return chunksX; }
+    int getChunksY() const { return chunksY; }
 
-    // 获取所有障碍物（用于生成物品时避开）
-    const std::vector<Obstacle>& getObstacles() const { return obstacles; }
+    // 按块、行的顺序对每个障碍物调用 f(x, y, type, hitPoints)，空块整个跳过
+    template <typename F>
+    void forEach(F&& f) const {
+        for (int cy = 0; cy < chunksY; cy++) {
+            for (int cx = 0; cx < chunksX; cx++) {
+                const Chunk* chunk = chunks[cy * chunksX + cx].get();
+                if (!chunk) continue;
+                for (int row = 0; row < CHUNK_SIZE; row++) {
+                    forEachSetBit(chunk->rows[row], [&](int bit) {
+                        const uint8_t tile = chunk->tiles[(row << CHUNK_SHIFT) + bit];
+                        f((cx << CHUNK_SHIFT) + bit, (cy << CHUNK_SHIFT) + row,
+                          static_cast<TileType>(tile & 0x0F), tile >> 4);
+                    });
+                }
+            }
+        }
+    }
 
 private:
     bool isValidPosition(int x, int y, const Snake& snake) const;
+    // 格子所在的块（可能为空）和块内下标
+    Chunk* chunkAt(int x, int y) const { return chunks[(y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT)].get(); }
+    static int tileIndex(int x, int y) { return ((y & (CHUNK_SIZE - 1)) << CHUNK_SHIFT) + (x & (CHUNK_SIZE - 1)); }
+    bool inBounds(int x, int y) const { return x >= 0 && x < gridWidth && y >= 0 && y < gridHeight; }
 };
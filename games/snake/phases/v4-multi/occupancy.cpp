@@ -0,0 +1,230 @@
+#include "occupancy.h"
+#include <cstring>
+
+OccupancyGrid::OccupancyGrid(int w, int h)
+    : width(0), height(0), chunksX(0), chunksY(0), freeCount(0), allocated(0) {
+    resize(w, h);
+}
+
+void OccupancyGrid::resize(int w, int h) {
+    width = w > 0 ? w : 0;
+    height = h > 0 ? h : 0;
+    chunksX = (width + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+    chunksY = (height + CHUNK_SIZE - 1) >> CHUNK_SHIFT;
+    chunks.clear();
+    chunks.resize(static_cast<size_t>(chunksX) * chunksY);
+    allocated = 0;
+    rebuildFreeTree();
+}
+
+void OccupancyGrid::clear() {
+    for (int i = 0; i < static_cast<int>(chunks.size()); i++) {
+        if (chunks[i]) releaseChunk(i);
+    }
+    rebuildFreeTree();
+}
+
+CellOwner OccupancyGrid::get(int x, int y) const {
+    if (!inBounds(x, y)) {
+        return CellOwner::WALL;
+    }
+    const Chunk* chunk = chunks[(y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT)].get();
+    if (!chunk) {
+        return CellOwner::EMPTY;
+    }
+    int index = ((y & (CHUNK_SIZE - 1)) << CHUNK_SHIFT) | (x & (CHUNK_SIZE - 1));
+    uint8_t packed = chunk->cells[index >> 1];
+    return static_cast<CellOwner>((index & 1) ? (packed >> 4) : (packed & 0x0F));
+}
+
+void OccupancyGrid::set(int x, int y, CellOwner owner) {
+    if (!inBounds(x, y)) {
+        return;
+    }
+    const int chunkIndex = (y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT);
+    uint8_t value = static_cast<uint8_t>(owner) & 0x0F;
+
+    Chunk* chunk = chunks[chunkIndex].get();
+    if (!chunk) {
+        if (value == 0) return;
+        chunk = allocateChunk(chunkIndex);
+    }
+
+    const int row = y & (CHUNK_SIZE - 1);
+    const int col = x & (CHUNK_SIZE - 1);
+    const int index = (row << CHUNK_SHIFT) | col;
+    uint8_t& packed = chunk->cells[index >> 1];
+    uint8_t previous = (index & 1) ? (packed >> 4) : (packed & 0x0F);
+
+    if (index & 1) {
+        packed = static_cast<uint8_t>((packed & 0x0F) | (value << 4));
+    } else {
+        packed = static_cast<uint8_t>((packed & 0xF0) | value);
+    }
+
+    // 空 <-> 非空 的转换同步到位图和空闲计数
+    if (previous == 0 && value != 0) {
+        chunk->occupied[row] |= 1ull << col;
+        chunk->count++;
+        addFree(chunkIndex, -1);
+    } else if (previous != 0 && value == 0) {
+        chunk->occupied[row] &= ~(1ull << col);
+        addFree(chunkIndex, 1);
+        if (--chunk->count == 0) {
+            releaseChunk(chunkIndex);
+        }
+    }
+}
+
+bool OccupancyGrid::claim(int x, int y, CellOwner owner) {
+    if (!isEmpty(x, y)) {
+        return false;
+    }
+    set(x, y, owner);
+    return true;
+}
+
+void OccupancyGrid::release(int x, int y, CellOwner owner) {
+    if (get(x, y) == owner && inBounds(x, y)) {
+        set(x, y, CellOwner::EMPTY);
+    }
+}
+
+void OccupancyGrid::getFreeCell(int i, int& x, int& y) const {
+    // 树状数组上二分：找到第 i 个空闲格子所在的块
+    const int chunkCount = static_cast<int>(chunks.size());
+    int step = 1;
+    while (step * 2 <= chunkCount) step *= 2;
+    int chunkIndex = 0;
+    for (; step > 0; step >>= 1) {
+        if (chunkIndex + step <= chunkCount && freeTree[chunkIndex + step] <= i) {
+            chunkIndex += step;
+            i -= freeTree[chunkIndex];
+        }
+    }
+
+    const int cx = chunkIndex % chunksX;
+    const int cy = chunkIndex / chunksX;
+    const int cw = chunkWidth(cx);
+    const Chunk* chunk = chunks[chunkIndex].get();
+    int row = 0, col = 0;
+    if (!chunk) {
+        // 空块里全是空闲格子
+        row = i / cw;
+        col = i % cw;
+    } else {
+        // 逐行跳过，行内取第 i 个 0 位
+        const uint64_t rowMask = (cw == CHUNK_SIZE) ? ~0ull : ((1ull << cw) - 1);
+        for (;; row++) {
+            uint64_t freeBits = ~chunk->occupied[row] & rowMask;
+            int rowFree = popCount(freeBits);
+            if (i < rowFree) {
+                for (; i > 0; i--) freeBits &= freeBits - 1;
+                col = countTrailingZeros(freeBits);
+                break;
+            }
+            i -= rowFree;
+        }
+    }
+    x = (cx << CHUNK_SHIFT) + col;
+    y = (cy << CHUNK_SHIFT) + row;
+}
+
+OccupancyGrid::Chunk* OccupancyGrid::allocateChunk(int chunkIndex) {
+    std::unique_ptr<Chunk> chunk;
+    if (!spareChunks.empty()) {
+        chunk = std::move(spareChunks.back());
+        spareChunks.pop_back();
+    } else {
+        chunk = std::make_unique<Chunk>();
+    }
+    std::memset(chunk->cells, 0, sizeof(chunk->cells));
+    std::memset(chunk->occupied, 0, sizeof(chunk->occupied));
+    chunk->count = 0;
+
+    chunks[chunkIndex] = std::move(chunk);
+    allocated++;
+    return chunks[chunkIndex].get();
+}
+
+void OccupancyGrid::releaseChunk(int chunkIndex) {
+    if (spareChunks.size() < MAX_SPARE_CHUNKS) {
+        spareChunks.push_back(std::move(chunks[chunkIndex]));
+    }
+    chunks[chunkIndex].reset();
+    allocated--;
+}
+
+void OccupancyGrid::rebuildFreeTree() {
+    // 全部清空时各块空闲数就是块内的格子数，O(块数) 建树
+    const int chunkCount = static_cast<int>(chunks.size());
+    freeTree.assign(static_cast<size_t>(chunkCount) + 1, 0);
+    for (int i = 1; i <= chunkCount; i++) {
+        freeTree[i] += chunkWidth((i - 1) % chunksX) * chunkHeight((i - 1) / chunksX);
+        int parent = i + (i & -i);
+        if (parent <= chunkCount) freeTree[parent] += freeTree[i];
+    }
+    freeCount = width * height;
+}
+
+void OccupancyGrid::addFree(int chunkIndex, int delta) {
+    const int chunkCount = static_cast<int>(chunks.size());
+    for (int i = chunkIndex + 1; i <= chunkCount; i += i & -i) {
+        freeTree[i] += delta;
+    }
+    freeCount += delta;
+}
+
+void OccupancyGrid::saveState(ByteWriter& out) const {
+    out.writeVarint(static_cast<uint64_t>(width));
+    out.writeVarint(static_cast<uint64_t>(height));
+
+    // 非空格子按块、行的顺序写出，下标差 + zigzag 编码，块内相邻格子通常 1 字节
+    out.writeVarint(static_cast<uint64_t>(width) * height - freeCount);
+    int64_t previous = 0;
+    forEachOccupied([&](int x, int y, CellOwner owner) {
+        int64_t cell = static_cast<int64_t>(y) * width + x;
+        out.writeSVarint(cell - previous);
+        out.writeU8(static_cast<uint8_t>(owner));
+        previous = cell;
+    });
+}
+
+bool OccupancyGrid::loadState(ByteReader& in) {
+    int w = static_cast<int>(in.readVarint());
+    int h = static_cast<int>(in.readVarint());
+    if (!in.ok() || w != width || h != height) {
+        return false;
+    }
+
+    const int64_t cellCount = static_cast<int64_t>(width) * height;
+    uint64_t occupiedCount = in.readVarint();
+    if (!in.ok() || occupiedCount > static_cast<uint64_t>(cellCount)) {
+        return false;
+    }
+
+    struct CellState {
+        int x, y;
+        CellOwner owner;
+    };
+    std::vector<CellState> cells(static_cast<size_t>(occupiedCount));
+    int64_t previous = 0;
+    for (auto& c : cells) {
+        int64_t cell = previous + in.readSVarint();
+        uint8_t owner = in.readU8();
+        if (!in.ok() || cell < 0 || cell >= cellCount ||
+            owner == 0 || owner > static_cast<uint8_t>(CellOwner::ITEM)) {
+            return false;
+        }
+        c.x = static_cast<int>(cell % width);
+        c.y = static_cast<int>(cell / width);
+        c.owner = static_cast<CellOwner>(owner);
+        previous = cell;
+    }
+
+    clear();
+    for (const auto& c : cells) {
+        set(c.x, c.y, c.owner);
+    }
+    return true;
+}
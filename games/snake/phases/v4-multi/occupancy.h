@@ -0,0 +1,121 @@
+#pragma once
+#include "bit_ops.h"
+#include "byte_stream.h"
+#include "chunk_grid.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 格子占用者标记（4 位即可表示）
+enum class CellOwner : uint8_t {
+    EMPTY = 0,      // 空格子
+    PLAYER1,        // 玩家1的蛇身
+    PLAYER2,        // 玩家2的蛇身
+    WALL,           // 墙壁/障碍物
+    ITEM            // 道具
+};
+
+// ============================================================
+// 占用网格 - 蛇、障碍物、道具共享的格子占用表
+// ============================================================
+// 每个格子用 4 位记录占用者，两个格子压缩到一个字节里。
+// 蛇头前进、蛇尾收缩、障碍物增删时增量更新，
+// 所有碰撞查询都变成一次 O(1) 的查表。
+//
+// 地图按 64x64 分块（和 ChunkedBitGrid 相同），块在第一次有东西时才分配、
+// 最后一格清空后释放，2048x2048 的地图内存只与蛇、墙、道具覆盖到的块成正比。
+// 空闲格子不单独存表：每块另有一张“每行一个字”的非空位图，再用按块的
+// 树状数组统计空闲数，第 i 个空闲格子（块优先、行优先的固定顺序）
+// 可以在 O(log 块数 + 块边长) 内定位，生成道具/障碍物时均匀取样。
+class OccupancyGrid {
+public:
+    static constexpr int CHUNK_SHIFT = ChunkedBitGrid::CHUNK_SHIFT;
+    static constexpr int CHUNK_SIZE = ChunkedBitGrid::CHUNK_SIZE;
+    static constexpr int MAX_SPARE_CHUNKS = 8;      // 释放的块留几个复用，蛇在块边界来回时不反复分配
+
+private:
+    struct Chunk {
+        uint8_t cells[CHUNK_SIZE * CHUNK_SIZE / 2];     // 低4位=偶数格，高4位=奇数格
+        uint64_t occupied[CHUNK_SIZE];                  // 非空格子，每行一个字，低位在左
+        int count;                                      // 块内非空格子数
+    };
+
+    std::vector<std::unique_ptr<Chunk>> chunks;     // 行优先，全空的块为 nullptr
+    std::vector<std::unique_ptr<Chunk>> spareChunks;
+    std::vector<int> freeTree;      // 各块空闲格子数的树状数组（下标从 1 开始）
+    int width, height;
+    int chunksX, chunksY;
+    int freeCount;
+    size_t allocated;
+
+public:
+    OccupancyGrid(int w, int h);
+
+    OccupancyGrid(OccupancyGrid&&) = default;
+    OccupancyGrid& operator=(OccupancyGrid&&) = default;
+
+    // 重新设置尺寸（会清空所有格子）
+    void resize(int w, int h);
+    void clear();
+
+    // 查询：越界视为墙壁，这样边界检测也合并成一次查表
+    CellOwner get(int x, int y) const;
+    bool inBounds(int x, int y) const {
+        return x >= 0 && x < width && y >= 0 && y < height;
+    }
+    bool isEmpty(int x, int y) const { return get(x, y) == CellOwner::EMPTY; }
+    // 蛇头可以进入的格子：空格子或道具
+    bool isPassable(int x, int y) const {
+        CellOwner owner = get(x, y);
+        return owner == CellOwner::EMPTY || owner == CellOwner::ITEM;
+    }
+
+    // 修改
+    void set(int x, int y, CellOwner owner);
+    // 只在格子为空时占用，返回是否成功（不会覆盖道具，否则道具还在而格子被蛇占着）
+    bool claim(int x, int y, CellOwner owner);
+    // 只释放属于 owner 的格子，避免误清别人的标记
+    void release(int x, int y, CellOwner owner);
+
+    // 空闲格子索引
+    int getFreeCount() const { return freeCount; }
+    // 取第 i 个空闲格子（0 <= i < getFreeCount()）。顺序只由格子内容决定，
+    // 同样的局面总是取到同样的格子，快照不必保存额外的顺序信息
+    void getFreeCell(int i, int& x, int& y) const;
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t getAllocatedChunks() const { return allocated; }
+
+    // 快照：只写非空格子（与上一个的下标差 + 占用者），地图再大也只与内容成正比
+    void saveState(ByteWriter& out) const;
+    bool loadState(ByteReader& in);
+
+    // 按块、行的顺序对每个非空格子调用 f(x, y, owner)，空块整个跳过；供批量导出观测等只读遍历
+    template <typename F>
+    void forEachOccupied(F&& f) const {
+        for (int cy = 0; cy < chunksY; cy++) {
+            for (int cx = 0; cx < chunksX; cx++) {
+                const Chunk* chunk = chunks[cy * chunksX + cx].get();
+                if (!chunk) continue;
+                for (int row = 0; row < CHUNK_SIZE; row++) {
+                    forEachSetBit(chunk->occupied[row], [&](int bit) {
+                        const int index = (row << CHUNK_SHIFT) + bit;
+                        const uint8_t packed = chunk->cells[index >> 1];
+                        f((cx << CHUNK_SHIFT) + bit, (cy << CHUNK_SHIFT) + row,
+                          static_cast<CellOwner>((index & 1) ? (packed >> 4) : (packed & 0x0F)));
+                    });
+                }
+            }
+        }
+    }
+
+private:
+    int chunkWidth(int cx) const { return std::min(CHUNK_SIZE, width - (cx << CHUNK_SHIFT)); }
+    int chunkHeight(int cy) const { return std::min(CHUNK_SIZE, height - (cy << CHUNK_SHIFT)); }
+    Chunk* allocateChunk(int chunkIndex);
+    void releaseChunk(int chunkIndex);
+    void rebuildFreeTree();
+    void addFree(int chunkIndex, int delta);
+};
@@ -1,43 +1,98 @@
 #include "particle.h"
 #include <cmath>
 
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 // ============================================================
-// Particle 实现
+// 积分内核 - 半隐式欧拉：先更新速度，再用新速度更新位置
 // ============================================================
-void Particle::update(float deltaTime) {
-    if (!active) return;
-
-    // 应用加速度
-    velocity.x += acceleration.x * deltaTime;
-    velocity.y += acceleration.y * deltaTime;
-
-    // 应用速度
-    position.x += velocity.x * deltaTime;
-    position.y += velocity.y * deltaTime;
-
-    // 旋转
-    rotation += rotationSpeed * deltaTime;
-
-    // 减少生命
-    life -= deltaTime;
-    if (life <= 0) {
-        active = false;
+// 按编译目标选择 AVX / SSE2 / NEON，其余平台走标量循环。
+// 数组长度已按 SIMD_WIDTH 向上取整，尾部不足一组的粒子也按整组处理。
+namespace {
+
+struct ParticleArrays {
+    float* posX;
+    float* posY;
+    float* velX;
+    float* velY;
+    const float* accelY;
+    float* rotation;
+    const float* rotationSpeed;
+    float* life;
+};
+
+#if defined(__AVX__)
+constexpr size_t SIMD_WIDTH = 8;
+
+void integrate(const ParticleArrays& a, size_t count, float dt) {
+    const __m256 vdt = _mm256_set1_ps(dt);
+    for (size_t i = 0; i < count; i += 8) {
+        __m256 vy = _mm256_add_ps(_mm256_loadu_ps(a.velY + i),
+                                  _mm256_mul_ps(_mm256_loadu_ps(a.accelY + i), vdt));
+        __m256 vx = _mm256_loadu_ps(a.velX + i);
+        _mm256_storeu_ps(a.velY + i, vy);
+        _mm256_storeu_ps(a.posX + i, _mm256_add_ps(_mm256_loadu_ps(a.posX + i), _mm256_mul_ps(vx, vdt)));
+        _mm256_storeu_ps(a.posY + i, _mm256_add_ps(_mm256_loadu_ps(a.posY + i), _mm256_mul_ps(vy, vdt)));
+        _mm256_storeu_ps(a.rotation + i, _mm256_add_ps(_mm256_loadu_ps(a.rotation + i),
+                                                       _mm256_mul_ps(_mm256_loadu_ps(a.rotationSpeed + i), vdt)));
+        _mm256_storeu_ps(a.life + i, _mm256_sub_ps(_mm256_loadu_ps(a.life + i), vdt));
     }
 }
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+constexpr size_t SIMD_WIDTH = 4;
+
+void integrate(const ParticleArrays& a, size_t count, float dt) {
+    const __m128 vdt = _mm_set1_ps(dt);
+    for (size_t i = 0; i < count; i += 4) {
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(a.velY + i), _mm_mul_ps(_mm_loadu_ps(a.accelY + i), vdt));
+        __m128 vx = _mm_loadu_ps(a.velX + i);
+        _mm_storeu_ps(a.velY + i, vy);
+        _mm_storeu_ps(a.posX + i, _mm_add_ps(_mm_loadu_ps(a.posX + i), _mm_mul_ps(vx, vdt)));
+        _mm_storeu_ps(a.posY + i, _mm_add_ps(_mm_loadu_ps(a.posY + i), _mm_mul_ps(vy, vdt)));
+        _mm_storeu_ps(a.rotation + i, _mm_add_ps(_mm_loadu_ps(a.rotation + i),
+                                                 _mm_mul_ps(_mm_loadu_ps(a.rotationSpeed + i), vdt)));
+        _mm_storeu_ps(a.life + i, _mm_sub_ps(_mm_loadu_ps(a.life + i), vdt));
+    }
+}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+constexpr size_t SIMD_WIDTH = 4;
+
+void integrate(const ParticleArrays& a, size_t count, float dt) {
+    const float32x4_t vdt = vdupq_n_f32(dt);
+    for (size_t i = 0; i < count; i += 4) {
+        float32x4_t vy = vmlaq_f32(vld1q_f32(a.velY + i), vld1q_f32(a.accelY + i), vdt);
+        float32x4_t vx = vld1q_f32(a.velX + i);
+        vst1q_f32(a.velY + i, vy);
+        vst1q_f32(a.posX + i, vmlaq_f32(vld1q_f32(a.posX + i), vx, vdt));
+        vst1q_f32(a.posY + i, vmlaq_f32(vld1q_f32(a.posY + i), vy, vdt));
+        vst1q_f32(a.rotation + i, vmlaq_f32(vld1q_f32(a.rotation + i), vld1q_f32(a.rotationSpeed + i), vdt));
+        vst1q_f32(a.life + i, vsubq_f32(vld1q_f32(a.life + i), vdt));
+    }
+}
+#else
+constexpr size_t SIMD_WIDTH = 1;
+
+void integrate(const ParticleArrays& a, size_t count, float dt) {
+    for (size_t i = 0; i < count; i++) {
+        a.velY[i] += a.accelY[i] * dt;
+        a.posX[i] += a.velX[i] * dt;
+        a.posY[i] += a.velY[i] * dt;
+        a.rotation[i] += a.rotationSpeed[i] * dt;
+        a.life[i] -= dt;
+    }
+}
+#endif
 
-void Particle::draw() const {
-    if (!active) return;
-
-    float alpha = getAlpha();
-    Color c = color;
-    c.a = static_cast<unsigned char>(c.a * alpha);
-
-    // 绘制带旋转的矩形
-    Rectangle rect = {position.x, position.y, size, size};
-    Vector2 origin = {size / 2, size / 2};
-    DrawRectanglePro(rect, origin, rotation, c);
+size_t roundUpToSimd(size_t n) {
+    return (n + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
 }
 
+} // namespace
+
 // ============================================================
 // EmitterConfig 实现
 // ============================================================
@@ -98,17 +153,27 @@ EmitterConfig EmitterConfig::sparkle(Vector2 pos) {
 // ============================================================
 // ParticleSystem 实现
 // ============================================================
-ParticleSystem::ParticleSystem() : nextIndex(0) {
-    particles.resize(MAX_PARTICLES);
-    for (auto& p : particles) {
-        p.active = false;
+ParticleSystem::ParticleSystem(size_t initialCapacity)
+    : capacity(0), activeCount(0) {
+    setCapacity(initialCapacity);
+}
+
+void ParticleSystem::setCapacity(size_t newCapacity) {
+    capacity = newCapacity;
+    activeCount = 0;
+
+    size_t padded = roundUpToSimd(capacity);
+    for (auto* array : {&posX, &posY, &velX, &velY, &accelY, &rotation, &rotationSpeed,
+                        &life, &invMaxLife, &size}) {
+        array->assign(padded, 0.0f);
     }
+    color.assign(padded, BLANK);
 }
 
 void ParticleSystem::emit(const EmitterConfig& config) {
     for (int i = 0; i < config.count; i++) {
-        Particle* p = getNextParticle();
-        if (!p) break;
+        if (activeCount >= capacity) break;
+        size_t p = activeCount++;
 
         // 随机角度
         float angle = GetRandomValue(0, static_cast<int>(config.spread)) * DEG2RAD;
@@ -123,16 +188,17 @@ void ParticleSystem::emit(const EmitterConfig& config) {
             static_cast<int>(config.maxSpeed)
         );
 
-        p->position = config.position;
-        p->velocity = {cosf(angle) * speed, sinf(angle) * speed};
-        p->acceleration = {0.0f, config.gravity};
-        p->color = config.startColor;
-        p->size = GetRandomValue(static_cast<int>(config.minSize), static_cast<int>(config.maxSize));
-        p->life = config.life;
-        p->maxLife = config.life;
-        p->rotation = GetRandomValue(0, 360);
-        p->rotationSpeed = GetRandomValue(-180, 180);
-        p->active = true;
+        posX[p] = config.position.x;
+        posY[p] = config.position.y;
+        velX[p] = cosf(angle) * speed;
+        velY[p] = sinf(angle) * speed;
+        accelY[p] = config.gravity;
+        color[p] = config.startColor;
+        size[p] = GetRandomValue(static_cast<int>(config.minSize), static_cast<int>(config.maxSize));
+        life[p] = config.life;
+        invMaxLife[p] = 1.0f / config.life;
+        rotation[p] = GetRandomValue(0, 360);
+        rotationSpeed[p] = GetRandomValue(-180, 180);
     }
 }
 
@@ -158,48 +224,39 @@ void ParticleSystem::emitSparkle(Vector2 pos, Color color) {
 }
 
 void ParticleSystem::update(float deltaTime) {
-    for (auto& p : particles) {
-        if (p.active) {
-            p.update(deltaTime);
-        }
-    }
-}
-
-void ParticleSystem::draw() {
-    for (const auto& p : particles) {
-        if (p.active) {
-            p.draw();
+    if (activeCount == 0) return;
+
+    ParticleArrays arrays = {
+        posX.data(), posY.data(), velX.data(), velY.data(), accelY.data(),
+        rotation.data(), rotationSpeed.data(), life.data()
+    };
+    integrate(arrays, roundUpToSimd(activeCount), deltaTime);
+
+    // 移除死亡粒子：用最后一个活跃粒子填补，保持区间稠密
+    size_t i = 0;
+    while (i < activeCount) {
+        if (life[i] <= 0) {
+            activeCount--;
+            moveParticle(activeCount, i);
+        } else {
+            i++;
         }
     }
 }
 
-void ParticleSystem::clear() {
-    for (auto& p : particles) {
-        p.active = false;
-    }
-    nextIndex = 0;
-}
-
-size_t ParticleSystem::getActiveCount() const {
-    size_t count = 0;
-    for (const auto& p : particles) {
-        if (p.active) count++;
-    }
-    return count;
-}
-
-Particle* ParticleSystem::getNextParticle() {
-    // 从 nextIndex 开始寻找非活跃粒子
-    size_t startIndex = nextIndex;
-    do {
-        if (!particles[nextIndex].active) {
-            return &particles[nextIndex];
-        }
-        nextIndex = (nextIndex + 1) % MAX_PARTICLES;
-    } while (nextIndex != startIndex);
-
-    // 如果没有可用粒子，返回 nullptr
-    return nullptr;
+void ParticleSystem::moveParticle(size_t from, size_t to) {
+    if (from == to) return;
+    posX[to] = posX[from];
+    posY[to] = posY[from];
+    velX[to] = velX[from];
+    velY[to] = velY[from];
+    accelY[to] = accelY[from];
+    rotation[to] = rotation[from];
+    rotationSpeed[to] = rotationSpeed[from];
+    life[to] = life[from];
+    invMaxLife[to] = invMaxLife[from];
+    size[to] = size[from];
+    color[to] = color[from];
 }
 
 // ============================================================
@@ -3,27 +3,6 @@
 #include <vector>
 #include <functional>
 
-// ============================================================
-// 粒子结构
-// ============================================================
-struct Particle {
-    Vector2 position;      // 位置
-    Vector2 velocity;      // 速度
-    Vector2 acceleration;  // 加速度
-    Color color;           // 颜色
-    float size;            // 大小
-    float life;            // 剩余生命（秒）
-    float maxLife;         // 最大生命
-    float rotation;        // 旋转角度
-    float rotationSpeed;   // 旋转速度
-    bool active;           // 是否激活
-
-    // 更新和绘制
-    void update(float deltaTime);
-    void draw() const;
-    float getAlpha() const { return life / maxLife; }
-};
-
 // ============================================================
 // 粒子发射器配置
 // ============================================================
@@ -47,16 +26,36 @@ struct EmitterConfig {
 };
 
 // ============================================================
-// 粒子系统 - 使用对象池模式
+// 粒子系统 - 结构体数组 (SoA) + 稠密活跃区间
 // ============================================================
+// 每个属性一个连续的 float 数组，活跃粒子始终位于 [0, activeCount)：
+//   - 发射：直接追加到末尾，O(1)
+//   - 死亡：与最后一个活跃粒子交换后缩短区间，O(1)
+//   - 更新：只遍历活跃区间，积分用 SIMD 一次处理 4/8 个粒子
+// 容量在运行时指定，对战模式可以容纳数万个粒子。
 class ParticleSystem {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1000;
+
 private:
-    static constexpr size_t MAX_PARTICLES = 1000;
-    std::vector<Particle> particles;
-    size_t nextIndex;  // 下一个可用的粒子索引
+    size_t capacity;
+    size_t activeCount;
+
+    // 每个数组按 SIMD 宽度向上取整，末尾的填充元素参与计算但永远不会被使用
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;
+    std::vector<float> accelY;          // 重力（水平加速度恒为 0，不再逐粒子存储）
+    std::vector<float> rotation, rotationSpeed;
+    std::vector<float> life, invMaxLife;
+    std::vector<float> size;
+    std::vector<Color> color;
 
 public:
-    ParticleSystem();
+    explicit ParticleSystem(size_t capacity = DEFAULT_CAPACITY);
+
+    // 重新设置容量（会清除所有粒子）
+    void setCapacity(size_t newCapacity);
+    size_t getCapacity() const { return capacity; }
 
     // 发射粒子
     void emit(const EmitterConfig& config);
@@ -64,19 +63,27 @@ public:
     void emitTrail(Vector2 pos, Color color);
     void emitSparkle(Vector2 pos, Color color);
 
-    // 更新和绘制
+    // 更新（绘制由 ParticleRenderer 批量完成）
     void update(float deltaTime);
-    void draw();
 
     // 清除所有粒子
-    void clear();
+    void clear() { activeCount = 0; }
 
     // 获取活跃粒子数
-    size_t getActiveCount() const;
+    size_t getActiveCount() const { return activeCount; }
+
+    // 只读访问 SoA 数组，下标范围 [0, getActiveCount())
+    const float* getPosX() const { return posX.data(); }
+    const float* getPosY() const { return posY.data(); }
+    const float* getRotation() const { return rotation.data(); }
+    const float* getLife() const { return life.data(); }
+    const float* getInvMaxLife() const { return invMaxLife.data(); }
+    const float* getSize() const { return size.data(); }
+    const Color* getColor() const { return color.data(); }
 
 private:
-    // 获取下一个可用粒子
-    Particle* getNextParticle();
+    // 把第 from 个粒子的全部属性复制到 to（删除时填补空位）
+    void moveParticle(size_t from, size_t to);
 };
 
 // ============================================================
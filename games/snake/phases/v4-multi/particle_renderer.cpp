@@ -0,0 +1,105 @@
+#include "particle_renderer.h"
+#include "rlgl.h"
+#include <cmath>
+
+ParticleRenderer::ParticleRenderer()
+    : quadCount(0), culledCount(0), estimatedBatches(0) {
+    for (int i = 0; i < ANGLE_STEPS; i++) {
+        float angle = i * (2.0f * PI / ANGLE_STEPS);
+        sinTable[i] = sinf(angle);
+        cosTable[i] = cosf(angle);
+    }
+}
+
+void ParticleRenderer::draw(const ParticleSystem& particles, Rectangle view) {
+    buildQuads(particles, view);
+    submit();
+}
+
+void ParticleRenderer::buildQuads(const ParticleSystem& particles, Rectangle view) {
+    const size_t count = particles.getActiveCount();
+
+    // 缓冲区只增不减，稳定后每帧不再分配
+    if (colors.size() < count) {
+        colors.resize(count);
+        vertices.resize(count * 4);
+    }
+
+    const float* posX = particles.getPosX();
+    const float* posY = particles.getPosY();
+    const float* rotation = particles.getRotation();
+    const float* life = particles.getLife();
+    const float* invMaxLife = particles.getInvMaxLife();
+    const float* size = particles.getSize();
+    const Color* color = particles.getColor();
+
+    const float right = view.x + view.width;
+    const float bottom = view.y + view.height;
+    const float degToStep = ANGLE_STEPS / 360.0f;
+
+    size_t quad = 0;
+    for (size_t i = 0; i < count; i++) {
+        // 旋转后的四边形不会超出以中心为圆心、半对角线为半径的范围
+        const float half = size[i] * 0.5f;
+        const float reach = half * 1.4143f;
+        const float x = posX[i];
+        const float y = posY[i];
+        if (x + reach < view.x || x - reach > right || y + reach < view.y || y - reach > bottom) {
+            continue;
+        }
+
+        // 角度取模用位与：负角度转成 int 后与 255 相与同样落在表内
+        const int step = static_cast<int>(rotation[i] * degToStep) & (ANGLE_STEPS - 1);
+        const float s = sinTable[step] * half;
+        const float c = cosTable[step] * half;
+
+        // 与 DrawRectanglePro 相同的顶点顺序：左上、左下、右下、右上
+        Vector2* v = &vertices[quad * 4];
+        v[0] = {x - c + s, y - s - c};
+        v[1] = {x - c - s, y - s + c};
+        v[2] = {x + c - s, y + s + c};
+        v[3] = {x + c + s, y + s - c};
+
+        Color col = color[i];
+        col.a = static_cast<unsigned char>(col.a * (life[i] * invMaxLife[i]));
+        colors[quad] = col;
+        quad++;
+    }
+
+    quadCount = quad;
+    culledCount = count - quad;
+}
+
+void ParticleRenderer::submit() {
+    estimatedBatches = 0;
+    if (quadCount == 0) return;
+
+    // 一块 rlgl 批次缓冲区能容纳的四边形数量
+    const size_t batchQuads = RL_DEFAULT_BATCH_BUFFER_ELEMENTS;
+
+    rlSetTexture(rlGetTextureIdDefault());
+    estimatedBatches = 1;
+
+    for (size_t start = 0; start < quadCount; start += batchQuads) {
+        size_t end = start + batchQuads < quadCount ? start + batchQuads : quadCount;
+
+        // 缓冲区不够时 rlgl 会先提交已有内容，这里记一次新的批次（rlgl 不公开提交次数，只能估计）
+        if (rlCheckRenderBatchLimit(static_cast<int>((end - start) * 4))) {
+            estimatedBatches++;
+        }
+
+        rlBegin(RL_QUADS);
+        for (size_t q = start; q < end; q++) {
+            const Color& c = colors[q];
+            const Vector2* v = &vertices[q * 4];
+            rlColor4ub(c.r, c.g, c.b, c.a);
+            rlVertex2f(v[0].x, v[0].y);
+            rlVertex2f(v[1].x, v[1].y);
+            rlVertex2f(v[2].x, v[2].y);
+            rlVertex2f(v[3].x, v[3].y);
+        }
+        rlEnd();
+    }
+
+    rlSetTexture(0);
+}
@@ -0,0 +1,358 @@
+#include "replay.h"
+#include "byte_stream.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+const uint8_t REPLAY_MAGIC[4] = {'S', 'N', 'R', 'P'};
+const uint8_t REPLAY_VERSION = 4;     // 2: 加入箱子（关卡配置和快照格式都变了）；3: 同时存在多个道具
+                                      // 4: 占用网格分块存储，快照只写非空格子，空闲格子取样顺序改变
+
+// 关卡部分（不含种子）；hashLevel 也用同样的字节序列
+void writeLevel(ByteWriter& w, const SimConfig& config) {
+    w.writeVarint(static_cast<uint64_t>(config.gridWidth));
+    w.writeVarint(static_cast<uint64_t>(config.gridHeight));
+    w.writeU8(config.versus ? 1 : 0);
+    w.writeSVarint(config.targetScore);
+    w.writeVarint(static_cast<uint64_t>(config.randomObstacles));
+    w.writeVarint(static_cast<uint64_t>(config.randomCrates));
+    w.writeVarint(static_cast<uint64_t>(config.itemCount));
+    w.writeVarint(config.walls.size());
+    for (const auto& p : config.walls) {
+        w.writeSVarint(p.x);
+        w.writeSVarint(p.y);
+    }
+    w.writeVarint(config.spawnPoints.size());
+    for (const auto& p : config.spawnPoints) {
+        w.writeSVarint(p.x);
+        w.writeSVarint(p.y);
+    }
+}
+
+bool readPositions(ByteReader& r, std::vector<Position>& out, uint64_t maxCount) {
+    uint64_t count = r.readVarint();
+    if (!r.ok() || count > maxCount) return false;
+    out.resize(static_cast<size_t>(count));
+    for (auto& p : out) {
+        p.x = static_cast<int>(r.readSVarint());
+        p.y = static_cast<int>(r.readSVarint());
+    }
+    return r.ok();
+}
+
+bool readLevel(ByteReader& r, SimConfig& config) {
+    config.gridWidth = static_cast<int>(r.readVarint());
+    config.gridHeight = static_cast<int>(r.readVarint());
+    config.versus = r.readU8() != 0;
+    config.targetScore = static_cast<int>(r.readSVarint());
+    config.randomObstacles = static_cast<int>(r.readVarint());
+    config.randomCrates = static_cast<int>(r.readVarint());
+    config.itemCount = static_cast<int>(r.readVarint());
+    if (!r.ok() || config.itemCount > ItemPool::MAX_ITEMS || config.gridWidth <= 0 || config.gridHeight <= 0 ||
+        config.gridWidth > ChunkedBitGrid::MAX_SIDE || config.gridHeight > ChunkedBitGrid::MAX_SIDE) {
+        return false;
+    }
+    uint64_t cellCount = static_cast<uint64_t>(config.gridWidth) * config.gridHeight;
+    return readPositions(r, config.walls, cellCount) &&
+           readPositions(r, config.spawnPoints, SnakeSim::MAX_PLAYERS);
+}
+
+} // namespace
+
+// ============================================================
+// Replay 实现
+// ============================================================
+Replay::Replay()
+    : levelHash(0), keyframeInterval(ReplayRecorder::DEFAULT_KEYFRAME_INTERVAL),
+      tickCount(0), finalStateHash(0) {
+    for (int& s : finalScores) s = 0;
+}
+
+uint64_t Replay::hashLevel(const SimConfig& config) {
+    std::vector<uint8_t> bytes;
+    ByteWriter w(bytes);
+    writeLevel(w, config);
+    return hashBytes(bytes.data(), bytes.size());
+}
+
+void Replay::encode(std::vector<uint8_t>& out) const {
+    ByteWriter w(out);
+    w.writeBytes(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    w.writeU8(REPLAY_VERSION);
+
+    writeLevel(w, config);
+    w.writeU64(config.seed);
+    w.writeU64(levelHash);
+
+    w.writeVarint(keyframeInterval);
+    w.writeVarint(tickCount);
+    for (int s : finalScores) w.writeSVarint(s);
+    w.writeU64(finalStateHash);
+
+    w.writeVarint(inputs.size());
+    w.writeBytes(inputs.data(), inputs.size());
+
+    w.writeVarint(keyframes.size());
+    for (const auto& kf : keyframes) {
+        w.writeVarint(kf.tick);
+        w.writeVarint(kf.inputOffset);
+        w.writeVarint(kf.lastInputTick);
+        w.writeVarint(kf.state.size());
+        w.writeBytes(kf.state.data(), kf.state.size());
+    }
+}
+
+bool Replay::decode(const uint8_t* data, size_t size) {
+    ByteReader r(data, size);
+
+    const uint8_t* magic = r.readBytes(sizeof(REPLAY_MAGIC));
+    if (!magic || !std::equal(magic, magic + sizeof(REPLAY_MAGIC), REPLAY_MAGIC)) {
+        return false;
+    }
+    if (r.readU8() != REPLAY_VERSION) {
+        return false;
+    }
+
+    Replay result;
+    if (!readLevel(r, result.config)) {
+        return false;
+    }
+    result.config.seed = r.readU64();
+    result.levelHash = r.readU64();
+    if (!r.ok() || result.levelHash != hashLevel(result.config)) {
+        return false;   // 关卡数据损坏
+    }
+
+    result.keyframeInterval = static_cast<uint32_t>(r.readVarint());
+    result.tickCount = r.readVarint();
+    for (int& s : result.finalScores) s = static_cast<int>(r.readSVarint());
+    result.finalStateHash = r.readU64();
+
+    uint64_t inputSize = r.readVarint();
+    const uint8_t* inputData = r.readBytes(static_cast<size_t>(inputSize));
+    if (!inputData || result.keyframeInterval == 0) {
+        return false;
+    }
+    result.inputs.assign(inputData, inputData + inputSize);
+
+    uint64_t keyframeCount = r.readVarint();
+    if (!r.ok() || keyframeCount > result.tickCount / result.keyframeInterval + 1) {
+        return false;
+    }
+    result.keyframes.resize(static_cast<size_t>(keyframeCount));
+    for (auto& kf : result.keyframes) {
+        kf.tick = r.readVarint();
+        kf.inputOffset = r.readVarint();
+        kf.lastInputTick = r.readVarint();
+        uint64_t stateSize = r.readVarint();
+        const uint8_t* stateData = r.readBytes(static_cast<size_t>(stateSize));
+        if (!stateData || kf.inputOffset > inputSize || kf.tick > result.tickCount) {
+            return false;
+        }
+        kf.state.assign(stateData, stateData + stateSize);
+    }
+    if (!r.ok()) {
+        return false;
+    }
+
+    *this = std::move(result);
+    return true;
+}
+
+bool Replay::save(const std::string& path) const {
+    std::vector<uint8_t> bytes;
+    encode(bytes);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return file.good();
+}
+
+bool Replay::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return decode(bytes.data(), bytes.size());
+}
+
+// ============================================================
+// ReplayRecorder 实现
+// ============================================================
+ReplayRecorder::ReplayRecorder()
+    : lastInputTick(0), recording(false) {
+}
+
+void ReplayRecorder::begin(const SnakeSim& sim, uint32_t keyframeInterval) {
+    replay = Replay();
+    replay.config = sim.getConfig();
+    replay.levelHash = Replay::hashLevel(replay.config);
+    replay.keyframeInterval = keyframeInterval > 0 ? keyframeInterval : DEFAULT_KEYFRAME_INTERVAL;
+    lastInputTick = 0;
+    recording = true;
+
+    // tick 0 也存一帧，跳转时总能找到起点
+    ReplayKeyframe kf;
+    kf.tick = sim.getTick();
+    kf.inputOffset = 0;
+    kf.lastInputTick = 0;
+    sim.saveState(kf.state);
+    replay.keyframes.push_back(std::move(kf));
+}
+
+void ReplayRecorder::record(const TickInput& input, const SnakeSim& sim) {
+    uint64_t tick = sim.getTick();
+    if (!recording || tick <= replay.tickCount) {
+        return;     // 对局已结束，step 没有推进
+    }
+    replay.tickCount = tick;
+
+    uint8_t turns = static_cast<uint8_t>(static_cast<uint8_t>(input.turns[0]) |
+                                         (static_cast<uint8_t>(input.turns[1]) << 4));
+    if (turns != 0) {
+        ByteWriter w(replay.inputs);
+        w.writeVarint(tick - lastInputTick);
+        w.writeU8(turns);
+        lastInputTick = tick;
+    }
+
+    if (tick % replay.keyframeInterval == 0 && !sim.isGameOver()) {
+        ReplayKeyframe kf;
+        kf.tick = tick;
+        kf.inputOffset = replay.inputs.size();
+        kf.lastInputTick = lastInputTick;
+        sim.saveState(kf.state);
+        replay.keyframes.push_back(std::move(kf));
+    }
+}
+
+void ReplayRecorder::finish(const SnakeSim& sim) {
+    if (!recording) return;
+    for (int p = 0; p < SnakeSim::MAX_PLAYERS; p++) {
+        replay.finalScores[p] = p < sim.getPlayerCount() ? sim.getScore(p) : 0;
+    }
+    replay.finalStateHash = sim.getStateHash();
+    recording = false;
+}
+
+// ============================================================
+// ReplayPlayer 实现
+// ============================================================
+ReplayPlayer::ReplayPlayer()
+    : loaded(false), inputOffset(0), nextInputTick(0), nextTurns(0) {
+}
+
+bool ReplayPlayer::load(const std::string& path) {
+    Replay source;
+    if (!source.load(path)) {
+        return false;
+    }
+    open(source);
+    return true;
+}
+
+void ReplayPlayer::open(const Replay& source) {
+    replay = source;
+    loaded = true;
+    setCursor(0, 0);
+}
+
+std::unique_ptr<SnakeSim> ReplayPlayer::createSim() const {
+    return std::make_unique<SnakeSim>(replay.config);
+}
+
+void ReplayPlayer::restart(SnakeSim& sim) {
+    sim.reset(replay.config.seed);
+    setCursor(0, 0);
+}
+
+void ReplayPlayer::setCursor(uint64_t offset, uint64_t lastInputTick) {
+    // 预读下一条记录
+    ByteReader r(replay.inputs.data(), replay.inputs.size());
+    r.seek(static_cast<size_t>(offset));
+    nextInputTick = 0;
+    nextTurns = 0;
+    if (!r.atEnd()) {
+        uint64_t delta = r.readVarint();
+        uint8_t turns = r.readU8();
+        if (r.ok() && delta > 0) {
+            nextInputTick = lastInputTick + delta;
+            nextTurns = turns;
+        }
+    }
+    inputOffset = r.position();
+}
+
+bool ReplayPlayer::isFinished(const SnakeSim& sim) const {
+    return sim.getTick() >= replay.tickCount || sim.isGameOver();
+}
+
+bool ReplayPlayer::step(SnakeSim& sim) {
+    if (!loaded || isFinished(sim)) {
+        return false;
+    }
+
+    uint64_t tick = sim.getTick() + 1;
+    TickInput input;
+    if (nextInputTick == tick) {
+        input.turns[0] = static_cast<TurnCommand>(nextTurns & 0x0F);
+        input.turns[1] = static_cast<TurnCommand>(nextTurns >> 4);
+        setCursor(inputOffset, tick);
+    }
+    sim.step(input);
+    return true;
+}
+
+void ReplayPlayer::seek(SnakeSim& sim, uint64_t tick) {
+    if (!loaded) return;
+    tick = std::min(tick, replay.tickCount);
+
+    // 最近的、不晚于目标的关键帧
+    auto it = std::upper_bound(replay.keyframes.begin(), replay.keyframes.end(), tick,
+        [](uint64_t t, const ReplayKeyframe& kf) { return t < kf.tick; });
+
+    if (it == replay.keyframes.begin()) {
+        restart(sim);
+    } else {
+        const ReplayKeyframe& kf = *(it - 1);
+        // 目标就在当前位置之后且中间没有更近的关键帧时，直接往前推进即可
+        bool forward = sim.getTick() <= tick && sim.getTick() >= kf.tick;
+        if (!forward) {
+            if (sim.loadState(kf.state.data(), kf.state.size())) {
+                setCursor(kf.inputOffset, kf.lastInputTick);
+            } else {
+                restart(sim);
+            }
+        }
+    }
+
+    while (sim.getTick() < tick && step(sim)) {
+    }
+}
+
+ReplayResult ReplayPlayer::runHeadless(const Replay& source) {
+    ReplayPlayer player;
+    player.open(source);
+    std::unique_ptr<SnakeSim> sim = player.createSim();
+
+    while (player.step(*sim)) {
+    }
+
+    ReplayResult result;
+    result.ticks = sim->getTick();
+    for (int p = 0; p < SnakeSim::MAX_PLAYERS; p++) {
+        result.scores[p] = p < sim->getPlayerCount() ? sim->getScore(p) : 0;
+    }
+    result.stateHash = sim->getStateHash();
+    result.matches = result.ticks == source.tickCount && result.stateHash == source.finalStateHash;
+    for (int p = 0; p < SnakeSim::MAX_PLAYERS; p++) {
+        result.matches = result.matches && result.scores[p] == source.finalScores[p];
+    }
+    return result;
+}
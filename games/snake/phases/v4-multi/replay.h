@@ -0,0 +1,123 @@
+#pragma once
+#include "snake_sim.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ============================================================
+// 回放 - 种子 + 关卡 + 每个 tick 的输入，外加定期的状态关键帧
+// ============================================================
+// 模拟核心是确定性的，所以只需记录输入就能重现整局：
+//   输入流：只记录有转向的 tick，格式为 varint(与上一条的 tick 差) + 1 字节命令
+//           （低 4 位 = P1，高 4 位 = P2）
+//   关键帧：每 keyframeInterval 个 tick 保存一次 SnakeSim 快照和对应的输入流位置，
+//           跳转到任意 tick 只需从最近的关键帧往后推进，不必从头重放。
+
+// 状态关键帧：第 tick 个 tick 结束后的状态
+struct ReplayKeyframe {
+    uint64_t tick;
+    uint64_t inputOffset;       // 之后第一条输入记录在输入流中的字节位置
+    uint64_t lastInputTick;     // 之前最后一条输入记录的 tick（解码差值用）
+    std::vector<uint8_t> state; // SnakeSim::saveState 的结果
+};
+
+struct Replay {
+    SimConfig config;           // 包含种子和关卡（墙壁、出生点）
+    uint64_t levelHash;         // 关卡内容的哈希，加载时校验
+    uint32_t keyframeInterval;
+    uint64_t tickCount;         // 总 tick 数
+    std::vector<uint8_t> inputs;
+    std::vector<ReplayKeyframe> keyframes;
+
+    // 录制结束时的结果，回归测试用
+    int finalScores[SnakeSim::MAX_PLAYERS];
+    uint64_t finalStateHash;
+
+    Replay();
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    void encode(std::vector<uint8_t>& out) const;
+    bool decode(const uint8_t* data, size_t size);
+
+    // 关卡哈希（网格尺寸、模式、目标分数、墙壁、出生点；不含种子）
+    static uint64_t hashLevel(const SimConfig& config);
+};
+
+// ============================================================
+// ReplayRecorder - 录制（挂在 Game::updatePlaying 的 step 之后）
+// ============================================================
+class ReplayRecorder {
+public:
+    static constexpr uint32_t DEFAULT_KEYFRAME_INTERVAL = 256;
+
+private:
+    Replay replay;
+    uint64_t lastInputTick;
+    bool recording;
+
+public:
+    ReplayRecorder();
+
+    // 开始录制，sim 必须处于刚 reset 的状态（tick 0）
+    void begin(const SnakeSim& sim, uint32_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+    // 每次 sim.step(input) 之后调用
+    void record(const TickInput& input, const SnakeSim& sim);
+    // 对局结束时调用，记下最终结果
+    void finish(const SnakeSim& sim);
+
+    bool isRecording() const { return recording; }
+    const Replay& getReplay() const { return replay; }
+};
+
+// 无渲染快进的结果
+struct ReplayResult {
+    uint64_t ticks;
+    int scores[SnakeSim::MAX_PLAYERS];
+    uint64_t stateHash;
+    bool matches;               // 是否与录制时的最终结果一致
+};
+
+// ============================================================
+// ReplayPlayer - 播放、跳转、无渲染快进
+// ============================================================
+class ReplayPlayer {
+private:
+    Replay replay;
+    bool loaded;
+
+    // 输入流游标
+    size_t inputOffset;         // 下一条记录的位置
+    uint64_t nextInputTick;     // 下一条记录的 tick（没有记录时为 0）
+    uint8_t nextTurns;
+
+public:
+    ReplayPlayer();
+
+    bool load(const std::string& path);
+    void open(const Replay& source);
+    void close() { loaded = false; }
+    bool isLoaded() const { return loaded; }
+    const Replay& getReplay() const { return replay; }
+    uint64_t getTickCount() const { return replay.tickCount; }
+
+    // 创建与录制时配置相同的模拟（位于 tick 0）
+    std::unique_ptr<SnakeSim> createSim() const;
+
+    // 回到开头
+    void restart(SnakeSim& sim);
+    // 推进一个 tick，已经播完时返回 false
+    bool step(SnakeSim& sim);
+    bool isFinished(const SnakeSim& sim) const;
+
+    // 跳转到指定 tick：从不晚于它的最近关键帧恢复，再推进至多 keyframeInterval 个 tick
+    void seek(SnakeSim& sim, uint64_t tick);
+
+    // 以最快速度无渲染跑完整个回放，并与录制结果比较
+    static ReplayResult runHeadless(const Replay& replay);
+
+private:
+    void setCursor(uint64_t offset, uint64_t lastInputTick);
+};
@@ -0,0 +1,44 @@
+// ============================================================
+// snake-replay-check - 无渲染快进回放，做回归检查
+// ============================================================
+// 用法: snake-replay-check <回放文件>...
+// 以最快速度重跑每个回放，与录制时的最终分数和状态哈希比较。
+// 全部一致时返回 0；模拟逻辑改变导致结果不同时返回 1。
+#include "replay.h"
+#include <chrono>
+#include <cstdio>
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::printf("用法: %s <回放文件>...\n", argv[0]);
+        return 2;
+    }
+
+    int failures = 0;
+    for (int i = 1; i < argc; i++) {
+        Replay replay;
+        if (!replay.load(argv[i])) {
+            std::printf("[错误] %s: 无法读取或格式错误\n", argv[i]);
+            failures++;
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        ReplayResult result = ReplayPlayer::runHeadless(replay);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::printf("[%s] %s: %llu ticks, 分数 %d/%d, %.0f ticks/s\n",
+                    result.matches ? "通过" : "不一致", argv[i],
+                    static_cast<unsigned long long>(result.ticks),
+                    result.scores[0], result.scores[1],
+                    seconds > 0 ? result.ticks / seconds : 0.0);
+        if (!result.matches) {
+            std::printf("    录制时: %llu ticks, 分数 %d/%d\n",
+                        static_cast<unsigned long long>(replay.tickCount),
+                        replay.finalScores[0], replay.finalScores[1]);
+            failures++;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
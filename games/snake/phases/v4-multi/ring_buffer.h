@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+// ============================================================
+// RingBuffer - 容量为 2 的幂的环形缓冲区
+// ============================================================
+// 用于蛇身：头部在 front，push_front/pop_back 只移动下标，
+// 存储是一整块连续内存，稳态下移动不会发生任何内存分配。
+// 下标取模用位与 (index & mask) 代替除法。
+template <typename T>
+class RingBuffer {
+private:
+    std::vector<T> storage;
+    size_t head;    // front 元素在 storage 中的位置
+    size_t count;
+    size_t mask;    // storage.size() - 1
+
+public:
+    // ---------- 只读迭代器（按 front -> back 顺序） ----------
+    class const_iterator {
+    private:
+        const RingBuffer* buffer;
+        size_t index;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator(const RingBuffer* buf, size_t i) : buffer(buf), index(i) {}
+
+        reference operator*() const { return (*buffer)[index]; }
+        pointer operator->() const { return &(*buffer)[index]; }
+        reference operator[](difference_type n) const { return (*buffer)[index + n]; }
+
+        const_iterator& operator++() { ++index; return *this; }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++index; return tmp; }
+        const_iterator& operator--() { --index; return *this; }
+        const_iterator operator--(int) { const_iterator tmp = *this; --index; return tmp; }
+        const_iterator& operator+=(difference_type n) { index += n; return *this; }
+        const_iterator& operator-=(difference_type n) { index -= n; return *this; }
+        const_iterator operator+(difference_type n) const { return const_iterator(buffer, index + n); }
+        const_iterator operator-(difference_type n) const { return const_iterator(buffer, index - n); }
+        difference_type operator-(const const_iterator& other) const {
+            return static_cast<difference_type>(index) - static_cast<difference_type>(other.index);
+        }
+
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+        bool operator<(const const_iterator& other) const { return index < other.index; }
+    };
+
+    explicit RingBuffer(size_t minCapacity = 16)
+        : head(0), count(0), mask(0) {
+        reserve(minCapacity);
+    }
+
+    // 把容量扩到 >= minCapacity 的 2 的幂（只在初始化或意外溢出时发生）
+    void reserve(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) capacity <<= 1;
+        if (capacity <= storage.size()) return;
+
+        std::vector<T> grown(capacity);
+        for (size_t i = 0; i < count; i++) {
+            grown[i] = (*this)[i];
+        }
+        storage.swap(grown);
+        head = 0;
+        mask = capacity - 1;
+    }
+
+    void push_front(const T& value) {
+        if (count == storage.size()) {
+            reserve(storage.size() * 2);
+        }
+        head = (head - 1) & mask;
+        storage[head] = value;
+        count++;
+    }
+
+    void push_back(const T& value) {
+        if (count == storage.size()) {
+            reserve(storage.size() * 2);
+        }
+        storage[(head + count) & mask] = value;
+        count++;
+    }
+
+    void pop_back() {
+        if (count > 0) count--;
+    }
+
+    void pop_front() {
+        if (count > 0) {
+            head = (head + 1) & mask;
+            count--;
+        }
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    const T& operator[](size_t i) const { return storage[(head + i) & mask]; }
+    T& operator[](size_t i) { return storage[(head + i) & mask]; }
+
+    const T& front() const { return storage[head]; }
+    const T& back() const { return storage[(head + count - 1) & mask]; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return storage.size(); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+};
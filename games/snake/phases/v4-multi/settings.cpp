@@ -1,75 +1,113 @@
 #include "settings.h"
 #include "audio_system.h"
+#include "durable_file.h"
+#include "json.h"
+#include <condition_variable>
 #include <fstream>
-#include <sstream>
+#include <iterator>
+#include <mutex>
 #include <cstdio>
 #include <sys/stat.h>
 
+namespace {
+
+void ensureDirectory() {
+    #ifdef _WIN32
+    _mkdir("data");
+    #else
+    mkdir("data", 0755);
+    #endif
+}
+
+} // namespace
+
 // ============================================================
 // Settings 实现
 // ============================================================
 std::string Settings::toJson() const {
-    std::stringstream ss;
-    ss << "{"
-       << "\"masterVolume\":" << masterVolume << ","
-       << "\"sfxVolume\":" << sfxVolume << ","
-       << "\"musicVolume\":" << musicVolume << ","
-       << "\"muted\":" << (muted ? "true" : "false") << ","
-       << "\"difficulty\":" << static_cast<int>(difficulty) << ","
-       << "\"showFPS\":" << (showFPS ? "true" : "false") << ","
-       << "\"fullscreen\":" << (fullscreen ? "true" : "false")
-       << "}";
-    return ss.str();
+    std::string json;
+    JsonWriter w(json);
+    w.beginObject();
+    w.field("masterVolume", masterVolume);
+    w.field("sfxVolume", sfxVolume);
+    w.field("musicVolume", musicVolume);
+    w.field("muted", muted);
+    w.field("difficulty", static_cast<int>(difficulty));
+    w.field("showFPS", showFPS);
+    w.field("fullscreen", fullscreen);
+    w.endObject();
+    return json;
 }
 
-Settings Settings::fromJson(const std::string& json) {
-    Settings s;
-
-    // 简单的键值解析
-    auto parseFloat = [&json](const std::string& key) -> float {
-        size_t pos = json.find("\"" + key + "\":");
-        if (pos != std::string::npos) {
-            pos += key.length() + 3;
-            return std::stof(json.substr(pos));
+bool Settings::fromJson(std::string_view json, Settings& s, std::string& error) {
+    s = Settings();
+
+    // 缺少的键保持默认值
+    JsonReader r(json);
+    if (r.beginObject()) {
+        std::string_view key;
+        while (r.nextKey(key)) {
+            if (key == "masterVolume") s.masterVolume = r.readFloat();
+            else if (key == "sfxVolume") s.sfxVolume = r.readFloat();
+            else if (key == "musicVolume") s.musicVolume = r.readFloat();
+            else if (key == "muted") s.muted = r.readBool();
+            else if (key == "difficulty") {
+                int d = r.readInt();
+                if (d < 0 || d > static_cast<int>(Difficulty::HARD)) r.fail("无效的难度");
+                s.difficulty = static_cast<Difficulty>(d);
+            }
+            else if (key == "showFPS") s.showFPS = r.readBool();
+            else if (key == "fullscreen") s.fullscreen = r.readBool();
+            else r.skipValue();
         }
-        return 0.0f;
-    };
-
-    auto parseBool = [&json](const std::string& key) -> bool {
-        size_t pos = json.find("\"" + key + "\":");
-        if (pos != std::string::npos) {
-            pos += key.length() + 3;
-            return json.substr(pos, 4) == "true";
-        }
-        return false;
-    };
+    }
 
-    auto parseInt = [&json](const std::string& key) -> int {
-        size_t pos = json.find("\"" + key + "\":");
-        if (pos != std::string::npos) {
-            pos += key.length() + 3;
-            return std::stoi(json.substr(pos));
-        }
-        return 0;
-    };
-
-    s.masterVolume = parseFloat("masterVolume");
-    s.sfxVolume = parseFloat("sfxVolume");
-    s.musicVolume = parseFloat("musicVolume");
-    s.muted = parseBool("muted");
-    s.difficulty = static_cast<Settings::Difficulty>(parseInt("difficulty"));
-    s.showFPS = parseBool("showFPS");
-    s.fullscreen = parseBool("fullscreen");
-
-    return s;
+    if (!r.finish()) {
+        error = r.getError();
+        return false;
+    }
+    return true;
 }
 
 // ============================================================
 // SettingsManager 实现
 // ============================================================
+struct SettingsManager::Writer {
+    std::mutex mutex;
+    std::condition_variable wake;       // 有新内容或要退出
+    std::condition_variable written;    // 一次写盘完成
+    std::string path;
+    std::string pending;                // 最新的待写内容，只保留一份
+    std::chrono::steady_clock::time_point due;     // 防抖：到这个时间才写
+    uint64_t requested = 0;             // 已提交的版本号
+    uint64_t completed = 0;             // 已写完（或写失败放弃）的版本号
+    bool dirty = false;
+    bool urgent = false;                // 不等防抖，立即写
+    bool stopping = false;
+};
+
 SettingsManager::SettingsManager(const std::string& fname)
-    : filename(fname) {
+    : filename(fname), writer(std::make_shared<Writer>()) {
+    writer->path = getFullPath();
     load();
+    writerThread = std::thread(&SettingsManager::writerLoop, writer);
+}
+
+SettingsManager::~SettingsManager() {
+    const bool done = flush(SHUTDOWN_TIMEOUT);
+    {
+        std::lock_guard<std::mutex> lock(writer->mutex);
+        writer->stopping = true;
+    }
+    writer->wake.notify_one();
+
+    if (done) {
+        writerThread.join();
+    } else {
+        // 磁盘卡住时不拖住退出：线程持有共享状态，写完后自行结束
+        TraceLog(LOG_WARNING, "SETTINGS: 等待写盘超时，放弃保存");
+        writerThread.detach();
+    }
 }
 
 bool SettingsManager::load() {
@@ -84,22 +122,80 @@ bool SettingsManager::load() {
 
     std::string json((std::istreambuf_iterator<char>(file)),
                       std::istreambuf_iterator<char>());
-    current = Settings::fromJson(json);
+    std::string error;
+    if (!Settings::fromJson(json, current, error)) {
+        // 文件损坏，使用默认设置
+        TraceLog(LOG_WARNING, "SETTINGS: [%s] %s", fullPath.c_str(), error.c_str());
+        current = Settings();
+        return false;
+    }
 
     return true;
 }
 
-bool SettingsManager::save() const {
-    ensureDirectory();
-    std::string fullPath = getFullPath();
-    std::ofstream file(fullPath);
+void SettingsManager::requestSave() {
+    submit(false);
+}
 
-    if (!file.is_open()) {
-        return false;
+void SettingsManager::save() {
+    submit(true);
+}
+
+void SettingsManager::submit(bool immediate) {
+    // 设置只有几个字段，序列化的开销可以忽略；写盘线程只看最新一份
+    std::string json = current.toJson();
+    bool wasDirty;
+    {
+        std::lock_guard<std::mutex> lock(writer->mutex);
+        wasDirty = writer->dirty;
+        writer->pending = std::move(json);
+        writer->dirty = true;
+        writer->requested++;
+        writer->due = std::chrono::steady_clock::now() + SAVE_DELAY;
+        writer->urgent = writer->urgent || immediate;
+    }
+    // 已经在防抖等待中时不必唤醒：线程到点醒来会发现 due 被推后了
+    if (!wasDirty || immediate) {
+        writer->wake.notify_one();
     }
+}
 
-    file << current.toJson();
-    return true;
+bool SettingsManager::flush(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(writer->mutex);
+    if (writer->dirty) {
+        writer->urgent = true;
+        writer->wake.notify_one();
+    }
+    const uint64_t target = writer->requested;
+    return writer->written.wait_for(lock, timeout, [&] { return writer->completed >= target; });
+}
+
+void SettingsManager::writerLoop(std::shared_ptr<Writer> w) {
+    std::unique_lock<std::mutex> lock(w->mutex);
+    for (;;) {
+        w->wake.wait(lock, [&] { return w->dirty || w->stopping; });
+        if (!w->dirty) break;
+
+        // 防抖：每次新的修改都会把 due 往后推
+        while (!w->urgent && !w->stopping && std::chrono::steady_clock::now() < w->due) {
+            w->wake.wait_until(lock, w->due);
+        }
+
+        std::string data = std::move(w->pending);
+        const uint64_t version = w->requested;
+        w->dirty = false;
+        w->urgent = false;
+
+        lock.unlock();
+        ensureDirectory();
+        if (!writeFileAtomic(w->path, reinterpret_cast<const uint8_t*>(data.data()), data.size())) {
+            TraceLog(LOG_WARNING, "SETTINGS: [%s] 保存失败", w->path.c_str());
+        }
+        lock.lock();
+
+        w->completed = version;
+        w->written.notify_all();
+    }
 }
 
 void SettingsManager::applyToAudio() {
@@ -113,11 +209,3 @@ void SettingsManager::applyToAudio() {
 std::string SettingsManager::getFullPath() const {
     return "data/" + filename;
 }
-
-void SettingsManager::ensureDirectory() const {
-    #ifdef _WIN32
-    _mkdir("data");
-    #else
-    mkdir("data", 0755);
-    #endif
-}
@@ -1,5 +1,9 @@
 #pragma once
+#include <chrono>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <thread>
 
 // ============================================================
 // 设置结构
@@ -23,25 +27,46 @@ struct Settings {
     // int keyUp = KEY_UP;
     // int keyDown = KEY_DOWN;
 
-    // 序列化
+    // 序列化；解析失败时返回 false，error 为带行列号的原因
     std::string toJson() const;
-    static Settings fromJson(const std::string& json);
+    static bool fromJson(std::string_view json, Settings& s, std::string& error);
 };
 
 // ============================================================
 // 设置管理器
 // ============================================================
+// 写盘全部交给后台线程：requestSave() 只记下最新内容，连续修改
+// （例如按住方向键拖音量条）停下 SAVE_DELAY 之后才写一次；
+// 写入走“临时文件 + fsync + rename”，不会留下写了一半的设置文件。
+// 析构时最多等 SHUTDOWN_TIMEOUT 让写盘完成，超时就放弃等待直接退出。
 class SettingsManager {
+public:
+    static constexpr std::chrono::milliseconds SAVE_DELAY{500};
+    static constexpr std::chrono::milliseconds SHUTDOWN_TIMEOUT{1000};
+
 private:
+    struct Writer;      // 与写盘线程共享的状态，超时退出时由线程自己持有
+
     Settings current;
     std::string filename;
+    std::shared_ptr<Writer> writer;
+    std::thread writerThread;
 
 public:
     SettingsManager(const std::string& filename = "settings.json");
+    ~SettingsManager();
 
-    // 加载和保存
+    SettingsManager(const SettingsManager&) = delete;
+    SettingsManager& operator=(const SettingsManager&) = delete;
+
+    // 加载（启动时同步读取）
     bool load();
-    bool save() const;
+
+    // 保存当前设置，都不阻塞：requestSave 等修改停下来再写，save 立即交给写盘线程
+    void requestSave();
+    void save();
+    // 等待尚未写出的修改落盘，最多等 timeout；返回是否已全部写完
+    bool flush(std::chrono::milliseconds timeout);
 
     // 获取和设置
     Settings& get() { return current; }
@@ -53,6 +78,7 @@ public:
     void applyToAudio();
 
 private:
+    void submit(bool immediate);
+    static void writerLoop(std::shared_ptr<Writer> writer);
     std::string getFullPath() const;
-    void ensureDirectory() const;
 };
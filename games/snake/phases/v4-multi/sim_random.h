@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+
+// ============================================================
+// SimRandom - 可复现的伪随机数生成器（xorshift64*）
+// ============================================================
+// 模拟核心不能使用 raylib 的全局 GetRandomValue：
+// 同一个种子必须得到完全相同的对局，状态也要能保存/恢复。
+class SimRandom {
+private:
+    uint64_t state;
+
+public:
+    explicit SimRandom(uint64_t seed = 1) { setSeed(seed); }
+
+    void setSeed(uint64_t seed) {
+        // splitmix64 打散种子，保证状态非零
+        uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        state = (z ^ (z >> 31)) | 1;
+    }
+
+    uint32_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return static_cast<uint32_t>((state * 0x2545F4914F6CDD1DULL) >> 32);
+    }
+
+    // 返回 [min, max] 闭区间内的整数，语义与 GetRandomValue 相同
+    int range(int min, int max) {
+        if (max <= min) return min;
+        uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+        return min + static_cast<int>((static_cast<uint64_t>(next()) * span) >> 32);
+    }
+
+    // 状态读写（用于存档/回放关键帧）
+    uint64_t getState() const { return state; }
+    void setState(uint64_t s) { state = s ? s : 1; }
+};
@@ -1,44 +1,28 @@
 #include "snake.h"
+#include <algorithm>
 
 Snake::Snake(int startX, int startY, int gridW, int gridH)
-    : direction(Direction::RIGHT), nextDirection(Direction::RIGHT),
-      growthPending(0), gridWidth(gridW), gridHeight(gridH) {
+    : body(std::min(static_cast<size_t>(gridW) * gridH + 3, INITIAL_BODY_CAPACITY)),  // 蛇最长铺满整个网格，+3 是出生时可能越界的身体
+      direction(Direction::RIGHT), nextDirection(Direction::RIGHT),
+      growthPending(0), gridWidth(gridW), gridHeight(gridH),
+      grid(nullptr), owner(CellOwner::PLAYER1), lastBlocker(CellOwner::EMPTY),
+      advanced(false) {
     // 初始长度3
     body.push_back({startX, startY});
     body.push_back({startX - 1, startY});
     body.push_back({startX - 2, startY});
+    prevTail = body.back();
 }
 
-void Snake::updateDirection() {
-    // 玩家1 - WASD控制
-    if (IsKeyPressed(KEY_W) && !isOpposite(direction, Direction::UP)) {
-        nextDirection = Direction::UP;
-    }
-    if (IsKeyPressed(KEY_S) && !isOpposite(direction, Direction::DOWN)) {
-        nextDirection = Direction::DOWN;
-    }
-    if (IsKeyPressed(KEY_A) && !isOpposite(direction, Direction::LEFT)) {
-        nextDirection = Direction::LEFT;
-    }
-    if (IsKeyPressed(KEY_D) && !isOpposite(direction, Direction::RIGHT)) {
-        nextDirection = Direction::RIGHT;
-    }
+Snake::~Snake() {
+    releaseBody();
 }
 
-void Snake::updateDirectionPlayer2() {
-    // 玩家2 - 方向键控制
-    if (IsKeyPressed(KEY_UP) && !isOpposite(direction, Direction::UP)) {
-        nextDirection = Direction::UP;
-    }
-    if (IsKeyPressed(KEY_DOWN) && !isOpposite(direction, Direction::DOWN)) {
-        nextDirection = Direction::DOWN;
-    }
-    if (IsKeyPressed(KEY_LEFT) && !isOpposite(direction, Direction::LEFT)) {
-        nextDirection = Direction::LEFT;
-    }
-    if (IsKeyPressed(KEY_RIGHT) && !isOpposite(direction, Direction::RIGHT)) {
-        nextDirection = Direction::RIGHT;
-    }
+void Snake::bindGrid(OccupancyGrid* occupancy, CellOwner tag) {
+    releaseBody();
+    grid = occupancy;
+    owner = tag;
+    claimBody();
 }
 
 void Snake::setNextDirection(Direction dir) {
@@ -47,57 +31,76 @@ void Snake::setNextDirection(Direction dir) {
     }
 }
 
+Position Snake::getNextHead() const {
+    Position next = body.front();
+    switch (nextDirection) {
+        case Direction::UP:    next.y--; break;
+        case Direction::DOWN:  next.y++; break;
+        case Direction::LEFT:  next.x--; break;
+        case Direction::RIGHT: next.x++; break;
+    }
+    return next;
+}
+
 bool Snake::move() {
     direction = nextDirection;
 
-    Position newHead = body.front();
-    switch (direction) {
-        case Direction::UP:    newHead.y--; break;
-        case Direction::DOWN:  newHead.y++; break;
-        case Direction::LEFT:  newHead.x--; break;
-        case Direction::RIGHT: newHead.x++; break;
-    }
+    Position newHead = getNextHead();
 
-    // 检查墙壁碰撞
-    if (checkWallCollision(newHead)) {
-        return false;
-    }
+    if (grid) {
+        // 一次查表同时覆盖边界、自身、对手和障碍物
+        // 注意：蛇尾此时还没收缩，撞到自己的尾巴同样算碰撞
+        if (!grid->isPassable(newHead.x, newHead.y)) {
+            lastBlocker = grid->get(newHead.x, newHead.y);
+            advanced = false;
+            return false;
+        }
+    } else {
+        // 检查墙壁碰撞
+        if (checkWallCollision(newHead)) {
+            lastBlocker = CellOwner::WALL;
+            advanced = false;
+            return false;
+        }
 
-    // 检查自身碰撞
-    if (checkSelfCollision(newHead)) {
-        return false;
+        // 检查自身碰撞
+        if (checkSelfCollision(newHead)) {
+            lastBlocker = owner;
+            advanced = false;
+            return false;
+        }
     }
 
     // 移动
     body.push_front(newHead);
+    if (grid) {
+        grid->set(newHead.x, newHead.y, owner);
+    }
 
-    // 处理生长
+    // 处理生长（生长时蛇尾原地不动）
+    prevTail = body.back();
     if (growthPending > 0) {
         growthPending--;
     } else {
+        if (grid) {
+            grid->release(body.back().x, body.back().y, owner);
+        }
         body.pop_back();
     }
 
+    lastBlocker = CellOwner::EMPTY;
+    advanced = true;
     return true;
 }
 
-void Snake::draw(int gridSize) const {
-    for (size_t i = 0; i < body.size(); i++) {
-        const auto& pos = body[i];
-        Color color = (i == 0) ? DARKGREEN : GREEN;
-
-        // 蛇头稍微大一点
-        int padding = (i == 0) ? 1 : 2;
-        DrawRectangle(pos.x * gridSize + padding, pos.y * gridSize + padding,
-                      gridSize - padding * 2, gridSize - padding * 2, color);
-    }
-}
-
 void Snake::grow(int amount) {
     growthPending += amount;
 }
 
 bool Snake::checkSelfCollision(const Position& pos) const {
+    if (grid) {
+        return grid->get(pos.x, pos.y) == owner;
+    }
     for (const auto& segment : body) {
         if (segment == pos) {
             return true;
@@ -111,18 +114,51 @@ bool Snake::checkWallCollision(const Position& pos) const {
 }
 
 void Snake::reset(int startX, int startY) {
+    releaseBody();
     body.clear();
     body.push_back({startX, startY});
     body.push_back({startX - 1, startY});
     body.push_back({startX - 2, startY});
+    claimBody();
     direction = Direction::RIGHT;
     nextDirection = Direction::RIGHT;
     growthPending = 0;
+    lastBlocker = CellOwner::EMPTY;
+    prevTail = body.back();
+    advanced = false;
+}
+
+void Snake::restore(const std::vector<Position>& segments, Direction dir, Direction next, int growth) {
+    body.clear();
+    for (const auto& segment : segments) {
+        body.push_back(segment);
+    }
+    direction = dir;
+    nextDirection = next;
+    growthPending = growth;
+    lastBlocker = CellOwner::EMPTY;
+    prevTail = body.back();
+    advanced = false;
 }
 
-bool Snake::isOpposite(Direction a, Direction b) const {
+bool Snake::isOpposite(Direction a, Direction b) {
     return (a == Direction::UP && b == Direction::DOWN) ||
            (a == Direction::DOWN && b == Direction::UP) ||
            (a == Direction::LEFT && b == Direction::RIGHT) ||
            (a == Direction::RIGHT && b == Direction::LEFT);
 }
+
+void Snake::claimBody() {
+    if (!grid) return;
+    // 出生点可能压在墙上或道具上，claim 只占用空格子，不会覆盖它们
+    for (const auto& segment : body) {
+        grid->claim(segment.x, segment.y, owner);
+    }
+}
+
+void Snake::releaseBody() {
+    if (!grid) return;
+    for (const auto& segment : body) {
+        grid->release(segment.x, segment.y, owner);
+    }
+}
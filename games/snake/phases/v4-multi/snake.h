@@ -1,6 +1,6 @@
 #pragma once
-#include "raylib.h"
-#include <deque>
+#include "occupancy.h"
+#include "ring_buffer.h"
 #include <vector>
 
 // 方向枚举
@@ -14,27 +14,47 @@ struct Position {
     }
 };
 
+// 蛇身容器：连续的环形缓冲区，头部在 front
+using SnakeBody = RingBuffer<Position>;
+
 // ============================================================
 // Snake 类 - 管理蛇的状态和行为
 // ============================================================
+// 纯逻辑类，不依赖 raylib：输入由前端转换成 setNextDirection，
+// 绘制由 Game 负责。
 class Snake {
 private:
-    std::deque<Position> body;      // 蛇身，头部在 front
+    // 蛇身预分配上限：默认地图按面积一次分配好，大地图蛇身变长时环形缓冲区再扩容
+    static constexpr size_t INITIAL_BODY_CAPACITY = 4096;
+
+    SnakeBody body;                 // 蛇身，头部在 front（容量按网格面积预分配）
     Direction direction;            // 当前方向
     Direction nextDirection;        // 下一帧方向（防止一帧内多次转向）
     int growthPending;              // 待增长的长度
 
     int gridWidth, gridHeight;      // 边界
 
+    OccupancyGrid* grid;            // 共享占用网格（可为空，为空时退回线性扫描）
+    CellOwner owner;                // 在网格中的标记
+    CellOwner lastBlocker;          // 上一次 move() 失败时撞到的东西
+
+    // 渲染插值用：上一次 move() 之前的状态
+    Position prevTail;              // 移动前的蛇尾
+    bool advanced;                  // 上一次 move() 是否前进了一格
+
 public:
     Snake(int startX, int startY, int gridW, int gridH);
+    ~Snake();
+
+    Snake(const Snake&) = delete;
+    Snake& operator=(const Snake&) = delete;
+
+    // 绑定占用网格，并把当前蛇身写入网格
+    void bindGrid(OccupancyGrid* occupancy, CellOwner tag);
 
-    // 更新和绘制
-    void updateDirection();         // 根据输入更新方向（玩家1 - WASD）
-    void updateDirectionPlayer2();  // 根据输入更新方向（玩家2 - 方向键）
-    void setNextDirection(Direction dir); // 直接设置方向（用于AI或其他控制）
+    // 更新
+    void setNextDirection(Direction dir); // 设置下一步方向（玩家输入、AI 或回放）
     bool move();                    // 移动一步，返回是否存活
-    void draw(int gridSize) const;
 
     // 生长
     void grow(int amount);
@@ -45,13 +65,32 @@ public:
 
     // 获取状态
     Position getHead() const { return body.front(); }
-    const std::deque<Position>& getBody() const { return body; }
+    Position getNextHead() const;   // 按 nextDirection 前进一格后的位置（move 失败后即撞到的格子）
+    const SnakeBody& getBody() const { return body; }
     int getLength() const { return static_cast<int>(body.size()); }
     Direction getDirection() const { return direction; }
+    Direction getNextDirection() const { return nextDirection; }
+    int getGrowthPending() const { return growthPending; }
+    CellOwner getLastBlocker() const { return lastBlocker; }
+
+    // 第 i 节在上一个 tick 的位置（渲染插值用；没有前进时就是当前位置）
+    Position getPrevPosition(int i) const {
+        if (!advanced) return body[i];
+        return (i + 1 < getLength()) ? body[i + 1] : prevTail;
+    }
 
     // 重置
     void reset(int startX, int startY);
 
+    // 从快照恢复（不修改占用网格，网格由 SnakeSim 整体恢复）
+    void restore(const std::vector<Position>& segments, Direction dir, Direction next, int growth);
+
+    // 占用蛇身下所有空着的格子（出生时被道具挡住的格子，道具挪走后再补占）
+    void claimBody();
+
+    // 两个方向是否相反（不能直接掉头）
+    static bool isOpposite(Direction a, Direction b);
+
 private:
-    bool isOpposite(Direction a, Direction b) const;
+    void releaseBody();
 };
@@ -0,0 +1,290 @@
+#include "snake_env.h"
+#include "snake_sim.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// ============================================================
+// WorkerPool - 常驻线程池，按连续区间并行处理所有环境
+// ============================================================
+// 每次 parallelFor 把 [0, count) 切成 (线程数 + 1) 块，调用线程也参与计算，
+// 所有块完成后才返回，因此各环境严格锁步推进。
+class WorkerPool {
+private:
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable startCv;
+    std::condition_variable doneCv;
+
+    const std::function<void(int, int)>* job;
+    int jobCount;
+    uint64_t generation;    // 每发布一次任务加一，唤醒工作线程
+    int pending;            // 尚未完成的工作线程数
+    bool stopping;
+
+public:
+    explicit WorkerPool(int threadCount)
+        : job(nullptr), jobCount(0), generation(0), pending(0), stopping(false) {
+        for (int i = 0; i < threadCount; i++) {
+            threads.emplace_back(&WorkerPool::workerLoop, this, i);
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        startCv.notify_all();
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    int getChunkCount() const { return static_cast<int>(threads.size()) + 1; }
+
+    void parallelFor(int count, const std::function<void(int, int)>& fn) {
+        if (threads.empty() || count < getChunkCount()) {
+            fn(0, count);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobCount = count;
+            pending = static_cast<int>(threads.size());
+            generation++;
+        }
+        startCv.notify_all();
+
+        // 最后一块由调用线程自己处理
+        int chunk = getChunkCount() - 1;
+        fn(chunkBegin(chunk, count), chunkBegin(chunk + 1, count));
+
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCv.wait(lock, [this] { return pending == 0; });
+        job = nullptr;
+    }
+
+private:
+    int chunkBegin(int chunk, int count) const {
+        return static_cast<int>(static_cast<int64_t>(count) * chunk / getChunkCount());
+    }
+
+    void workerLoop(int index) {
+        uint64_t seenGeneration = 0;
+        for (;;) {
+            const std::function<void(int, int)>* currentJob;
+            int count;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                startCv.wait(lock, [&] { return stopping || generation != seenGeneration; });
+                if (stopping) return;
+                seenGeneration = generation;
+                currentJob = job;
+                count = jobCount;
+            }
+
+            (*currentJob)(chunkBegin(index, count), chunkBegin(index + 1, count));
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending--;
+            }
+            doneCv.notify_one();
+        }
+    }
+};
+
+constexpr float COLLISION_PENALTY = 10.0f;  // 每失去一条生命的惩罚
+
+} // namespace
+
+// ============================================================
+// SnakeEnv - N 局游戏，对外的结果按结构体数组 (SoA) 存放
+// ============================================================
+// 棋盘状态（占用网格、蛇身、随机数状态）仍是每局一个 SnakeSim，没有拆成跨环境的
+// 按字段数组：环境必须和窗口版、回放用同一份模拟代码，同样的种子和输入才能得到
+// 同样的对局；拆开等于再写一套规则。状态归各自的 SnakeSim 所有，占用网格的块、
+// 蛇身环形缓冲区、障碍物的块都是各自单独的堆分配，没有按环境做 SoA 或内存池布局。
+// 线程按连续区间处理环境，一局只被一个线程写。训练脚本读写的观测、奖励、
+// 结束标志和分数是 SoA。
+struct SnakeEnv {
+    int numEnvs;
+    int numPlayers;
+    int gridWidth, gridHeight;
+    size_t planeSize;       // 每个平面的字节数
+    size_t obsStride;       // 每局观测的字节数
+
+    std::vector<std::unique_ptr<SnakeSim>> sims;     // 每局的棋盘状态（见上面的说明）
+    std::vector<SimRandom> seedStreams;     // 每局下一次重开用的种子序列
+
+    // SoA 结果缓冲区
+    std::vector<uint8_t> observations;      // [env][plane][y][x]
+    std::vector<float> rewards;             // [env][player]
+    std::vector<uint8_t> dones;             // [env]
+    std::vector<int32_t> scores;            // [env][player]
+
+    std::unique_ptr<WorkerPool> pool;
+
+    void resetRange(int begin, int end, uint64_t seed);
+    void stepRange(int begin, int end, const uint8_t* actions);
+    void writeObservation(int index);
+};
+
+void SnakeEnv::resetRange(int begin, int end, uint64_t seed) {
+    for (int i = begin; i < end; i++) {
+        // 种子只取决于 (seed, 环境下标)，与线程数无关，结果可复现
+        seedStreams[i].setSeed(seed ^ (0x9E3779B97F4A7C15ULL * (static_cast<uint64_t>(i) + 1)));
+        sims[i]->reset(seedStreams[i].next());
+        dones[i] = 0;
+        for (int p = 0; p < numPlayers; p++) {
+            rewards[i * numPlayers + p] = 0.0f;
+            scores[i * numPlayers + p] = 0;
+        }
+        writeObservation(i);
+    }
+}
+
+void SnakeEnv::stepRange(int begin, int end, const uint8_t* actions) {
+    for (int i = begin; i < end; i++) {
+        SnakeSim& sim = *sims[i];
+
+        TickInput input;
+        if (actions) {
+            for (int p = 0; p < numPlayers; p++) {
+                uint8_t a = actions[i * numPlayers + p];
+                input.turns[p] = static_cast<TurnCommand>(a <= 4 ? a : 0);
+            }
+        }
+        sim.step(input);
+
+        // 奖励 = 分数增量 - 失去生命的惩罚
+        for (int p = 0; p < numPlayers; p++) {
+            int32_t score = sim.getScore(p);
+            rewards[i * numPlayers + p] = static_cast<float>(score - scores[i * numPlayers + p]);
+            scores[i * numPlayers + p] = score;
+        }
+        for (const SimEvent& e : sim.getEvents()) {
+            if (e.type == SimEventType::COLLISION) {
+                rewards[i * numPlayers + e.player] -= COLLISION_PENALTY;
+            }
+        }
+
+        dones[i] = sim.isGameOver() ? 1 : 0;
+        if (dones[i]) {
+            sim.reset(seedStreams[i].next());
+            for (int p = 0; p < numPlayers; p++) {
+                scores[i * numPlayers + p] = 0;
+            }
+        }
+
+        writeObservation(i);
+    }
+}
+
+void SnakeEnv::writeObservation(int index) {
+    const SnakeSim& sim = *sims[index];
+    const OccupancyGrid& grid = sim.getGrid();
+    uint8_t* obs = observations.data() + obsStride * index;
+    std::memset(obs, 0, obsStride);
+
+    uint8_t* p1Body = obs + planeSize * SNAKE_PLANE_P1_BODY;
+    uint8_t* p2Body = obs + planeSize * SNAKE_PLANE_P2_BODY;
+    uint8_t* walls = obs + planeSize * SNAKE_PLANE_WALL;
+    uint8_t* items = obs + planeSize * SNAKE_PLANE_ITEM;
+
+    // 占用网格已经包含了所有信息，只遍历非空格子展开到各个平面
+    uint8_t* planes[5] = {nullptr, p1Body, p2Body, walls, items};   // 下标为 CellOwner
+    grid.forEachOccupied([&](int x, int y, CellOwner owner) {
+        planes[static_cast<uint8_t>(owner)][static_cast<size_t>(y) * gridWidth + x] = 1;
+    });
+
+    for (int p = 0; p < numPlayers; p++) {
+        const Snake* snake = sim.getSnake(p);
+        if (!snake) continue;
+        Position head = snake->getHead();
+        if (grid.inBounds(head.x, head.y)) {
+            int plane = (p == 0) ? SNAKE_PLANE_P1_HEAD : SNAKE_PLANE_P2_HEAD;
+            obs[planeSize * plane + static_cast<size_t>(head.y) * gridWidth + head.x] = 1;
+        }
+    }
+}
+
+// ============================================================
+// C 接口
+// ============================================================
+extern "C" {
+
+SnakeEnv* snake_env_create(int numEnvs, int numThreads, uint64_t seed, int versus) {
+    if (numEnvs <= 0) return nullptr;
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    // 网格尺寸沿用 SimConfig 默认值，与 Game::DEFAULT_GRID_WIDTH/DEFAULT_GRID_HEIGHT (40x30) 一致
+    SimConfig config;
+    config.versus = (versus != 0);
+
+    auto* env = new SnakeEnv();
+    env->numEnvs = numEnvs;
+    env->numPlayers = config.versus ? 2 : 1;
+    env->gridWidth = config.gridWidth;
+    env->gridHeight = config.gridHeight;
+    env->planeSize = static_cast<size_t>(config.gridWidth) * config.gridHeight;
+    env->obsStride = env->planeSize * SNAKE_PLANE_COUNT;
+
+    env->sims.reserve(numEnvs);
+    for (int i = 0; i < numEnvs; i++) {
+        env->sims.push_back(std::make_unique<SnakeSim>(config));
+    }
+    env->seedStreams.resize(numEnvs);
+    env->observations.resize(env->obsStride * numEnvs);
+    env->rewards.resize(static_cast<size_t>(numEnvs) * env->numPlayers);
+    env->dones.resize(numEnvs);
+    env->scores.resize(static_cast<size_t>(numEnvs) * env->numPlayers);
+
+    // 调用线程也参与计算，所以只需再创建 numThreads - 1 个工作线程
+    env->pool = std::make_unique<WorkerPool>(numThreads - 1);
+
+    snake_env_reset(env, seed);
+    return env;
+}
+
+void snake_env_destroy(SnakeEnv* env) {
+    delete env;
+}
+
+void snake_env_reset(SnakeEnv* env, uint64_t seed) {
+    if (!env) return;
+    env->pool->parallelFor(env->numEnvs, [env, seed](int begin, int end) {
+        env->resetRange(begin, end, seed);
+    });
+}
+
+void snake_env_step(SnakeEnv* env, const uint8_t* actions) {
+    if (!env) return;
+    env->pool->parallelFor(env->numEnvs, [env, actions](int begin, int end) {
+        env->stepRange(begin, end, actions);
+    });
+}
+
+int snake_env_num_envs(const SnakeEnv* env) { return env ? env->numEnvs : 0; }
+int snake_env_num_players(const SnakeEnv* env) { return env ? env->numPlayers : 0; }
+int snake_env_grid_width(const SnakeEnv* env) { return env ? env->gridWidth : 0; }
+int snake_env_grid_height(const SnakeEnv* env) { return env ? env->gridHeight : 0; }
+
+const uint8_t* snake_env_observations(const SnakeEnv* env) { return env ? env->observations.data() : nullptr; }
+const float* snake_env_rewards(const SnakeEnv* env) { return env ? env->rewards.data() : nullptr; }
+const uint8_t* snake_env_dones(const SnakeEnv* env) { return env ? env->dones.data() : nullptr; }
+const int32_t* snake_env_scores(const SnakeEnv* env) { return env ? env->scores.data() : nullptr; }
+
+} // extern "C"
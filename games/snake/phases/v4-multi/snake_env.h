@@ -0,0 +1,69 @@
+/* ============================================================
+ * snake_env.h - 批量贪吃蛇环境的 C 接口（共享库 snake-env）
+ * ============================================================
+ * 同时持有 N 局独立的 SnakeSim，用线程池按锁步方式一起推进，
+ * 观测以 uint8 平面的形式输出，方便 Python (ctypes/numpy) 等直接读取。
+ *
+ * 观测布局：[env][plane][y][x]，每个格子一个字节（0 或 1）
+ * 动作布局：[env][player]，取值同 TurnCommand（0=不转向 1=上 2=下 3=左 4=右）
+ * 每局结束时 done=1，并自动用下一个种子重开（观测已是新局的第一帧）。
+ */
+#ifndef SNAKE_ENV_H
+#define SNAKE_ENV_H
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #if defined(SNAKE_ENV_BUILD)
+        #define SNAKE_ENV_API __declspec(dllexport)
+    #else
+        #define SNAKE_ENV_API __declspec(dllimport)
+    #endif
+#else
+    #define SNAKE_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 观测平面 */
+enum {
+    SNAKE_PLANE_P1_BODY = 0,    /* 玩家1蛇身（含蛇头） */
+    SNAKE_PLANE_P1_HEAD,        /* 玩家1蛇头 */
+    SNAKE_PLANE_P2_BODY,        /* 玩家2蛇身（含蛇头） */
+    SNAKE_PLANE_P2_HEAD,        /* 玩家2蛇头 */
+    SNAKE_PLANE_WALL,           /* 障碍物 */
+    SNAKE_PLANE_ITEM,           /* 道具 */
+    SNAKE_PLANE_COUNT
+};
+
+typedef struct SnakeEnv SnakeEnv;
+
+/* 创建 numEnvs 局游戏；numThreads <= 0 时使用全部硬件线程 */
+SNAKE_ENV_API SnakeEnv* snake_env_create(int numEnvs, int numThreads, uint64_t seed, int versus);
+SNAKE_ENV_API void snake_env_destroy(SnakeEnv* env);
+
+/* 用新种子重开所有对局 */
+SNAKE_ENV_API void snake_env_reset(SnakeEnv* env, uint64_t seed);
+
+/* 所有对局推进一个 tick；actions 长度为 numEnvs * numPlayers，可为 NULL（全部不转向） */
+SNAKE_ENV_API void snake_env_step(SnakeEnv* env, const uint8_t* actions);
+
+/* 尺寸信息 */
+SNAKE_ENV_API int snake_env_num_envs(const SnakeEnv* env);
+SNAKE_ENV_API int snake_env_num_players(const SnakeEnv* env);
+SNAKE_ENV_API int snake_env_grid_width(const SnakeEnv* env);
+SNAKE_ENV_API int snake_env_grid_height(const SnakeEnv* env);
+
+/* 结果缓冲区（由环境持有，下一次 step/reset 前有效） */
+SNAKE_ENV_API const uint8_t* snake_env_observations(const SnakeEnv* env);  /* [env][plane][y][x] */
+SNAKE_ENV_API const float* snake_env_rewards(const SnakeEnv* env);         /* [env][player] */
+SNAKE_ENV_API const uint8_t* snake_env_dones(const SnakeEnv* env);         /* [env] */
+SNAKE_ENV_API const int32_t* snake_env_scores(const SnakeEnv* env);        /* [env][player]，当前局分数 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SNAKE_ENV_H */
@@ -0,0 +1,455 @@
+#include "snake_sim.h"
+
+SnakeSim::SnakeSim(const SimConfig& cfg)
+    : config(cfg),
+      grid(cfg.gridWidth, cfg.gridHeight),
+      obstacles(cfg.gridWidth, cfg.gridHeight),
+      items(cfg.gridWidth, cfg.gridHeight),
+      rng(cfg.seed) {
+    if (config.itemCount < 0) config.itemCount = 0;
+    if (config.itemCount > ItemPool::MAX_ITEMS) config.itemCount = ItemPool::MAX_ITEMS;
+
+    obstacles.bindGrid(&grid);
+    events.reserve(16);
+    reset(cfg.seed);
+}
+
+void SnakeSim::reset(uint64_t seed) {
+    // 先销毁旧对象再清空网格，避免旧蛇析构时误释放新蛇的格子
+    for (auto& s : snakes) {
+        s.reset();
+    }
+    items.clear();
+    obstacles.clear();
+    grid.clear();
+
+    config.seed = seed;
+    rng.setSeed(seed);
+
+    for (int p = 0; p < getPlayerCount(); p++) {
+        Position spawn = getSpawnPoint(p);
+        snakes[p] = std::make_unique<Snake>(spawn.x, spawn.y, config.gridWidth, config.gridHeight);
+        snakes[p]->bindGrid(&grid, p == 0 ? CellOwner::PLAYER1 : CellOwner::PLAYER2);
+    }
+
+    // 加载关卡墙壁
+    for (const auto& wall : config.walls) {
+        obstacles.addObstacle(wall.x, wall.y);
+    }
+
+    if (obstacles.getCount() == 0) {
+        obstacles.generate(config.randomObstacles, TileType::WALL, *snakes[0], rng);
+    }
+    obstacles.generate(config.randomCrates, TileType::CRATE, *snakes[0], rng);
+
+    for (int p = 0; p < MAX_PLAYERS; p++) {
+        scores[p] = 0;
+        lives[p] = MAX_LIVES;
+        lifeMilestones[p] = 0;
+    }
+    baseMoveInterval = BASE_MOVE_INTERVAL;
+    speedEffect = SpeedEffect();
+    gameOver = false;
+    tick = 0;
+    events.clear();
+
+    for (int i = 0; i < config.itemCount; i++) {
+        spawnItem();
+    }
+}
+
+void SnakeSim::step(const TickInput& input) {
+    events.clear();
+    if (gameOver) return;
+
+    float dt = getMoveInterval();
+    tick++;
+
+    // 速度效果计时
+    if (speedEffect.active) {
+        speedEffect.remaining -= dt;
+        if (speedEffect.remaining <= 0) {
+            speedEffect.active = false;
+            speedEffect.multiplier = 1.0f;
+        }
+    }
+
+    // 限时道具：过期的换一个新的。倒序遍历，移除时换过来的末尾道具已经更新过，
+    // 新生成的追加在末尾，这个 tick 不再计时
+    for (int i = items.size() - 1; i >= 0; i--) {
+        Item& item = items.at(i);
+        item.update(dt);
+        if (item.isExpired()) {
+            removeItem(i);
+            spawnItem();
+        }
+    }
+
+    // 应用输入
+    for (int p = 0; p < getPlayerCount(); p++) {
+        switch (input.turns[p]) {
+            case TurnCommand::NONE:  break;
+            case TurnCommand::UP:    snakes[p]->setNextDirection(Direction::UP); break;
+            case TurnCommand::DOWN:  snakes[p]->setNextDirection(Direction::DOWN); break;
+            case TurnCommand::LEFT:  snakes[p]->setNextDirection(Direction::LEFT); break;
+            case TurnCommand::RIGHT: snakes[p]->setNextDirection(Direction::RIGHT); break;
+        }
+    }
+
+    moveSnake(0);
+    if (gameOver) return;
+
+    if (config.versus) {
+        moveSnake(1);
+        if (gameOver) return;
+
+        // 检查对战结束
+        if (scores[0] >= config.targetScore || scores[1] >= config.targetScore) {
+            gameOver = true;
+            emit(SimEventType::GAME_OVER, -1, 0, 0);
+        }
+    }
+}
+
+void SnakeSim::moveSnake(int player) {
+    Snake& snake = *snakes[player];
+
+    bool alive = snake.move();
+
+    if (!alive && snake.getLastBlocker() == CellOwner::WALL) {
+        // 撞到箱子不扣命：箱子掉一点耐久，没碎时蛇原地停一拍，碎了就照常前进
+        Position hit = snake.getNextHead();
+        int remaining = obstacles.damage(hit.x, hit.y);
+        if (remaining > 0) {
+            emit(SimEventType::TILE_DAMAGED, player, hit.x, hit.y);
+            return;
+        }
+        if (remaining == 0) {
+            emit(SimEventType::TILE_DESTROYED, player, hit.x, hit.y);
+            alive = snake.move();
+        }
+    }
+
+    Position head = snake.getHead();
+
+    if (!alive) {
+        // 越界在网格里也记作 WALL，这里区分出真正的障碍物
+        Position hit = snake.getNextHead();
+        CellOwner blocker = snake.getLastBlocker();
+        if (blocker == CellOwner::WALL && !obstacles.checkCollision(hit.x, hit.y)) {
+            blocker = CellOwner::EMPTY;
+        }
+        emit(SimEventType::COLLISION, player, head.x, head.y, ItemType::NORMAL, blocker);
+
+        if (lives[player] > 0) {
+            lives[player]--;
+        }
+        if (lives[player] <= 0) {
+            lives[player] = 0;
+            gameOver = true;
+            emit(SimEventType::GAME_OVER, player, head.x, head.y);
+            return;
+        }
+
+        respawn(player);
+        return;
+    }
+
+    int itemIndex = items.findAt(head.x, head.y);
+    if (itemIndex >= 0) {
+        Item item = items.at(itemIndex);
+        eatItem(player, item);
+        emit(SimEventType::ITEM_EATEN, player, head.x, head.y, item.getType());
+
+        removeItem(itemIndex);
+        spawnItem();
+        checkExtraLife(player);
+    }
+
+    emit(SimEventType::MOVED, player, head.x, head.y);
+}
+
+void SnakeSim::respawn(int player) {
+    Position spawn = getSpawnPoint(player);
+    Snake& snake = *snakes[player];
+    snake.reset(spawn.x, spawn.y);
+
+    // 压在新蛇身下的道具挪到别处：先移除、让蛇补占格子，再在空格子里补生成
+    int relocated = 0;
+    for (const auto& segment : snake.getBody()) {
+        int index = items.findAt(segment.x, segment.y);
+        if (index >= 0) {
+            removeItem(index);
+            relocated++;
+        }
+    }
+    if (relocated > 0) {
+        snake.claimBody();
+        for (int i = 0; i < relocated; i++) {
+            spawnItem();
+        }
+    }
+}
+
+Position SnakeSim::getSpawnPoint(int player) const {
+    if (config.spawnPoints.size() > static_cast<size_t>(player)) {
+        return config.spawnPoints[player];
+    }
+    if (player == 0) {
+        return {config.gridWidth / 2, config.gridHeight / 2};
+    }
+    return {config.gridWidth / 3, config.gridHeight / 3};
+}
+
+void SnakeSim::spawnItem() {
+    // 直接从空闲格子集合中均匀取样：O(1)，只要还有空位就一定成功
+    int freeCount = grid.getFreeCount();
+    if (freeCount == 0 || items.full()) {
+        return;
+    }
+
+    int x, y;
+    grid.getFreeCell(rng.range(0, freeCount - 1), x, y);
+    ItemType type = rollItemType(rng);
+
+    // 空闲格子上本不该有道具；万一池子不收，就不标记网格，保持两边一致
+    if (items.spawn(type, x, y) >= 0) {
+        grid.set(x, y, CellOwner::ITEM);
+    }
+}
+
+void SnakeSim::removeItem(int index) {
+    // 道具（过期或被吃掉）让出格子；被吃掉时格子已是蛇头，release 不会误清
+    const Item& item = items.at(index);
+    grid.release(item.getX(), item.getY(), CellOwner::ITEM);
+    items.remove(index);
+}
+
+void SnakeSim::eatItem(int player, const Item& item) {
+    const ItemTraits& traits = item.getTraits();
+    snakes[player]->grow(traits.growth);
+    addScore(player, traits.score);
+    if (traits.effectDuration > 0) {
+        applySpeedEffect(traits.speedMultiplier, traits.effectDuration);
+    }
+}
+
+void SnakeSim::addScore(int player, int points) {
+    scores[player] += points;
+    if (baseMoveInterval > 0.05f) {
+        baseMoveInterval *= 0.98f;
+    }
+}
+
+void SnakeSim::applySpeedEffect(float multiplier, float duration) {
+    speedEffect.multiplier = multiplier;
+    speedEffect.remaining = duration;
+    speedEffect.active = true;
+}
+
+void SnakeSim::checkExtraLife(int player) {
+    int currentMilestone = scores[player] / LIVES_PER_EXTRA;
+
+    if (currentMilestone > lifeMilestones[player] && lives[player] < MAX_LIVES) {
+        lives[player]++;
+        lifeMilestones[player] = currentMilestone;
+        Position head = snakes[player]->getHead();
+        emit(SimEventType::EXTRA_LIFE, player, head.x, head.y);
+    }
+}
+
+// ============================================================
+// 状态快照
+// ============================================================
+void SnakeSim::saveState(std::vector<uint8_t>& out) const {
+    ByteWriter w(out);
+    w.writeVarint(tick);
+    w.writeU64(rng.getState());
+    w.writeU8(gameOver ? 1 : 0);
+    w.writeF32(baseMoveInterval);
+    w.writeF32(speedEffect.multiplier);
+    w.writeF32(speedEffect.remaining);
+    w.writeU8(speedEffect.active ? 1 : 0);
+
+    w.writeU8(static_cast<uint8_t>(getPlayerCount()));
+    for (int p = 0; p < getPlayerCount(); p++) {
+        const Snake& snake = *snakes[p];
+        w.writeSVarint(scores[p]);
+        w.writeSVarint(lives[p]);
+        w.writeSVarint(lifeMilestones[p]);
+        w.writeU8(static_cast<uint8_t>(snake.getDirection()));
+        w.writeU8(static_cast<uint8_t>(snake.getNextDirection()));
+        w.writeVarint(static_cast<uint64_t>(snake.getGrowthPending()));
+        w.writeVarint(static_cast<uint64_t>(snake.getLength()));
+        for (const auto& segment : snake.getBody()) {
+            w.writeSVarint(segment.x);
+            w.writeSVarint(segment.y);
+        }
+    }
+
+    // 箱子的耐久会变，障碍物每格存位置和类型/耐久字节
+    w.writeVarint(static_cast<uint64_t>(obstacles.getCount()));
+    obstacles.forEach([&](int x, int y, TileType type, int hitPoints) {
+        w.writeVarint(static_cast<uint64_t>(x));
+        w.writeVarint(static_cast<uint64_t>(y));
+        w.writeU8(static_cast<uint8_t>(static_cast<uint8_t>(type) | (hitPoints << 4)));
+    });
+
+    // 道具按池内顺序保存，恢复后迭代顺序不变
+    w.writeU8(static_cast<uint8_t>(items.size()));
+    for (const Item& item : items) {
+        w.writeU8(static_cast<uint8_t>(item.getType()));
+        w.writeVarint(static_cast<uint64_t>(item.getX()));
+        w.writeVarint(static_cast<uint64_t>(item.getY()));
+        w.writeF32(item.getRemainingLife());
+    }
+
+    grid.saveState(w);
+}
+
+bool SnakeSim::loadState(const uint8_t* data, size_t size) {
+    ByteReader r(data, size);
+
+    // 先全部解析到临时变量，格式错误时不改动当前状态
+    struct SnakeState {
+        int score, lives, milestone;
+        Direction direction, nextDirection;
+        int growth;
+        std::vector<Position> body;
+    };
+    SnakeState snakeStates[MAX_PLAYERS];
+
+    uint64_t savedTick = r.readVarint();
+    uint64_t rngState = r.readU64();
+    bool savedGameOver = r.readU8() != 0;
+    float savedInterval = r.readF32();
+    SpeedEffect savedEffect;
+    savedEffect.multiplier = r.readF32();
+    savedEffect.remaining = r.readF32();
+    savedEffect.active = r.readU8() != 0;
+
+    if (r.readU8() != getPlayerCount()) {
+        return false;
+    }
+    const uint64_t maxLength = static_cast<uint64_t>(config.gridWidth) * config.gridHeight + 3;
+    for (int p = 0; p < getPlayerCount(); p++) {
+        SnakeState& st = snakeStates[p];
+        st.score = static_cast<int>(r.readSVarint());
+        st.lives = static_cast<int>(r.readSVarint());
+        st.milestone = static_cast<int>(r.readSVarint());
+        st.direction = static_cast<Direction>(r.readU8() & 3);
+        st.nextDirection = static_cast<Direction>(r.readU8() & 3);
+        st.growth = static_cast<int>(r.readVarint());
+        uint64_t length = r.readVarint();
+        if (!r.ok() || length == 0 || length > maxLength) {
+            return false;
+        }
+        st.body.resize(static_cast<size_t>(length));
+        for (auto& segment : st.body) {
+            segment.x = static_cast<int>(r.readSVarint());
+            segment.y = static_cast<int>(r.readSVarint());
+        }
+    }
+
+    uint64_t obstacleCount = r.readVarint();
+    if (!r.ok() || obstacleCount > static_cast<uint64_t>(config.gridWidth) * config.gridHeight) {
+        return false;
+    }
+    struct TileState {
+        int x, y;
+        TileType type;
+        int hitPoints;
+    };
+    std::vector<TileState> obstacleTiles(static_cast<size_t>(obstacleCount));
+    for (auto& tile : obstacleTiles) {
+        tile.x = static_cast<int>(r.readVarint());
+        tile.y = static_cast<int>(r.readVarint());
+        uint8_t packed = r.readU8();
+        tile.type = static_cast<TileType>(packed & 0x0F);
+        tile.hitPoints = packed >> 4;
+        if (tile.type != TileType::WALL && tile.type != TileType::CRATE) {
+            return false;
+        }
+    }
+
+    int itemCount = r.readU8();
+    if (itemCount > ItemPool::MAX_ITEMS) {
+        return false;
+    }
+    struct ItemState {
+        ItemType type;
+        int x, y;
+        float life;
+    };
+    ItemState itemStates[ItemPool::MAX_ITEMS];
+    for (int i = 0; i < itemCount; i++) {
+        ItemState& st = itemStates[i];
+        uint8_t type = r.readU8();
+        st.type = static_cast<ItemType>(type);
+        st.x = static_cast<int>(r.readVarint());
+        st.y = static_cast<int>(r.readVarint());
+        st.life = r.readF32();
+        if (type >= ITEM_TYPE_COUNT || !grid.inBounds(st.x, st.y)) {
+            return false;
+        }
+    }
+    if (!r.ok()) {
+        return false;
+    }
+
+    // 网格放在最后，先确认它能完整读出再开始修改
+    OccupancyGrid savedGrid(config.gridWidth, config.gridHeight);
+    if (!savedGrid.loadState(r)) {
+        return false;
+    }
+
+    // 应用：对象只恢复自身数据，占用网格最后整体覆盖
+    tick = savedTick;
+    rng.setState(rngState);
+    gameOver = savedGameOver;
+    baseMoveInterval = savedInterval;
+    speedEffect = savedEffect;
+
+    for (int p = 0; p < getPlayerCount(); p++) {
+        const SnakeState& st = snakeStates[p];
+        scores[p] = st.score;
+        lives[p] = st.lives;
+        lifeMilestones[p] = st.milestone;
+        snakes[p]->restore(st.body, st.direction, st.nextDirection, st.growth);
+    }
+
+    obstacles.clear();
+    for (const auto& tile : obstacleTiles) {
+        obstacles.addObstacle(tile.x, tile.y, tile.type, tile.hitPoints);
+    }
+
+    items.clear();
+    for (int i = 0; i < itemCount; i++) {
+        const ItemState& st = itemStates[i];
+        int index = items.spawn(st.type, st.x, st.y);
+        if (index >= 0) {
+            items.at(index).setRemainingLife(st.life);
+        }
+    }
+
+    grid = std::move(savedGrid);
+    events.clear();
+    return true;
+}
+
+uint64_t SnakeSim::getStateHash() const {
+    std::vector<uint8_t> state;
+    saveState(state);
+    return hashBytes(state.data(), state.size());
+}
+
+void SnakeSim::emit(SimEventType type, int player, int x, int y, ItemType item, CellOwner blocker) {
+    SimEvent e;
+    e.type = type;
+    e.player = player;
+    e.x = x;
+    e.y = y;
+    e.item = item;
+    e.blocker = blocker;
+    events.push_back(e);
+}
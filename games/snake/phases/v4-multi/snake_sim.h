@@ -0,0 +1,154 @@
+#pragma once
+#include "snake.h"
+#include "item.h"
+#include "obstacle.h"
+#include "occupancy.h"
+#include "sim_random.h"
+#include "byte_stream.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// ============================================================
+// SnakeSim - 无渲染、可复现的贪吃蛇模拟核心
+// ============================================================
+// 不调用任何 raylib 函数：输入是每个 tick 的命令，随机数来自种子。
+// 同样的配置 + 种子 + 输入序列，一定得到同样的对局。
+// 窗口版 Game 只是它的前端：读键盘 -> TickInput，读事件 -> 音效/粒子。
+
+// 速度效果结构
+struct SpeedEffect {
+    float multiplier;   // 速度倍数
+    float remaining;    // 剩余时间
+    bool active;
+
+    SpeedEffect() : multiplier(1.0f), remaining(0.0f), active(false) {}
+};
+
+// 每个 tick 的转向命令
+enum class TurnCommand : uint8_t {
+    NONE = 0,   // 保持当前方向
+    UP,
+    DOWN,
+    LEFT,
+    RIGHT
+};
+
+// 一个 tick 的全部输入
+struct TickInput {
+    TurnCommand turns[2] = {TurnCommand::NONE, TurnCommand::NONE};  // 下标为玩家（0 = P1）
+};
+
+// 模拟事件类型（前端据此播放音效、粒子和提示）
+enum class SimEventType : uint8_t {
+    MOVED,          // 正常前进一格，(x, y) 为新蛇头
+    ITEM_EATEN,     // 吃到道具，(x, y) 为道具位置
+    COLLISION,      // 撞击并失去一条生命，(x, y) 为撞击前的蛇头
+    EXTRA_LIFE,     // 获得奖励生命
+    TILE_DAMAGED,   // 撞到箱子，箱子掉一点耐久、蛇原地停一拍，(x, y) 为箱子位置
+    TILE_DESTROYED, // 箱子被撞碎，蛇照常前进，(x, y) 为箱子位置
+    GAME_OVER       // 对局结束，player 为 -1 表示有人达到目标分数
+};
+
+struct SimEvent {
+    SimEventType type;
+    int player;
+    int x, y;
+    ItemType item;      // ITEM_EATEN 时有效
+    CellOwner blocker;  // COLLISION 时有效：WALL=障碍物，PLAYER1/2=蛇身，EMPTY=地图边界
+};
+
+// 对局配置
+struct SimConfig {
+    int gridWidth = 40;
+    int gridHeight = 30;
+    bool versus = false;                // 是否双人对战
+    int targetScore = 100;              // 对战目标分数
+    int randomObstacles = 5;            // 关卡没有墙壁时随机生成的障碍物数量
+    int randomCrates = 0;               // 随机生成的可破坏箱子数量（有没有关卡墙壁都生成）
+    int itemCount = 1;                  // 同时存在的道具数量（道具冲刺模式更多，最多 ItemPool::MAX_ITEMS）
+    std::vector<Position> walls;        // 关卡墙壁
+    std::vector<Position> spawnPoints;  // 出生点（下标为玩家）
+    uint64_t seed = 1;
+};
+
+class SnakeSim {
+public:
+    static constexpr int MAX_PLAYERS = 2;
+    static constexpr int MAX_LIVES = 3;
+    static constexpr int LIVES_PER_EXTRA = 500;     // 每500分奖励生命
+    static constexpr float BASE_MOVE_INTERVAL = 0.15f;
+
+private:
+    SimConfig config;
+
+    // 占用网格需先于蛇和障碍物构造、后于它们析构
+    OccupancyGrid grid;
+    std::unique_ptr<Snake> snakes[MAX_PLAYERS];
+    ObstacleManager obstacles;
+    ItemPool items;
+    SimRandom rng;
+
+    int scores[MAX_PLAYERS];
+    int lives[MAX_PLAYERS];
+    int lifeMilestones[MAX_PLAYERS];    // 已奖励过生命的分数里程碑
+    float baseMoveInterval;
+    SpeedEffect speedEffect;
+    bool gameOver;
+    uint64_t tick;
+
+    std::vector<SimEvent> events;       // 最近一次 step() 产生的事件（复用容量，不反复分配）
+
+public:
+    explicit SnakeSim(const SimConfig& config);
+
+    SnakeSim(const SnakeSim&) = delete;
+    SnakeSim& operator=(const SnakeSim&) = delete;
+
+    // 用新种子重新开始一局（配置不变）
+    void reset(uint64_t seed);
+
+    // 推进一个 tick：应用输入，所有蛇移动一格
+    // 一个 tick 代表 getMoveInterval() 秒的游戏时间
+    void step(const TickInput& input);
+
+    // 状态查询
+    int getPlayerCount() const { return config.versus ? 2 : 1; }
+    const Snake* getSnake(int player) const { return snakes[player].get(); }
+    const ItemPool& getItems() const { return items; }
+    const ObstacleManager& getObstacles() const { return obstacles; }
+    const OccupancyGrid& getGrid() const { return grid; }
+    const SimConfig& getConfig() const { return config; }
+
+    int getScore(int player) const { return scores[player]; }
+    int getLives(int player) const { return lives[player]; }
+    int getTargetScore() const { return config.targetScore; }
+    bool isGameOver() const { return gameOver; }
+    uint64_t getTick() const { return tick; }
+
+    float getMoveInterval() const { return baseMoveInterval * speedEffect.multiplier; }
+    const SpeedEffect& getSpeedEffect() const { return speedEffect; }
+
+    const std::vector<SimEvent>& getEvents() const { return events; }
+
+    // 状态快照（回放关键帧）：包含恢复一局所需的全部可变状态，配置除外。
+    // loadState 要求本对象的配置（网格尺寸、玩家数）与保存时一致，失败时状态不变。
+    void saveState(std::vector<uint8_t>& out) const;
+    bool loadState(const uint8_t* data, size_t size);
+    uint64_t getStateHash() const;      // 快照的哈希，用于校验回放结果
+
+    // 道具效果
+    void addScore(int player, int points);
+    void applySpeedEffect(float multiplier, float duration);
+
+private:
+    void spawnItem();
+    void removeItem(int index);
+    void eatItem(int player, const Item& item);
+    void moveSnake(int player);
+    void respawn(int player);
+    void checkExtraLife(int player);
+    Position getSpawnPoint(int player) const;
+    void emit(SimEventType type, int player, int x, int y,
+              ItemType item = ItemType::NORMAL, CellOwner blocker = CellOwner::EMPTY);
+};
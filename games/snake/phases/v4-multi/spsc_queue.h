@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// ============================================================
+// SpscQueue - 单生产者单消费者无锁队列
+// ============================================================
+// 游戏线程 push，音频线程 pop，两边都不加锁也不分配内存：
+//   - 容量固定为 2 的幂，下标只增不减，取模用位与
+//   - 生产者只写 tail，消费者只写 head；release/acquire 保证读到完整的元素
+//   - 队列满时 push 返回 false，由调用方决定丢弃
+// head 和 tail 放在不同的缓存行里，避免两个线程互相抢同一行。
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity 必须是 2 的幂");
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    T slots[Capacity];
+    alignas(64) std::atomic<size_t> head;   // 下一个要读的位置（消费者）
+    alignas(64) std::atomic<size_t> tail;   // 下一个要写的位置（生产者）
+
+public:
+    SpscQueue() : slots(), head(0), tail(0) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // 仅生产者线程调用
+    bool push(const T& item) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+        slots[t & MASK] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 仅消费者线程调用
+    bool pop(T& item) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = slots[h & MASK];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似值，只用于统计
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+};
@@ -0,0 +1,478 @@
+#include "synth.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr float INV_SAMPLE_RATE = 1.0f / Synth::SAMPLE_RATE;
+
+// 正弦查表，多一项方便线性插值时不用回绕
+constexpr int SINE_TABLE_SIZE = 1024;
+
+struct SineTable {
+    float values[SINE_TABLE_SIZE + 1];
+
+    SineTable() {
+        for (int i = 0; i <= SINE_TABLE_SIZE; i++) {
+            values[i] = sinf(2.0f * PI * i / SINE_TABLE_SIZE);
+        }
+    }
+};
+
+const SineTable SINE_TABLE;
+
+// ---------- 背景音乐 ----------
+// 120 BPM，每步一个十六分音符
+constexpr int BPM = 120;
+constexpr int SAMPLES_PER_STEP = Synth::SAMPLE_RATE * 60 / (BPM * 4);
+constexpr int PATTERN_STEPS = 32;
+constexpr int8_t REST = -1;
+
+// MIDI 音符号，A 小调 Am - C - F - G
+const int8_t BASS_NOTES[PATTERN_STEPS] = {
+    45, REST, REST, 45, REST, REST, 52, REST,  48, REST, REST, 48, REST, REST, 55, REST,
+    41, REST, REST, 41, REST, REST, 48, REST,  43, REST, REST, 43, REST, REST, 50, REST,
+};
+
+const int8_t LEAD_NOTES[PATTERN_STEPS] = {
+    69, REST, 72, REST, 76, REST, 72, REST,  72, REST, 76, REST, 79, REST, 76, REST,
+    65, REST, 69, REST, 72, REST, 69, REST,  67, REST, 71, REST, 74, REST, 71, REST,
+};
+
+struct Track {
+    const int8_t* notes;
+    Waveform wave;
+    float hold;
+    float release;
+    float gain;
+};
+
+const Track TRACKS[] = {
+    {BASS_NOTES, Waveform::TRIANGLE, 0.20f, 0.10f, 0.45f},
+    {LEAD_NOTES, Waveform::SQUARE, 0.08f, 0.08f, 0.12f},
+};
+
+float midiToFrequency(int note) {
+    return 440.0f * powf(2.0f, (note - 69) / 12.0f);
+}
+
+// 不含 release 的包络电平
+float adsLevel(const SynthPatch& p, float t) {
+    if (t < p.attack) return t / p.attack;
+    t -= p.attack;
+    if (t < p.decay) return 1.0f - (1.0f - p.sustain) * t / p.decay;
+    return p.sustain;
+}
+
+} // namespace
+
+std::atomic<Synth*> Synth::current{nullptr};
+
+Synth::Synth()
+    : stream(),
+      running(false),
+      offline(false),
+      droppedCommands(0),
+      sfxVoices(),
+      musicVoices(),
+      noteSerial(0),
+      sfxGain(1.0f),
+      musicGain(0.5f),
+      musicState(MusicState::STOPPED),
+      sequencerStep(0),
+      samplesUntilStep(0),
+      oscBuffer(),
+      sfxMix(),
+      musicMix() {
+}
+
+Synth::~Synth() {
+    stop();
+}
+
+bool Synth::start() {
+    if (running) return !offline;
+    if (!IsAudioDeviceReady()) return false;
+
+    Synth* expected = nullptr;
+    if (!current.compare_exchange_strong(expected, this)) return false;
+
+    // 单声道 32 位浮点，回调里直接写 float
+    stream = LoadAudioStream(SAMPLE_RATE, 32, 1);
+    if (!IsAudioStreamReady(stream)) {
+        current.store(nullptr);
+        return false;
+    }
+    SetAudioStreamCallback(stream, audioCallback);
+    PlayAudioStream(stream);
+
+    running = true;
+    return true;
+}
+
+bool Synth::startOffline() {
+    if (running) return offline;
+    running = true;
+    offline = true;
+    return true;
+}
+
+void Synth::stop() {
+    if (!running) return;
+    if (offline) {
+        running = false;
+        offline = false;
+        return;
+    }
+
+    // UnloadAudioStream 返回后回调不会再被调用
+    StopAudioStream(stream);
+    UnloadAudioStream(stream);
+    stream = AudioStream{};
+    current.store(nullptr);
+    running = false;
+}
+
+// ============================================================
+// 游戏线程接口
+// ============================================================
+
+bool Synth::send(const SynthCommand& command) {
+    if (!running) return false;
+    if (!commands.push(command)) {
+        droppedCommands++;
+        return false;
+    }
+    return true;
+}
+
+bool Synth::note(const SynthPatch& patch, int tag, int limit, int priority) {
+    SynthCommand command = {};
+    command.type = SynthCommand::Type::NOTE;
+    command.tag = static_cast<int8_t>(tag);
+    command.limit = static_cast<int8_t>(limit);
+    command.priority = static_cast<int8_t>(priority);
+    command.patch = patch;
+    return send(command);
+}
+
+void Synth::setSfxVolume(float volume) {
+    SynthCommand command = {};
+    command.type = SynthCommand::Type::SFX_VOLUME;
+    command.value = volume;
+    send(command);
+}
+
+void Synth::setMusicVolume(float volume) {
+    SynthCommand command = {};
+    command.type = SynthCommand::Type::MUSIC_VOLUME;
+    command.value = volume;
+    send(command);
+}
+
+void Synth::playMusic() {
+    SynthCommand command = {};
+    command.type = SynthCommand::Type::MUSIC_PLAY;
+    send(command);
+}
+
+void Synth::stopMusic() {
+    SynthCommand command = {};
+    command.type = SynthCommand::Type::MUSIC_STOP;
+    send(command);
+}
+
+void Synth::pauseMusic() {
+    SynthCommand command = {};
+    command.type = SynthCommand::Type::MUSIC_PAUSE;
+    send(command);
+}
+
+void Synth::resumeMusic() {
+    SynthCommand command = {};
+    command.type = SynthCommand::Type::MUSIC_RESUME;
+    send(command);
+}
+
+// ============================================================
+// 音频线程
+// ============================================================
+
+void Synth::audioCallback(void* buffer, unsigned int frames) {
+    float* out = static_cast<float*>(buffer);
+    Synth* synth = current.load(std::memory_order_acquire);
+    if (synth == nullptr) {
+        memset(out, 0, frames * sizeof(float));
+        return;
+    }
+    synth->render(out, frames);
+}
+
+void Synth::render(float* out, unsigned int frames) {
+    SynthCommand command;
+    while (commands.pop(command)) {
+        execute(command);
+    }
+
+    unsigned int done = 0;
+    while (done < frames) {
+        if (musicState == MusicState::PLAYING && samplesUntilStep <= 0) {
+            stepSequencer();
+            samplesUntilStep += SAMPLES_PER_STEP;
+        }
+
+        // 一块不跨过音序器的下一步，保证音符准时开始
+        int count = static_cast<int>(std::min<unsigned int>(frames - done, BLOCK_FRAMES));
+        if (musicState == MusicState::PLAYING) {
+            count = std::min(count, samplesUntilStep);
+        }
+
+        std::fill(sfxMix, sfxMix + count, 0.0f);
+        std::fill(musicMix, musicMix + count, 0.0f);
+        for (Voice& voice : sfxVoices) {
+            renderVoice(voice, sfxMix, count);
+        }
+        for (Voice& voice : musicVoices) {
+            renderVoice(voice, musicMix, count);
+        }
+
+        // 多个声音叠加时直接截断，避免溢出
+        float* dst = out + done;
+        for (int i = 0; i < count; i++) {
+            float mix = sfxMix[i] * sfxGain + musicMix[i] * musicGain;
+            dst[i] = fminf(1.0f, fmaxf(-1.0f, mix));
+        }
+
+        done += count;
+        if (musicState == MusicState::PLAYING) {
+            samplesUntilStep -= count;
+        }
+    }
+}
+
+void Synth::execute(const SynthCommand& command) {
+    switch (command.type) {
+        case SynthCommand::Type::NOTE: {
+            int index = allocateSfxVoice(command.tag, command.limit, command.priority);
+            if (index >= 0) {
+                startVoice(sfxVoices[index], command.patch, command.tag, command.priority);
+            }
+            break;
+        }
+        case SynthCommand::Type::SFX_VOLUME:
+            sfxGain = command.value;
+            break;
+        case SynthCommand::Type::MUSIC_VOLUME:
+            musicGain = command.value;
+            break;
+        case SynthCommand::Type::MUSIC_PLAY:
+            musicState = MusicState::PLAYING;
+            sequencerStep = 0;
+            samplesUntilStep = 0;
+            break;
+        case SynthCommand::Type::MUSIC_STOP:
+        case SynthCommand::Type::MUSIC_PAUSE:
+            if (command.type == SynthCommand::Type::MUSIC_STOP) {
+                musicState = MusicState::STOPPED;
+            } else if (musicState == MusicState::PLAYING) {
+                musicState = MusicState::PAUSED;
+            }
+            for (Voice& voice : musicVoices) {
+                releaseVoice(voice);
+            }
+            break;
+        case SynthCommand::Type::MUSIC_RESUME:
+            if (musicState == MusicState::PAUSED) {
+                musicState = MusicState::PLAYING;
+            }
+            break;
+    }
+}
+
+int Synth::allocateSfxVoice(int tag, int limit, int priority) const {
+    int sameTag = 0;
+    int oldestSameTag = -1;
+    int freeVoice = -1;
+    int victim = -1;
+
+    for (int i = 0; i < SFX_VOICES; i++) {
+        const Voice& voice = sfxVoices[i];
+        if (!voice.active) {
+            if (freeVoice < 0) freeVoice = i;
+            continue;
+        }
+
+        if (voice.tag == tag) {
+            sameTag++;
+            if (oldestSameTag < 0 || voice.serial < sfxVoices[oldestSameTag].serial) oldestSameTag = i;
+        }
+
+        if (voice.priority > priority) continue;
+        if (victim < 0 || voice.priority < sfxVoices[victim].priority ||
+            (voice.priority == sfxVoices[victim].priority && voice.serial < sfxVoices[victim].serial)) {
+            victim = i;
+        }
+    }
+
+    // 同类型达到上限：重新开始本类型最早的；否则空闲的；都没有就按优先级抢占
+    if (sameTag >= limit && oldestSameTag >= 0) return oldestSameTag;
+    if (freeVoice >= 0) return freeVoice;
+    return victim;
+}
+
+void Synth::startVoice(Voice& voice, const SynthPatch& patch, int tag, int priority) {
+    voice.patch = patch;
+    voice.active = true;
+    voice.phase = 0.0f;
+    voice.frequency = patch.frequency;
+    voice.slideStep = patch.slide > 0.0f ? powf(patch.slide, INV_SAMPLE_RATE) : 1.0f;
+    voice.releaseLevel = adsLevel(patch, patch.hold);
+    voice.age = 0;
+    voice.attackEnd = static_cast<uint32_t>(patch.attack * SAMPLE_RATE);
+    voice.decayEnd = voice.attackEnd + static_cast<uint32_t>(patch.decay * SAMPLE_RATE);
+    voice.holdEnd = static_cast<uint32_t>(patch.hold * SAMPLE_RATE);
+    voice.releaseEnd = voice.holdEnd + static_cast<uint32_t>(fmaxf(1.0f, patch.release * SAMPLE_RATE));
+    voice.tag = static_cast<int8_t>(tag);
+    voice.priority = static_cast<int8_t>(priority);
+    voice.serial = ++noteSerial;
+    voice.noise = 0x9E3779B9u ^ voice.serial;
+}
+
+void Synth::releaseVoice(Voice& voice) {
+    if (!voice.active || voice.age >= voice.holdEnd) return;
+
+    voice.releaseLevel = adsLevel(voice.patch, voice.age * INV_SAMPLE_RATE);
+    voice.releaseEnd = voice.age + (voice.releaseEnd - voice.holdEnd);
+    voice.holdEnd = voice.age;
+}
+
+void Synth::stepSequencer() {
+    for (const Track& track : TRACKS) {
+        int note = track.notes[sequencerStep];
+        if (note == REST) continue;
+
+        // 空闲的通道优先，否则顶掉最早的
+        Voice* target = &musicVoices[0];
+        for (Voice& voice : musicVoices) {
+            if (!voice.active) {
+                target = &voice;
+                break;
+            }
+            if (voice.serial < target->serial) target = &voice;
+        }
+
+        SynthPatch patch = {track.wave, midiToFrequency(note), 1.0f,
+                            0.005f, 0.05f, 0.7f, track.hold, track.release, track.gain};
+        startVoice(*target, patch, -1, 0);
+    }
+
+    sequencerStep = (sequencerStep + 1) % PATTERN_STEPS;
+}
+
+void Synth::renderVoice(Voice& voice, float* mix, int frames) {
+    if (!voice.active) return;
+
+    const int count = static_cast<int>(std::min<uint32_t>(frames, voice.releaseEnd - voice.age));
+    renderOscillator(voice, count);
+
+    // 包络按段处理：每段内是直线，块内电平可以直接插值
+    const float gain = voice.patch.gain;
+    int i = 0;
+    while (i < count) {
+        const int span = static_cast<int>(std::min<uint32_t>(count - i, segmentEnd(voice) - voice.age));
+        const float start = envelopeAt(voice, voice.age);
+        const float step = (envelopeAt(voice, voice.age + span) - start) / span;
+
+        const float* osc = oscBuffer + i;
+        float* dst = mix + i;
+        for (int j = 0; j < span; j++) {
+            dst[j] += osc[j] * (start + step * j) * gain;
+        }
+
+        i += span;
+        voice.age += span;
+    }
+
+    if (voice.age >= voice.releaseEnd) {
+        voice.active = false;
+    }
+}
+
+void Synth::renderOscillator(Voice& voice, int frames) {
+    float* osc = oscBuffer;
+
+    if (voice.patch.wave == Waveform::NOISE) {
+        // xorshift32，每个采样依赖上一个，只能逐个算
+        uint32_t state = voice.noise;
+        for (int i = 0; i < frames; i++) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            osc[i] = static_cast<int32_t>(state) * (1.0f / 2147483648.0f);
+        }
+        voice.noise = state;
+        return;
+    }
+
+    // 频率滑动是指数曲线，块内按直线近似：相位增量从 inc0 线性变到 inc1，
+    // 第 i 个采样的相位 = phase + inc0 * i + delta * i * (i - 1) / 2
+    const float endFrequency = fminf(voice.frequency * powf(voice.slideStep, static_cast<float>(frames)),
+                                     SAMPLE_RATE * 0.5f);
+    const float inc0 = voice.frequency * INV_SAMPLE_RATE;
+    const float delta = (endFrequency - voice.frequency) * INV_SAMPLE_RATE / frames;
+    const float phase = voice.phase;
+
+    for (int i = 0; i < frames; i++) {
+        const float fi = static_cast<float>(i);
+        const float p = phase + inc0 * fi + 0.5f * delta * fi * (fi - 1.0f);
+        osc[i] = p - static_cast<float>(static_cast<int>(p));
+    }
+
+    switch (voice.patch.wave) {
+        case Waveform::SINE:
+            for (int i = 0; i < frames; i++) {
+                const float pos = osc[i] * SINE_TABLE_SIZE;
+                const int index = static_cast<int>(pos);
+                const float frac = pos - index;
+                osc[i] = SINE_TABLE.values[index] + (SINE_TABLE.values[index + 1] - SINE_TABLE.values[index]) * frac;
+            }
+            break;
+        case Waveform::SQUARE:
+            for (int i = 0; i < frames; i++) {
+                osc[i] = osc[i] < 0.5f ? 1.0f : -1.0f;
+            }
+            break;
+        case Waveform::TRIANGLE:
+            for (int i = 0; i < frames; i++) {
+                osc[i] = 4.0f * fabsf(osc[i] - 0.5f) - 1.0f;
+            }
+            break;
+        case Waveform::SAW:
+            for (int i = 0; i < frames; i++) {
+                osc[i] = 2.0f * osc[i] - 1.0f;
+            }
+            break;
+        case Waveform::NOISE:
+            break;
+    }
+
+    const float fn = static_cast<float>(frames);
+    const float next = phase + inc0 * fn + 0.5f * delta * fn * (fn - 1.0f);
+    voice.phase = next - static_cast<float>(static_cast<int>(next));
+    voice.frequency = endFrequency;
+}
+
+float Synth::envelopeAt(const Voice& voice, uint32_t age) const {
+    if (age < voice.holdEnd) return adsLevel(voice.patch, age * INV_SAMPLE_RATE);
+    if (age >= voice.releaseEnd) return 0.0f;
+    float t = static_cast<float>(age - voice.holdEnd) / (voice.releaseEnd - voice.holdEnd);
+    return voice.releaseLevel * (1.0f - t);
+}
+
+uint32_t Synth::segmentEnd(const Voice& voice) const {
+    if (voice.age >= voice.holdEnd) return voice.releaseEnd;
+    if (voice.age < voice.attackEnd) return std::min(voice.attackEnd, voice.holdEnd);
+    if (voice.age < voice.decayEnd) return std::min(voice.decayEnd, voice.holdEnd);
+    return voice.holdEnd;
+}
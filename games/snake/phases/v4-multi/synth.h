@@ -0,0 +1,161 @@
+#pragma once
+#include "raylib.h"
+#include "spsc_queue.h"
+#include <atomic>
+#include <cstdint>
+
+// ============================================================
+// 合成器参数
+// ============================================================
+enum class Waveform : uint8_t {
+    SINE,
+    SQUARE,
+    TRIANGLE,
+    SAW,
+    NOISE,
+};
+
+// 一个音符的全部参数（时间单位：秒）
+struct SynthPatch {
+    Waveform wave;
+    float frequency;    // 起始频率 (Hz)，噪音忽略
+    float slide;        // 每秒的频率倍率：2 = 每秒升一个八度，1 = 不变
+    float attack;
+    float decay;
+    float sustain;      // 持续电平 (0-1)
+    float hold;         // 从开始到松开的时间，之后进入 release
+    float release;
+    float gain;
+};
+
+// 游戏线程发给音频线程的命令
+struct SynthCommand {
+    enum class Type : uint8_t {
+        NOTE,
+        SFX_VOLUME,
+        MUSIC_VOLUME,
+        MUSIC_PLAY,
+        MUSIC_STOP,
+        MUSIC_PAUSE,
+        MUSIC_RESUME,
+    };
+
+    Type type;
+    int8_t tag;         // NOTE：音效类型，同类型共享并发上限
+    int8_t limit;       // NOTE：同类型最多同时发声数
+    int8_t priority;    // NOTE：抢占优先级，越大越重要
+    float value;        // 音量类命令
+    SynthPatch patch;   // NOTE
+};
+
+// ============================================================
+// Synth - 在音频线程里实时生成音效和背景音乐
+// ============================================================
+// 用 raylib 的 AudioStream 回调直接往设备缓冲区写采样，不预先生成任何波形：
+//   - 振荡器（正弦查表/方波/三角波/锯齿波/噪音）+ ADSR 包络 + 频率滑动
+//   - 一个简单的步进音序器循环播放背景音乐
+//   - 游戏线程只通过 SpscQueue 发命令，音频线程在每次回调开头取完
+//   - 按块渲染：相位、包络都按块内线性公式算出，内层循环没有分支和
+//     跨采样依赖，编译器可以自动向量化（噪音的 xorshift 除外）
+// 音频线程里不加锁、不分配内存；音效的发声通道分配规则与 AudioSystem 的
+// 音频文件通道相同（同类型上限、按优先级抢占）。
+class Synth {
+public:
+    static constexpr int SAMPLE_RATE = 44100;
+    static constexpr int SFX_VOICES = 8;
+    static constexpr int MUSIC_VOICES = 4;
+    static constexpr int COMMAND_CAPACITY = 64;
+    static constexpr int BLOCK_FRAMES = 256;
+
+    Synth();
+    ~Synth();
+
+    Synth(const Synth&) = delete;
+    Synth& operator=(const Synth&) = delete;
+
+    // 需要在 InitAudioDevice 之后调用；同一时间只能有一个合成器在运行
+    bool start();
+    // 需要在 CloseAudioDevice 之前调用
+    void stop();
+    bool isRunning() const { return running; }
+
+    // 不打开音频设备，由调用者在自己的线程里取采样（基准测试用）。
+    // 与 start() 二选一；命令在下一次 renderOffline 开头执行
+    bool startOffline();
+    void renderOffline(float* out, unsigned int frames) { render(out, frames); }
+
+    // 以下只在游戏线程调用。队列满时命令被丢弃，返回 false
+    bool note(const SynthPatch& patch, int tag, int limit, int priority);
+    void setSfxVolume(float volume);
+    void setMusicVolume(float volume);
+    void playMusic();
+    void stopMusic();
+    void pauseMusic();
+    void resumeMusic();
+
+    size_t getDroppedCommands() const { return droppedCommands; }
+
+private:
+    struct Voice {
+        SynthPatch patch;
+        bool active;
+        float phase;            // 0-1
+        float frequency;
+        float slideStep;        // 每个采样的频率倍率
+        float releaseLevel;     // 松开时的包络电平
+        uint32_t age;           // 已播放的采样数
+        uint32_t attackEnd;     // 包络各段的结束位置（采样数）
+        uint32_t decayEnd;
+        uint32_t holdEnd;
+        uint32_t releaseEnd;
+        uint32_t noise;         // 噪音发生器状态
+        int8_t tag;
+        int8_t priority;
+        uint32_t serial;        // 开始顺序，越小越早
+    };
+
+    enum class MusicState : uint8_t {
+        STOPPED,
+        PLAYING,
+        PAUSED,
+    };
+
+    // ---------- 游戏线程 ----------
+    SpscQueue<SynthCommand, COMMAND_CAPACITY> commands;
+    AudioStream stream;
+    bool running;
+    bool offline;               // startOffline 启动，没有 AudioStream
+    size_t droppedCommands;
+
+    // ---------- 音频线程 ----------
+    Voice sfxVoices[SFX_VOICES];
+    Voice musicVoices[MUSIC_VOICES];
+    uint32_t noteSerial;
+    float sfxGain;
+    float musicGain;
+    MusicState musicState;
+    int sequencerStep;
+    int samplesUntilStep;
+
+    // 块渲染用的临时缓冲区
+    float oscBuffer[BLOCK_FRAMES];
+    float sfxMix[BLOCK_FRAMES];
+    float musicMix[BLOCK_FRAMES];
+
+    static std::atomic<Synth*> current;     // AudioCallback 没有用户参数
+    static void audioCallback(void* buffer, unsigned int frames);
+
+    bool send(const SynthCommand& command);
+    void render(float* out, unsigned int frames);
+    void execute(const SynthCommand& command);
+    int allocateSfxVoice(int tag, int limit, int priority) const;
+    void startVoice(Voice& voice, const SynthPatch& patch, int tag, int priority);
+    // 提前进入 release（停止/暂停音乐时淡出，避免爆音）
+    void releaseVoice(Voice& voice);
+    void stepSequencer();
+    // 把一个通道的 frames 个采样累加到 mix
+    void renderVoice(Voice& voice, float* mix, int frames);
+    void renderOscillator(Voice& voice, int frames);
+    float envelopeAt(const Voice& voice, uint32_t age) const;
+    uint32_t segmentEnd(const Voice& voice) const;
+};
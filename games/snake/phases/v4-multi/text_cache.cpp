@@ -0,0 +1,161 @@
+#include "text_cache.h"
+#include "byte_stream.h"
+#include "rlgl.h"
+#include <cstring>
+
+TextCache::TextCache() : frame(0), hits(0), misses(0) {
+}
+
+Vector2 TextCache::measure(const Font& font, const char* text, float fontSize, float spacing) {
+    if (font.texture.id == 0 || text == nullptr) {
+        return {0.0f, 0.0f};
+    }
+    return getRun(font, text, fontSize, spacing).extent;
+}
+
+void TextCache::draw(const Font& font, const char* text, Vector2 position, float fontSize, float spacing, Color tint) {
+    if (font.texture.id == 0 || text == nullptr) {
+        return;
+    }
+
+    const TextRun& run = getRun(font, text, fontSize, spacing);
+    if (run.quads.empty()) return;
+
+    // 整段文字一次提交；同一字体的多段文字在 rlgl 里会合并成同一批次
+    rlCheckRenderBatchLimit(static_cast<int>(run.quads.size() * 4));
+    rlSetTexture(font.texture.id);
+    rlBegin(RL_QUADS);
+    rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+
+    const float ox = position.x;
+    const float oy = position.y;
+    for (const GlyphQuad& q : run.quads) {
+        // 与 DrawTexturePro 相同的顶点顺序：左上、左下、右下、右上
+        rlTexCoord2f(q.u0, q.v0);
+        rlVertex2f(ox + q.x0, oy + q.y0);
+        rlTexCoord2f(q.u0, q.v1);
+        rlVertex2f(ox + q.x0, oy + q.y1);
+        rlTexCoord2f(q.u1, q.v1);
+        rlVertex2f(ox + q.x1, oy + q.y1);
+        rlTexCoord2f(q.u1, q.v0);
+        rlVertex2f(ox + q.x1, oy + q.y0);
+    }
+
+    rlEnd();
+    rlSetTexture(0);
+}
+
+void TextCache::endFrame() {
+    frame++;
+    for (auto it = runs.begin(); it != runs.end();) {
+        if (frame - it->second.lastUsedFrame > EVICT_AFTER_FRAMES) {
+            it = runs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    hits = 0;
+    misses = 0;
+}
+
+void TextCache::clear() {
+    runs.clear();
+}
+
+const TextCache::TextRun& TextCache::getRun(const Font& font, const char* text, float fontSize, float spacing) {
+    const size_t length = strlen(text);
+
+    uint32_t sizeBits, spacingBits;
+    memcpy(&sizeBits, &fontSize, sizeof(sizeBits));
+    memcpy(&spacingBits, &spacing, sizeof(spacingBits));
+    uint32_t params[3] = {font.texture.id, sizeBits, spacingBits};
+
+    uint64_t key = hashBytes(reinterpret_cast<const uint8_t*>(params), sizeof(params));
+    key = hashBytes(reinterpret_cast<const uint8_t*>(text), length, key);
+
+    TextRun& run = runs[key];
+    run.lastUsedFrame = frame;
+
+    // 新建的条目 textureId 为 0，不会与有效字体匹配
+    if (run.textureId == font.texture.id && run.fontSize == fontSize && run.spacing == spacing &&
+        run.text.size() == length && memcmp(run.text.data(), text, length) == 0) {
+        hits++;
+        return run;
+    }
+
+    // 新条目，或者哈希碰撞：重新排版覆盖
+    misses++;
+    run.text.assign(text, length);
+    run.textureId = font.texture.id;
+    run.fontSize = fontSize;
+    run.spacing = spacing;
+    layout(run, font);
+    return run;
+}
+
+void TextCache::layout(TextRun& run, const Font& font) const {
+    // 排版规则照抄 raylib 的 DrawTextEx / DrawTextCodepoint / MeasureTextEx，结果逐像素一致
+    run.quads.clear();
+
+    const float scale = run.fontSize / font.baseSize;
+    const float padding = static_cast<float>(font.glyphPadding);
+    const float texWidth = static_cast<float>(font.texture.width);
+    const float texHeight = static_cast<float>(font.texture.height);
+
+    float penX = 0.0f, penY = 0.0f;
+
+    // MeasureTextEx 的宽度按未缩放的前进量累加，字距按最长一行的字符数计算
+    float lineWidth = 0.0f, maxLineWidth = 0.0f;
+    int lineChars = 0, maxLineChars = 0;
+    float height = run.fontSize;
+
+    const char* text = run.text.c_str();
+    const int length = static_cast<int>(run.text.size());
+    for (int i = 0; i < length;) {
+        int byteCount = 0;
+        int codepoint = GetCodepointNext(&text[i], &byteCount);
+        int index = GetGlyphIndex(font, codepoint);
+        i += byteCount;
+        lineChars++;
+
+        const GlyphInfo& glyph = font.glyphs[index];
+        const Rectangle& rec = font.recs[index];
+
+        if (codepoint == '\n') {
+            penY += run.fontSize + LINE_SPACING;
+            penX = 0.0f;
+
+            if (maxLineWidth < lineWidth) maxLineWidth = lineWidth;
+            lineWidth = 0.0f;
+            lineChars = 0;
+            height += run.fontSize + LINE_SPACING;
+        } else {
+            if (codepoint != ' ' && codepoint != '\t') {
+                GlyphQuad q;
+                q.x0 = penX + glyph.offsetX * scale - padding * scale;
+                q.y0 = penY + glyph.offsetY * scale - padding * scale;
+                q.x1 = q.x0 + (rec.width + 2.0f * padding) * scale;
+                q.y1 = q.y0 + (rec.height + 2.0f * padding) * scale;
+                q.u0 = (rec.x - padding) / texWidth;
+                q.v0 = (rec.y - padding) / texHeight;
+                q.u1 = (rec.x + rec.width + padding) / texWidth;
+                q.v1 = (rec.y + rec.height + padding) / texHeight;
+                run.quads.push_back(q);
+            }
+
+            if (glyph.advanceX == 0) {
+                penX += rec.width * scale + run.spacing;
+                lineWidth += rec.width + glyph.offsetX;
+            } else {
+                penX += glyph.advanceX * scale + run.spacing;
+                lineWidth += glyph.advanceX;
+            }
+        }
+
+        if (maxLineChars < lineChars) maxLineChars = lineChars;
+    }
+
+    if (maxLineWidth < lineWidth) maxLineWidth = lineWidth;
+    run.extent = {maxLineWidth * scale + (maxLineChars - 1) * run.spacing, height};
+}
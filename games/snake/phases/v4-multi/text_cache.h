@@ -0,0 +1,64 @@
+#pragma once
+#include "raylib.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================
+// TextCache - 界面文字排版缓存
+// ============================================================
+// MeasureTextEx/DrawTextEx 每次都要解码 UTF-8，并在字体里逐个查找字形
+// （GetGlyphIndex 是线性查找，中文字体有几千个字形）。
+// 这里按 (字体, 字符串哈希, 字号, 字距) 缓存排好的字形四边形和尺寸：
+//   - 文字不变时每帧只剩一次哈希和查表，四边形直接提交给 rlgl
+//   - 文字变化（例如分数更新）自然得到新的键；旧条目一段时间没用到就淘汰
+class TextCache {
+private:
+    // 一个字形：相对文字左上角的目标矩形和归一化纹理坐标
+    struct GlyphQuad {
+        float x0, y0, x1, y1;
+        float u0, v0, u1, v1;
+    };
+
+    struct TextRun {
+        std::string text;               // 原文，用于排除哈希碰撞
+        unsigned int textureId;
+        float fontSize;
+        float spacing;
+        std::vector<GlyphQuad> quads;
+        Vector2 extent;                 // 与 MeasureTextEx 结果一致
+        uint64_t lastUsedFrame;
+
+        TextRun() : textureId(0), fontSize(0), spacing(0), extent{0, 0}, lastUsedFrame(0) {}
+    };
+
+    static constexpr uint64_t EVICT_AFTER_FRAMES = 120;    // 约 2 秒没用到就淘汰
+    static constexpr int LINE_SPACING = 2;                  // 与 raylib 默认行距一致
+
+    std::unordered_map<uint64_t, TextRun> runs;
+    uint64_t frame;
+    size_t hits;                        // 本帧命中次数
+    size_t misses;                      // 本帧重新排版次数
+
+public:
+    TextCache();
+
+    // 与 MeasureTextEx 相同
+    Vector2 measure(const Font& font, const char* text, float fontSize, float spacing);
+    // 与 DrawTextEx 相同
+    void draw(const Font& font, const char* text, Vector2 position, float fontSize, float spacing, Color tint);
+
+    // 每帧结束时调用：淘汰长期未用的条目并重置统计
+    void endFrame();
+    // 字体更换后必须清空
+    void clear();
+
+    size_t getRunCount() const { return runs.size(); }
+    size_t getHits() const { return hits; }
+    size_t getMisses() const { return misses; }
+
+private:
+    const TextRun& getRun(const Font& font, const char* text, float fontSize, float spacing);
+    void layout(TextRun& run, const Font& font) const;
+};
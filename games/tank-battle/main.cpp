@@ -1,4 +1,6 @@
 #include "raylib.h"
+#include "font_cache.h"
+#include "font_text.h"
 #include <vector>
 
 const int screenWidth = 800;
@@ -35,13 +37,8 @@ int main() {
     bool ownsUIFont = false;
     {
         const char* fontPath = "/System/Library/Fonts/Supplemental/Arial Unicode.ttf";
-        const char* allText =
-            "0123456789 坦克大战 按 ENTER 开始 WASD: 移动 | 空格: 射击 分数: 生命: 游戏结束 按 ENTER 返回 胜利！";
-
-        int cpCount = 0;
-        int* cps = LoadCodepoints(allText, &cpCount);
-        Font f = LoadFontEx(fontPath, 64, cps, cpCount);
-        UnloadCodepoints(cps);
+        // FONT_TEXT 由构建时从源码字符串中提取（font_text.h），光栅化结果缓存在 data/font_cache/
+        Font f = LoadFontCached(fontPath, 64, FONT_TEXT);
 
         if (f.texture.id != 0) {
             uiFont = f;
@@ -1,4 +1,6 @@
 #include "raylib.h"
+#include "font_cache.h"
+#include "font_text.h"
 #include <vector>
 
 const int gridWidth = 10;
@@ -117,14 +119,8 @@ int main() {
     bool ownsUIFont = false;
     {
         const char* fontPath = "/System/Library/Fonts/Supplemental/Arial Unicode.ttf";
-        // Only load glyphs we actually render (plus ASCII in the strings below).
-        const char* allText =
-            "0123456789 俄罗斯方块 TETRIS 按 ENTER 开始 左右: 移动 上: 旋转 下: 加速 游戏结束 分数: 0 按 ENTER 返回";
-
-        int cpCount = 0;
-        int* cps = LoadCodepoints(allText, &cpCount);
-        Font f = LoadFontEx(fontPath, 32, cps, cpCount);
-        UnloadCodepoints(cps);
+        // FONT_TEXT 由构建时从源码字符串中提取（font_text.h），光栅化结果缓存在 data/font_cache/
+        Font f = LoadFontCached(fontPath, 32, FONT_TEXT);
 
         if (f.texture.id != 0) {
             uiFont = f;
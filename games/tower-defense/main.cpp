@@ -1,4 +1,6 @@
 #include "raylib.h"
+#include "font_cache.h"
+#include "font_text.h"
 #include <vector>
 #include <cmath>
 
@@ -45,13 +47,8 @@ int main() {
     bool ownsUIFont = false;
     {
         const char* fontPath = "/System/Library/Fonts/Supplemental/Arial Unicode.ttf";
-        const char* allText =
-            "0123456789 塔防游戏 按 ENTER 开始 鼠标左键: 放置塔 (100金币) 金币: 生命: 波次: 0/10 分数: 下一波即将到来... 游戏结束 波次: 0 | 分数: 0 按 ENTER 返回 胜利！ 最终分数:";
-
-        int cpCount = 0;
-        int* cps = LoadCodepoints(allText, &cpCount);
-        Font f = LoadFontEx(fontPath, 64, cps, cpCount);
-        UnloadCodepoints(cps);
+        // FONT_TEXT 由构建时从源码字符串中提取（font_text.h），光栅化结果缓存在 data/font_cache/
+        Font f = LoadFontCached(fontPath, 64, FONT_TEXT);
 
         if (f.texture.id != 0) {
             uiFont = f;